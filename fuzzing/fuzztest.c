@@ -5,6 +5,10 @@
 
 #include "get_tx_sign.h"
 
+#ifdef FUZZ_LATENCY
+#include "latency.h"
+#endif
+
 ux_state_t G_ux;
 uint8_t G_io_apdu_buffer[IO_APDU_BUFFER_SIZE];
 
@@ -14,6 +18,9 @@ unsigned int app_stack_canary = APP_STACK_CANARY_MAGIC;
 #endif
 
 void handleSignTransactionNoThrow(uint8_t p1, uint8_t p2, uint8_t *wireBuffer, size_t wireSize, bool isNewCall) {
+#ifdef FUZZ_LATENCY
+    latencyApduBegin();
+#endif
     BEGIN_TRY {
         TRY {
             handleSignTransaction(p1, p2, wireBuffer, wireSize, isNewCall);
@@ -23,6 +30,9 @@ void handleSignTransactionNoThrow(uint8_t p1, uint8_t p2, uint8_t *wireBuffer, s
         FINALLY {
         }
     } END_TRY;
+#ifdef FUZZ_LATENCY
+    latencyApduEnd();
+#endif
 }
 
 int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size) {
@@ -52,5 +62,9 @@ int LLVMFuzzerTestOneInput(const uint8_t *Data, size_t Size) {
     uint8_t lc = input[3];
     handleSignTransactionNoThrow(p1, p2, &input[4], lc, is_first);
   }
+
+#ifdef FUZZ_LATENCY
+  latencyInputEnd(Data, Size);
+#endif
   return 0;
 }
\ No newline at end of file
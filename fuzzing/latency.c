@@ -0,0 +1,181 @@
+/**
+ * Implements the worst case latency measurement of the fuzzer inputs.
+ *
+ * The hot helpers count work units by FUZZ_WORK: one unit for each division step,
+ * each byte read and each copy of the transaction stream, and each byte hashed.
+ * The units don't depend on the sanitizers, or the machine load, so the measurement
+ * is reproducible; the thread CPU time is measured along for the reference.
+ * An input with an APDU over the budget is saved to the slow inputs corpus.
+ *
+ * The work level of the slowest APDU is fed to libFuzzer as an extra coverage
+ * feature, so the inputs reaching a new level are kept and mutated further.
+ *
+ * Environment:
+ *   FUZZ_WORK_BUDGET    work units allowed to a single APDU (default 200000)
+ *   FUZZ_TIME_BUDGET_US CPU time allowed to a single APDU in microseconds (default off)
+ *   FUZZ_SLOW_DIR       directory of the slow inputs corpus (default "slow")
+ */
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+
+#include "latency.h"
+
+// LATENCY_LEVELS defines the number of work levels; four per power of two.
+#define LATENCY_LEVELS 128
+
+// latency_state_t declares the state of the latency measurement.
+typedef struct {
+    // the configuration, loaded on the first use
+    int isConfigured;
+    uint64_t workBudget;
+    uint64_t timeBudgetNs;
+    const char *slowDir;
+
+    // the current APDU
+    uint64_t work;
+    uint64_t startNs;
+
+    // the slowest APDU of the current input
+    uint64_t inputMaxWork;
+    uint64_t inputMaxNs;
+
+    // the slowest APDU seen by the whole run
+    uint64_t maxWork;
+    uint64_t maxNs;
+    uint64_t slowInputs;
+} latency_state_t;
+
+static latency_state_t latency;
+
+#if defined(__linux__)
+// workLevels is the libFuzzer extra coverage of the reached work levels
+__attribute__((section("__libfuzzer_extra_counters"))) static uint8_t workLevels[LATENCY_LEVELS];
+#endif
+
+// latencyConfigure implements loading the configuration from the environment.
+static void latencyConfigure() {
+    const char *value;
+
+    latency.workBudget = LATENCY_DEFAULT_WORK_BUDGET;
+    latency.timeBudgetNs = 0;
+    latency.slowDir = LATENCY_DEFAULT_SLOW_DIR;
+
+    if ((value = getenv("FUZZ_WORK_BUDGET")) != NULL) {
+        latency.workBudget = strtoull(value, NULL, 10);
+    }
+    if ((value = getenv("FUZZ_TIME_BUDGET_US")) != NULL) {
+        latency.timeBudgetNs = strtoull(value, NULL, 10) * 1000u;
+    }
+    if ((value = getenv("FUZZ_SLOW_DIR")) != NULL) {
+        latency.slowDir = value;
+    }
+
+    if (mkdir(latency.slowDir, 0755) != 0 && errno != EEXIST) {
+        perror(latency.slowDir);
+    }
+
+    printf("[latency] work budget %llu, time budget %llu us, slow inputs to %s\n",
+           (unsigned long long) latency.workBudget, (unsigned long long) (latency.timeBudgetNs / 1000u),
+           latency.slowDir);
+    latency.isConfigured = 1;
+}
+
+// latencyNowNs implements reading the CPU time of the thread.
+static uint64_t latencyNowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+// latencyLevel implements the work level; four levels per power of two.
+static uint32_t latencyLevel(uint64_t work) {
+    if (work < 4) {
+        return (uint32_t) work;
+    }
+
+    uint32_t bits = 63 - (uint32_t) __builtin_clzll(work);
+    uint32_t level = 4 * bits + (uint32_t) ((work >> (bits - 2)) & 3);
+    return (level < LATENCY_LEVELS) ? level : LATENCY_LEVELS - 1;
+}
+
+// fuzzWork implements counting the work units of the hot helpers.
+void fuzzWork(uint32_t units) {
+    latency.work += units;
+}
+
+// latencyApduBegin implements the start of the APDU measurement.
+void latencyApduBegin() {
+    if (!latency.isConfigured) {
+        latencyConfigure();
+    }
+    latency.work = 0;
+    latency.startNs = latencyNowNs();
+}
+
+// latencyApduEnd implements the end of the APDU measurement.
+void latencyApduEnd() {
+    uint64_t ns = latencyNowNs() - latency.startNs;
+
+    if (latency.work > latency.inputMaxWork) {
+        latency.inputMaxWork = latency.work;
+    }
+    if (ns > latency.inputMaxNs) {
+        latency.inputMaxNs = ns;
+    }
+}
+
+// latencySave implements saving the input to the slow inputs corpus.
+// The name carries the work units so the listing sorts the worst ones together.
+static void latencySave(const uint8_t *data, size_t size) {
+    char path[512];
+
+    // FNV-1a of the content keeps the names of different inputs apart
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash = (hash ^ data[i]) * 16777619u;
+    }
+    snprintf(path, sizeof(path), "%s/slow-%010llu-%08x", latency.slowDir,
+             (unsigned long long) latency.inputMaxWork, hash);
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        perror(path);
+        return;
+    }
+    fwrite(data, 1, size, file);
+    fclose(file);
+
+    latency.slowInputs++;
+    printf("[latency] slow input: work %llu, cpu %llu us, saved to %s\n",
+           (unsigned long long) latency.inputMaxWork, (unsigned long long) (latency.inputMaxNs / 1000u), path);
+}
+
+// latencyInputEnd implements the evaluation of the whole fuzzer input.
+void latencyInputEnd(const uint8_t *data, size_t size) {
+#if defined(__linux__)
+    workLevels[latencyLevel(latency.inputMaxWork)] = 1;
+#endif
+
+    // the measured upper bound of the APDU latency so far
+    if (latency.inputMaxWork > latency.maxWork) {
+        latency.maxWork = latency.inputMaxWork;
+        printf("[latency] new max work %llu per APDU\n", (unsigned long long) latency.maxWork);
+    }
+    if (latency.inputMaxNs > latency.maxNs) {
+        latency.maxNs = latency.inputMaxNs;
+    }
+
+    bool isSlow = latency.inputMaxWork > latency.workBudget ||
+                  (latency.timeBudgetNs != 0 && latency.inputMaxNs > latency.timeBudgetNs);
+    if (isSlow) {
+        latencySave(data, size);
+    }
+
+    latency.inputMaxWork = 0;
+    latency.inputMaxNs = 0;
+}
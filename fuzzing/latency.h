@@ -0,0 +1,26 @@
+#ifndef FANTOM_FUZZING_LATENCY_H
+#define FANTOM_FUZZING_LATENCY_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// LATENCY_DEFAULT_WORK_BUDGET defines the default work units budget of a single APDU.
+#define LATENCY_DEFAULT_WORK_BUDGET 200000
+
+// LATENCY_DEFAULT_SLOW_DIR defines the default directory the slow inputs are saved to.
+#define LATENCY_DEFAULT_SLOW_DIR "slow"
+
+// fuzzWork implements counting the work units of the hot helpers; see FUZZ_WORK in utils.h.
+void fuzzWork(uint32_t units);
+
+// latencyApduBegin implements the start of the APDU measurement.
+void latencyApduBegin();
+
+// latencyApduEnd implements the end of the APDU measurement.
+void latencyApduEnd();
+
+// latencyInputEnd implements the evaluation of the whole fuzzer input.
+// The input is saved to the slow inputs corpus if any of its APDU exceeded the budget.
+void latencyInputEnd(const uint8_t *data, size_t size);
+
+#endif //FANTOM_FUZZING_LATENCY_H
@@ -5,6 +5,7 @@
 #include "os_io_seproxyhal.h"
 #include "state.h"
 #include "ux.h"
+#include "utils.h"
 
 io_seph_app_t G_io_app;
 void explicit_bzero(void *b, size_t len) {
@@ -36,6 +37,8 @@ unsigned short io_seph_recv ( unsigned char * buffer, unsigned short maxlength,
 void halt() { for(;;); };
 bolos_bool_t os_global_pin_is_validated(void) {return (bolos_bool_t)BOLOS_UX_OK;};
 cx_err_t cx_hash_no_throw(cx_hash_t *hash, uint32_t mode, const uint8_t *in, size_t len, uint8_t *out, size_t out_len) { 
+    // hashing is the major cost of the device; count it per byte
+    FUZZ_WORK(len);
     return 0;
 }
 size_t cx_hash_get_size(const cx_hash_t *ctx) { return 32;};
@@ -118,6 +121,15 @@ cx_err_t cx_ecdsa_sign_no_throw(const cx_ecfp_private_key_t *pvkey,
 
 void os_perso_derive_node_bip32 ( cx_curve_t curve, const unsigned int * path, unsigned int pathLength, unsigned char * privateKey, unsigned char * chain ) {}
 
+unsigned int os_perso_seed_cookie(unsigned char * seed_cookie, unsigned int seed_cookie_length) {
+    memset(seed_cookie, 0, seed_cookie_length);
+    return seed_cookie_length;
+}
+
+void nvm_write(void * dst_adr, void * src_adr, unsigned int src_len) {
+    memcpy(dst_adr, src_adr, src_len);
+}
+
 void io_seproxyhal_se_reset() {
     THROW(0x99);
 }
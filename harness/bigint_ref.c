@@ -0,0 +1,202 @@
+/**
+ * Implements the reference unsigned big numbers of the uint256 harness.
+ */
+#include <string.h>
+
+#include "bigint_ref.h"
+
+// refZero implements setting the number to zero.
+void refZero(ref_t *number) {
+    memset(number, 0, sizeof(*number));
+}
+
+// refFromU64 implements setting the number from a 64 bit value.
+void refFromU64(ref_t *number, uint64_t value) {
+    refZero(number);
+    number->limbs[0] = (uint32_t) value;
+    number->limbs[1] = (uint32_t) (value >> 32);
+}
+
+// refFromBE implements reading the number from big endian bytes.
+void refFromBE(ref_t *number, const uint8_t *data, size_t length) {
+    refZero(number);
+    for (size_t i = 0; i < length && i < 4 * REF_LIMBS; i++) {
+        uint8_t byte = data[length - 1 - i];
+        number->limbs[i / 4] |= (uint32_t) byte << (8 * (i % 4));
+    }
+}
+
+// refToBE implements writing the low bytes of the number as big endian bytes.
+void refToBE(const ref_t *number, uint8_t *out, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        out[length - 1 - i] = (i < 4 * REF_LIMBS) ? (uint8_t) (number->limbs[i / 4] >> (8 * (i % 4))) : 0;
+    }
+}
+
+// refTruncate implements keeping the low bits of the number only.
+void refTruncate(ref_t *number, uint32_t bits) {
+    for (uint32_t i = 0; i < REF_LIMBS; i++) {
+        if (bits <= 32 * i) {
+            number->limbs[i] = 0;
+        } else if (bits < 32 * (i + 1)) {
+            number->limbs[i] &= (1u << (bits - 32 * i)) - 1;
+        }
+    }
+}
+
+// refCompare implements comparison of two numbers.
+int refCompare(const ref_t *a, const ref_t *b) {
+    for (int i = REF_LIMBS - 1; i >= 0; i--) {
+        if (a->limbs[i] != b->limbs[i]) {
+            return (a->limbs[i] > b->limbs[i]) ? 1 : -1;
+        }
+    }
+    return 0;
+}
+
+// refIsZero implements test if the number is zero.
+bool refIsZero(const ref_t *number) {
+    for (int i = 0; i < REF_LIMBS; i++) {
+        if (number->limbs[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// refBits implements the number of significant bits.
+uint32_t refBits(const ref_t *number) {
+    for (int i = REF_LIMBS - 1; i >= 0; i--) {
+        for (int bit = 31; bit >= 0; bit--) {
+            if ((number->limbs[i] >> bit) & 1u) {
+                return (uint32_t) (32 * i + bit + 1);
+            }
+        }
+    }
+    return 0;
+}
+
+// refAdd implements the sum.
+void refAdd(const ref_t *a, const ref_t *b, ref_t *out) {
+    uint64_t carry = 0;
+    for (int i = 0; i < REF_LIMBS; i++) {
+        uint64_t sum = (uint64_t) a->limbs[i] + b->limbs[i] + carry;
+        out->limbs[i] = (uint32_t) sum;
+        carry = sum >> 32;
+    }
+}
+
+// refSub implements the difference modulo 2^512.
+void refSub(const ref_t *a, const ref_t *b, ref_t *out) {
+    uint64_t borrow = 0;
+    for (int i = 0; i < REF_LIMBS; i++) {
+        uint64_t diff = (uint64_t) a->limbs[i] - b->limbs[i] - borrow;
+        out->limbs[i] = (uint32_t) diff;
+        borrow = (diff >> 32) & 1u;
+    }
+}
+
+// refMul implements the product.
+void refMul(const ref_t *a, const ref_t *b, ref_t *out) {
+    uint32_t result[REF_LIMBS];
+    memset(result, 0, sizeof(result));
+    for (int i = 0; i < REF_LIMBS; i++) {
+        uint64_t carry = 0;
+        for (int j = 0; i + j < REF_LIMBS; j++) {
+            uint64_t product = (uint64_t) a->limbs[i] * b->limbs[j] + result[i + j] + carry;
+            result[i + j] = (uint32_t) product;
+            carry = product >> 32;
+        }
+    }
+    memcpy(out->limbs, result, sizeof(result));
+}
+
+// refShiftLeft implements the left shift by any number of bits.
+void refShiftLeft(const ref_t *number, uint32_t bits, ref_t *out) {
+    ref_t result;
+    refZero(&result);
+    uint32_t words = bits / 32;
+    uint32_t offset = bits % 32;
+    for (uint32_t i = 0; i + words < REF_LIMBS; i++) {
+        uint64_t value = (uint64_t) number->limbs[i] << offset;
+        result.limbs[i + words] |= (uint32_t) value;
+        if (i + words + 1 < REF_LIMBS) {
+            result.limbs[i + words + 1] |= (uint32_t) (value >> 32);
+        }
+    }
+    *out = result;
+}
+
+// refShiftRight implements the right shift by any number of bits.
+void refShiftRight(const ref_t *number, uint32_t bits, ref_t *out) {
+    ref_t result;
+    refZero(&result);
+    uint32_t words = bits / 32;
+    uint32_t offset = bits % 32;
+    for (uint32_t i = 0; i + words < REF_LIMBS; i++) {
+        // the 64 bit window of the source starting at the limb i + words
+        uint64_t value = number->limbs[i + words];
+        if (i + words + 1 < REF_LIMBS) {
+            value |= (uint64_t) number->limbs[i + words + 1] << 32;
+        }
+        result.limbs[i] = (uint32_t) (value >> offset);
+    }
+    *out = result;
+}
+
+// refOr implements the bitwise or.
+void refOr(const ref_t *a, const ref_t *b, ref_t *out) {
+    for (int i = 0; i < REF_LIMBS; i++) {
+        out->limbs[i] = a->limbs[i] | b->limbs[i];
+    }
+}
+
+// refDivMod implements the division with remainder by the bitwise long division.
+void refDivMod(const ref_t *a, const ref_t *b, ref_t *div, ref_t *mod) {
+    ref_t quotient;
+    ref_t remainder;
+    refZero(&quotient);
+    refZero(&remainder);
+
+    for (int i = (int) refBits(a) - 1; i >= 0; i--) {
+        // remainder = remainder * 2 + bit i of a
+        refShiftLeft(&remainder, 1, &remainder);
+        remainder.limbs[0] |= (a->limbs[i / 32] >> (i % 32)) & 1u;
+
+        if (refCompare(&remainder, b) >= 0) {
+            refSub(&remainder, b, &remainder);
+            quotient.limbs[i / 32] |= 1u << (i % 32);
+        }
+    }
+
+    *div = quotient;
+    *mod = remainder;
+}
+
+// refToString implements the textual form in the base 2 to 16.
+size_t refToString(const ref_t *number, uint32_t base, char *out, size_t outSize) {
+    static const char DIGITS[] = "0123456789abcdef";
+
+    // collect the digits in reverse by dividing the limbs by the base
+    char reversed[4 * 8 * REF_LIMBS + 1];
+    size_t length = 0;
+    ref_t value = *number;
+    do {
+        uint64_t remainder = 0;
+        for (int i = REF_LIMBS - 1; i >= 0; i--) {
+            uint64_t current = (remainder << 32) | value.limbs[i];
+            value.limbs[i] = (uint32_t) (current / base);
+            remainder = current % base;
+        }
+        reversed[length++] = DIGITS[remainder];
+    } while (!refIsZero(&value));
+
+    if (length + 1 > outSize) {
+        return 0;
+    }
+    for (size_t i = 0; i < length; i++) {
+        out[i] = reversed[length - 1 - i];
+    }
+    out[length] = '\0';
+    return length;
+}
@@ -0,0 +1,65 @@
+#ifndef FANTOM_HARNESS_BIGINT_REF_H
+#define FANTOM_HARNESS_BIGINT_REF_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// REF_LIMBS defines the number of 32 bit limbs of the reference number; enough for a full 256 x 256 bit product.
+#define REF_LIMBS 16
+
+// ref_t declares the reference unsigned number; little endian 32 bit limbs.
+// The code is the plain school book arithmetic, slow but easy to verify by reading.
+typedef struct {
+    uint32_t limbs[REF_LIMBS];
+} ref_t;
+
+// refZero implements setting the number to zero.
+void refZero(ref_t *number);
+
+// refFromU64 implements setting the number from a 64 bit value.
+void refFromU64(ref_t *number, uint64_t value);
+
+// refFromBE implements reading the number from big endian bytes; up to 64 bytes.
+void refFromBE(ref_t *number, const uint8_t *data, size_t length);
+
+// refToBE implements writing the low bytes of the number as big endian bytes.
+void refToBE(const ref_t *number, uint8_t *out, size_t length);
+
+// refTruncate implements keeping the low bits of the number only.
+void refTruncate(ref_t *number, uint32_t bits);
+
+// refCompare implements comparison of two numbers; returns -1, 0, or 1.
+int refCompare(const ref_t *a, const ref_t *b);
+
+// refIsZero implements test if the number is zero.
+bool refIsZero(const ref_t *number);
+
+// refBits implements the number of significant bits.
+uint32_t refBits(const ref_t *number);
+
+// refAdd implements the sum; the carry out of the top limb is lost.
+void refAdd(const ref_t *a, const ref_t *b, ref_t *out);
+
+// refSub implements the difference modulo 2^512.
+void refSub(const ref_t *a, const ref_t *b, ref_t *out);
+
+// refMul implements the product; bits above 512 are lost.
+void refMul(const ref_t *a, const ref_t *b, ref_t *out);
+
+// refShiftLeft implements the left shift by any number of bits.
+void refShiftLeft(const ref_t *number, uint32_t bits, ref_t *out);
+
+// refShiftRight implements the right shift by any number of bits.
+void refShiftRight(const ref_t *number, uint32_t bits, ref_t *out);
+
+// refOr implements the bitwise or.
+void refOr(const ref_t *a, const ref_t *b, ref_t *out);
+
+// refDivMod implements the division with remainder by the bitwise long division; the divisor must not be zero.
+void refDivMod(const ref_t *a, const ref_t *b, ref_t *div, ref_t *mod);
+
+// refToString implements the textual form in the base 2 to 16; returns the length.
+size_t refToString(const ref_t *number, uint32_t base, char *out, size_t outSize);
+
+#endif //FANTOM_HARNESS_BIGINT_REF_H
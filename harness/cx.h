@@ -0,0 +1,36 @@
+#ifndef FANTOM_HARNESS_CX_H
+#define FANTOM_HARNESS_CX_H
+
+/**
+ * Stands in for the SDK cx.h; only the Keccak-256 the transaction hashing uses is provided.
+ */
+#include <stdint.h>
+#include <stddef.h>
+
+// CX_LAST marks the final block of the hashed data
+#define CX_LAST 1
+
+// KECCAK_RATE is the block size of Keccak-256 in bytes
+#define KECCAK_RATE 136
+
+// cx_hash_t declares the common header of the hash contexts.
+typedef struct {
+    uint32_t algorithm;
+} cx_hash_t;
+
+// cx_sha3_t declares the Keccak context.
+typedef struct {
+    cx_hash_t header;
+    uint64_t state[25];
+    uint8_t block[KECCAK_RATE];
+    size_t blockLength;
+    size_t outputSize;
+} cx_sha3_t;
+
+// cx_keccak_init implements the Keccak context initialization; only 256 bits are supported.
+int cx_keccak_init(cx_sha3_t *hash, int size);
+
+// cx_hash implements feeding the data into the hash; CX_LAST mode finalizes the digest into the out.
+int cx_hash(cx_hash_t *hash, int mode, const uint8_t *in, size_t length, uint8_t *out, size_t outLength);
+
+#endif //FANTOM_HARNESS_CX_H
@@ -0,0 +1,101 @@
+/**
+ * Implements the shared parts of the host harnesses of the app modules.
+ */
+#include <setjmp.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "os.h"
+#include "assert.h"
+#include "errors.h"
+#include "harness.h"
+
+// harnessChecks counts all the checks done
+uint64_t harnessChecks = 0;
+
+// harnessFailures counts the failed checks
+int harnessFailures = 0;
+
+// catchTarget keeps the jump target of the active harnessTry
+static jmp_buf *catchTarget = NULL;
+
+// lastException keeps the exception thrown last
+static uint16_t lastException = 0;
+
+// randomState keeps the state of the random generator
+static uint64_t randomState = 0x9E3779B97F4A7C15u;
+
+// harnessThrow implements the SDK exception; it jumps back to the active harnessTry.
+void harnessThrow(uint16_t exception) {
+    if (catchTarget == NULL) {
+        fprintf(stderr, "uncaught exception 0x%04x\n", exception);
+        abort();
+    }
+    lastException = exception;
+    longjmp(*catchTarget, exception);
+}
+
+// harnessTryEnter implements entering a TRY block; returns the previous jump target.
+jmp_buf *harnessTryEnter(jmp_buf *target) {
+    jmp_buf *previous = catchTarget;
+    catchTarget = target;
+    lastException = 0;
+    return previous;
+}
+
+// harnessTryLeave implements leaving a TRY block; returns the exception caught, if any.
+uint16_t harnessTryLeave(jmp_buf *previous) {
+    catchTarget = previous;
+    return lastException;
+}
+
+// assert implements the app assertion; the device build resets, or throws ERR_ASSERT.
+void assert(int cond, const char *msgStr) {
+    if (!cond) {
+        fprintf(stderr, "assertion failed: %s\n", msgStr);
+        harnessThrow(ERR_ASSERT);
+    }
+}
+
+// ensure implements the app recoverable fault test.
+void ensure(int cond, const char *msgStr) {
+    (void) msgStr;
+    if (!cond) {
+        harnessThrow(ERR_FAULT);
+    }
+}
+
+// harnessTry implements running the code and catching the exception it throws.
+uint16_t harnessTry(harness_fn_t *fn, void *arg) {
+    jmp_buf target;
+    jmp_buf *previous = catchTarget;
+
+    int exception = setjmp(target);
+    if (exception == 0) {
+        catchTarget = &target;
+        fn(arg);
+    }
+
+    catchTarget = previous;
+    return (uint16_t) exception;
+}
+
+// harnessSeed implements seeding the random generator.
+void harnessSeed(uint64_t seed) {
+    randomState = (seed != 0) ? seed : 0x9E3779B97F4A7C15u;
+}
+
+// harnessRandom implements the next random value.
+uint64_t harnessRandom() {
+    randomState ^= randomState >> 12;
+    randomState ^= randomState << 25;
+    randomState ^= randomState >> 27;
+    return randomState * 0x2545F4914F6CDD1Du;
+}
+
+// harnessNowNs implements reading the monotonic clock in nanoseconds.
+uint64_t harnessNowNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
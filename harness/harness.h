@@ -0,0 +1,43 @@
+#ifndef FANTOM_HARNESS_HARNESS_H
+#define FANTOM_HARNESS_HARNESS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+// harness_fn_t declares the code run under harnessTry.
+typedef void harness_fn_t(void *arg);
+
+// harnessTry implements running the code and catching the exception it throws.
+// Returns zero if the code finished, or the thrown exception.
+uint16_t harnessTry(harness_fn_t *fn, void *arg);
+
+// harnessSeed implements seeding the random generator.
+void harnessSeed(uint64_t seed);
+
+// harnessRandom implements the next random value; xorshift64* so the runs are reproducible.
+uint64_t harnessRandom();
+
+// harnessNowNs implements reading the monotonic clock in nanoseconds.
+uint64_t harnessNowNs();
+
+// harnessChecks counts all the checks done
+extern uint64_t harnessChecks;
+
+// harnessFailures counts the failed checks
+extern int harnessFailures;
+
+// HARNESS_CHECK reports the failed condition and keeps going; the first few failures only.
+#define HARNESS_CHECK(cond, ...) \
+    do { \
+        harnessChecks++; \
+        if (!(cond)) { \
+            if (harnessFailures++ < 20) { \
+                fprintf(stderr, "%s:%d: check failed: ", __FILE__, __LINE__); \
+                fprintf(stderr, __VA_ARGS__); \
+                fprintf(stderr, "\n"); \
+            } \
+        } \
+    } while (0)
+
+#endif //FANTOM_HARNESS_HARNESS_H
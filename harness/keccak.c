@@ -0,0 +1,144 @@
+/**
+ * Implements the Keccak-256 stand-in of the SDK hashing. The padding is the original
+ * Keccak one (0x01), not the SHA3 one, same as the cx_keccak_init of the device.
+ */
+#include <string.h>
+
+#include "cx.h"
+
+// KECCAK_ROUNDS is the number of the Keccak-f[1600] rounds
+#define KECCAK_ROUNDS 24
+
+// roundConstants keeps the iota step constants
+static const uint64_t roundConstants[KECCAK_ROUNDS] = {
+        0x0000000000000001u, 0x0000000000008082u, 0x800000000000808Au, 0x8000000080008000u,
+        0x000000000000808Bu, 0x0000000080000001u, 0x8000000080008081u, 0x8000000000008009u,
+        0x000000000000008Au, 0x0000000000000088u, 0x0000000080008009u, 0x000000008000000Au,
+        0x000000008000808Bu, 0x800000000000008Bu, 0x8000000000008089u, 0x8000000000008003u,
+        0x8000000000008002u, 0x8000000000000080u, 0x000000000000800Au, 0x800000008000000Au,
+        0x8000000080008081u, 0x8000000000008080u, 0x0000000080000001u, 0x8000000080008008u,
+};
+
+// rotations keeps the rho step offsets in the pi step order
+static const unsigned rotations[24] = {
+        1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62, 18, 39, 61, 20, 44,
+};
+
+// lanes keeps the pi step lane order
+static const unsigned lanes[24] = {
+        10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20, 14, 22, 9, 6, 1,
+};
+
+// PREVIOUS and NEXT keep the neighbour columns of the theta step
+static const int PREVIOUS[5] = {4, 0, 1, 2, 3};
+static const int NEXT[5] = {1, 2, 3, 4, 0};
+
+// rotl implements 64 bits left rotation.
+static inline uint64_t rotl(uint64_t value, unsigned shift) {
+    return (value << shift) | (value >> (64 - shift));
+}
+
+// keccakPermute implements the Keccak-f[1600] permutation.
+static void keccakPermute(uint64_t *state) {
+    uint64_t columns[5];
+
+    for (int round = 0; round < KECCAK_ROUNDS; round++) {
+        // theta
+        for (int x = 0; x < 5; x++) {
+            columns[x] = state[x] ^ state[x + 5] ^ state[x + 10] ^ state[x + 15] ^ state[x + 20];
+        }
+        for (int x = 0; x < 5; x++) {
+            uint64_t d = columns[PREVIOUS[x]] ^ rotl(columns[NEXT[x]], 1);
+            state[x] ^= d;
+            state[x + 5] ^= d;
+            state[x + 10] ^= d;
+            state[x + 15] ^= d;
+            state[x + 20] ^= d;
+        }
+
+        // rho and pi
+        uint64_t current = state[1];
+        for (int i = 0; i < 24; i++) {
+            uint64_t next = state[lanes[i]];
+            state[lanes[i]] = rotl(current, rotations[i]);
+            current = next;
+        }
+
+        // chi
+        for (int y = 0; y < 25; y += 5) {
+            uint64_t a0 = state[y], a1 = state[y + 1], a2 = state[y + 2], a3 = state[y + 3], a4 = state[y + 4];
+            state[y] = a0 ^ (~a1 & a2);
+            state[y + 1] = a1 ^ (~a2 & a3);
+            state[y + 2] = a2 ^ (~a3 & a4);
+            state[y + 3] = a3 ^ (~a4 & a0);
+            state[y + 4] = a4 ^ (~a0 & a1);
+        }
+
+        // iota
+        state[0] ^= roundConstants[round];
+    }
+}
+
+// keccakAbsorb implements xor of a full block into the state and the permutation.
+static void keccakAbsorb(cx_sha3_t *hash, const uint8_t *block) {
+    for (int i = 0; i < KECCAK_RATE / 8; i++) {
+        uint64_t lane = 0;
+        for (int b = 7; b >= 0; b--) {
+            lane = (lane << 8) | block[i * 8 + b];
+        }
+        hash->state[i] ^= lane;
+    }
+    keccakPermute(hash->state);
+}
+
+// cx_keccak_init implements the Keccak context initialization.
+int cx_keccak_init(cx_sha3_t *hash, int size) {
+    memset(hash, 0, sizeof(cx_sha3_t));
+    hash->outputSize = (size_t) size / 8;
+    return 0;
+}
+
+// cx_hash implements feeding the data into the hash.
+int cx_hash(cx_hash_t *header, int mode, const uint8_t *in, size_t length, uint8_t *out, size_t outLength) {
+    cx_sha3_t *hash = (cx_sha3_t *) header;
+
+    // fill the pending block first, then absorb full blocks straight from the input
+    while (length > 0) {
+        if (hash->blockLength == 0 && length >= KECCAK_RATE) {
+            keccakAbsorb(hash, in);
+            in += KECCAK_RATE;
+            length -= KECCAK_RATE;
+            continue;
+        }
+
+        size_t toCopy = KECCAK_RATE - hash->blockLength;
+        if (length < toCopy) {
+            toCopy = length;
+        }
+        memcpy(hash->block + hash->blockLength, in, toCopy);
+        hash->blockLength += toCopy;
+        in += toCopy;
+        length -= toCopy;
+
+        if (hash->blockLength == KECCAK_RATE) {
+            keccakAbsorb(hash, hash->block);
+            hash->blockLength = 0;
+        }
+    }
+
+    if ((mode & CX_LAST) == 0) {
+        return 0;
+    }
+
+    // pad the last block and squeeze the digest; the context is not usable after this
+    memset(hash->block + hash->blockLength, 0, KECCAK_RATE - hash->blockLength);
+    hash->block[hash->blockLength] ^= 0x01;
+    hash->block[KECCAK_RATE - 1] ^= 0x80;
+    keccakAbsorb(hash, hash->block);
+
+    size_t outputSize = (hash->outputSize < outLength) ? hash->outputSize : outLength;
+    for (size_t i = 0; i < outputSize; i++) {
+        out[i] = (uint8_t) (hash->state[i / 8] >> (8 * (i % 8)));
+    }
+    return (int) outputSize;
+}
@@ -0,0 +1,47 @@
+#ifndef FANTOM_HARNESS_OS_H
+#define FANTOM_HARNESS_OS_H
+
+/**
+ * Stands in for the SDK os.h so the portable app modules build on the host.
+ * Only the exceptions are provided; the harness catches the exceptions
+ * by harnessTry, the modules by the TRY blocks below.
+ */
+#include <stdint.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <string.h>
+
+// harnessThrow implements the SDK exception; it jumps back to the active harnessTry.
+__attribute__((noreturn)) void harnessThrow(uint16_t exception);
+
+// harnessTryEnter implements entering a TRY block; returns the previous jump target.
+jmp_buf *harnessTryEnter(jmp_buf *target);
+
+// harnessTryLeave implements leaving a TRY block; returns the exception caught, if any.
+uint16_t harnessTryLeave(jmp_buf *previous);
+
+#define THROW(x) harnessThrow(x)
+
+// The TRY blocks follow the SDK layout:
+// BEGIN_TRY { TRY { ... } CATCH_OTHER(e) { ... } FINALLY { ... } } END_TRY;
+// An exception thrown in the CATCH_OTHER block goes to the outer TRY.
+#define BEGIN_TRY \
+    { \
+        jmp_buf harnessTarget; \
+        jmp_buf *harnessPrevious = harnessTryEnter(&harnessTarget); \
+        int harnessCaught = 0; \
+        if (setjmp(harnessTarget) != 0) { \
+            harnessCaught = 1; \
+        }
+
+#define TRY if (!harnessCaught)
+
+#define CATCH_OTHER(e) \
+    else for (uint16_t e __attribute__((unused)) = harnessTryLeave(harnessPrevious), harnessOnce = 1; \
+              harnessOnce; harnessOnce = 0)
+
+#define FINALLY harnessTryLeave(harnessPrevious);
+
+#define END_TRY }
+
+#endif //FANTOM_HARNESS_OS_H
@@ -0,0 +1,8 @@
+#ifndef FANTOM_HARNESS_OS_IO_SEPROXYHAL_H
+#define FANTOM_HARNESS_OS_IO_SEPROXYHAL_H
+
+/**
+ * Stands in for the SDK os_io_seproxyhal.h; nothing of it is used by the portable modules.
+ */
+
+#endif //FANTOM_HARNESS_OS_IO_SEPROXYHAL_H
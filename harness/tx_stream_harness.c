@@ -0,0 +1,1128 @@
+/**
+ * Implements the chunk boundary sweep of the transaction stream parser.
+ *
+ * Every transaction of the corpus is fed through txStreamInit/txStreamProcess split
+ * into chunks in many different ways: whole, 1 byte chunks, every single split point,
+ * every pair of split points of the short ones, fixed chunk sizes, random chunkings
+ * and random chunkings of the zero-run compressed form. The parsed transaction_t,
+ * the transaction digest, the data digest and the data capture are checked against
+ * a one-shot reference decoder on every run. The transactions rebuilt from
+ * a transaction template must hash and parse the same as when streamed whole.
+ * The throughput of each chunking strategy is reported at the end.
+ *
+ * Usage:
+ *   tx_stream_harness [--iterations N] [--seed S] [file...]
+ *
+ * The files contain raw RLP of unsigned transactions; they are added to the corpus
+ * and expected to be valid.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "harness.h"
+#include "utils.h"
+#include "errors.h"
+#include "tx_stream.h"
+#include "tx_template.h"
+
+// HARNESS_DEFAULT_ITERATIONS defines the default number of random chunkings per transaction.
+#define HARNESS_DEFAULT_ITERATIONS 40
+
+// HARNESS_RANDOM_TX_COUNT defines the number of random transactions added to the corpus.
+#define HARNESS_RANDOM_TX_COUNT 96
+
+// HARNESS_MAX_CORPUS defines the max number of transactions in the corpus.
+#define HARNESS_MAX_CORPUS 256
+
+// HARNESS_CAPTURE_SIZE defines the size of the data capture buffer.
+#define HARNESS_CAPTURE_SIZE 48
+
+// HARNESS_FULL_SPLIT_LIMIT defines the longest transaction swept at every single split point;
+// the longer ones are split around both ends and at sparse points in between.
+#define HARNESS_FULL_SPLIT_LIMIT 1024
+
+// HARNESS_SPLIT_EDGE defines how many split points at each end of the long transactions are swept.
+#define HARNESS_SPLIT_EDGE 128
+
+// HARNESS_SPLIT_SPARSE defines the number of split points swept between the ends of the long transactions.
+#define HARNESS_SPLIT_SPARSE 32
+
+// HARNESS_PAIR_SPLIT_LIMIT defines the longest transaction swept at every pair of split points.
+#define HARNESS_PAIR_SPLIT_LIMIT 160
+
+// HARNESS_FIELD_SIZE defines the size of the field buffers; oversized invalid fields fit.
+#define HARNESS_FIELD_SIZE 40
+
+// HASH_LENGTH is the size of the Keccak-256 digest
+#define HASH_LENGTH 32
+
+// field_t declares a transaction field of the corpus builder.
+// The raw field is written to the RLP as it is, so invalid encodings can be made.
+typedef struct {
+    uint8_t value[HARNESS_FIELD_SIZE];
+    uint32_t length;
+    bool isRaw;
+} field_t;
+
+// tx_fields_t declares the fields of a corpus transaction.
+typedef struct {
+    field_t type;
+    field_t nonce;
+    field_t gasPrice;
+    field_t startGas;
+    field_t recipient;
+    field_t value;
+    const uint8_t *data;
+    uint32_t dataLength;
+    bool isDataRaw;
+    field_t v;
+    field_t r;
+    field_t s;
+} tx_fields_t;
+
+// corpus_entry_t declares a corpus transaction.
+typedef struct {
+    char name[48];
+    uint8_t *rlp;
+    uint32_t length;
+    uint32_t flags;
+    bool isValid;
+} corpus_entry_t;
+
+// reference_t declares the outcome of the one-shot reference decoder.
+typedef struct {
+    bool isValid;
+    transaction_t tx;
+    uint8_t hash[HASH_LENGTH];
+    uint8_t dataHash[HASH_LENGTH];
+    uint8_t capture[HARNESS_CAPTURE_SIZE];
+} reference_t;
+
+// run_t declares the outcome of a chunked stream run.
+typedef struct {
+    tx_stream_status_e status;
+    bool isEarly;
+    transaction_t tx;
+    cx_sha3_t sha3;
+    cx_sha3_t dataSha3;
+    uint8_t hash[HASH_LENGTH];
+    uint8_t dataHash[HASH_LENGTH];
+    uint8_t capture[HARNESS_CAPTURE_SIZE];
+} run_t;
+
+// strategy_t declares the statistics of a chunking strategy.
+typedef struct {
+    const char *name;
+    uint64_t runs;
+    uint64_t chunks;
+    uint64_t bytes;
+    uint64_t ns;
+} strategy_t;
+
+// the chunking strategies
+enum {
+    STRATEGY_WHOLE = 0,
+    STRATEGY_ONE_BYTE,
+    STRATEGY_SPLIT,
+    STRATEGY_PAIR,
+    STRATEGY_FIXED,
+    STRATEGY_RANDOM,
+    STRATEGY_ZERO_RUN,
+    STRATEGY_COUNT
+};
+
+// strategies keeps the statistics of the chunking strategies
+static strategy_t strategies[STRATEGY_COUNT] = {
+        {.name = "whole"},
+        {.name = "1 byte"},
+        {.name = "every split point"},
+        {.name = "every split pair"},
+        {.name = "fixed size"},
+        {.name = "random"},
+        {.name = "zero-run random"},
+};
+
+// corpus keeps the transactions being swept
+static corpus_entry_t corpus[HARNESS_MAX_CORPUS];
+
+// corpusCount keeps the number of transactions in the corpus
+static size_t corpusCount = 0;
+
+// REF_TX is the SFC call of the host tests; the data carry the full 32 bytes parameter here,
+// the host tests only plan the chunks and don't mind the two bytes missing there.
+static const uint8_t REF_TX[] = {
+        0xf8, 0x50, 0x02, 0x84, 0x3b, 0x9a, 0xca, 0x00, 0x82, 0xab, 0xe0, 0x94, 0x76, 0xae, 0x07, 0xe6,
+        0xd2, 0x36, 0xc1, 0xae, 0x3f, 0x5c, 0x31, 0x12, 0xf3, 0x87, 0xad, 0x82, 0xc6, 0x9a, 0x24, 0x71,
+        0x88, 0x0d, 0xe0, 0xb6, 0xb3, 0xa7, 0x64, 0x00, 0x00, 0xa4, 0xc3, 0x12, 0xeb, 0x07, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x81, 0xfa,
+        0x80, 0x80,
+};
+
+// SFC_ADDRESS is the address of the Opera staking contract.
+static const uint8_t SFC_ADDRESS[] = {
+        0xfc, 0x00, 0xfa, 0xce, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// TOKEN_ADDRESS is the address of a token contract the ERC-20 calls go to.
+static const uint8_t TOKEN_ADDRESS[] = {
+        0x04, 0x06, 0x8d, 0xa6, 0xc8, 0x3a, 0xfc, 0xfa, 0x0e, 0x13,
+        0xba, 0x15, 0xa6, 0x69, 0x66, 0x62, 0x33, 0x5d, 0x5b, 0x75,
+};
+
+// keccak implements the one-shot Keccak-256 of the data.
+static void keccak(const uint8_t *data, size_t length, uint8_t *out) {
+    cx_sha3_t sha3;
+    cx_keccak_init(&sha3, 256);
+    cx_hash((cx_hash_t *) &sha3, CX_LAST, data, length, out, HASH_LENGTH);
+}
+
+// randomBytes implements filling the buffer with random bytes.
+static void randomBytes(uint8_t *out, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        out[i] = (uint8_t) harnessRandom();
+    }
+}
+
+// setUint implements setting the field to the minimal big endian form of the value.
+static void setUint(field_t *field, uint64_t value) {
+    memset(field, 0, sizeof(field_t));
+    while (value != 0) {
+        memmove(field->value + 1, field->value, field->length);
+        field->value[0] = (uint8_t) value;
+        field->length++;
+        value >>= 8;
+    }
+}
+
+// setBytes implements setting the field to the given bytes.
+static void setBytes(field_t *field, const uint8_t *value, uint32_t length) {
+    memset(field, 0, sizeof(field_t));
+    memcpy(field->value, value, length);
+    field->length = length;
+}
+
+// setRaw implements setting the field to the given already encoded bytes.
+static void setRaw(field_t *field, const uint8_t *value, uint32_t length) {
+    setBytes(field, value, length);
+    field->isRaw = true;
+}
+
+// putHeader implements writing the RLP length header; returns the header size.
+static uint32_t putHeader(uint8_t *out, uint32_t length, uint8_t base) {
+    if (length <= 55) {
+        out[0] = (uint8_t) (base + length);
+        return 1;
+    }
+
+    uint32_t size = 0;
+    for (uint32_t rest = length; rest != 0; rest >>= 8) {
+        size++;
+    }
+    out[0] = (uint8_t) (base + 55 + size);
+    for (uint32_t i = 0; i < size; i++) {
+        out[size - i] = (uint8_t) (length >> (8 * i));
+    }
+    return 1 + size;
+}
+
+// putString implements writing the RLP string; single bytes below 0x80 encode themselves.
+static uint32_t putString(uint8_t *out, const uint8_t *value, uint32_t length, bool isRaw) {
+    if (isRaw) {
+        memcpy(out, value, length);
+        return length;
+    }
+    if (length == 1 && value[0] < 0x80) {
+        out[0] = value[0];
+        return 1;
+    }
+
+    uint32_t header = putHeader(out, length, 0x80);
+    memcpy(out + header, value, length);
+    return header + length;
+}
+
+// putField implements writing the builder field.
+static uint32_t putField(uint8_t *out, const field_t *field) {
+    return putString(out, field->value, field->length, field->isRaw);
+}
+
+// addEntry implements adding the RLP to the corpus; the corpus takes the buffer over.
+static void addEntry(const char *name, uint8_t *rlp, uint32_t length, uint32_t flags, bool isValid) {
+    if (corpusCount == HARNESS_MAX_CORPUS) {
+        fprintf(stderr, "corpus is full, %s dropped\n", name);
+        free(rlp);
+        return;
+    }
+
+    corpus_entry_t *entry = &corpus[corpusCount++];
+    snprintf(entry->name, sizeof(entry->name), "%s", name);
+    entry->rlp = rlp;
+    entry->length = length;
+    entry->flags = flags;
+    entry->isValid = isValid;
+}
+
+// buildTx implements building the transaction RLP; the caller owns the buffer.
+static uint8_t *buildTx(const tx_fields_t *fields, uint32_t flags, uint32_t *rlpLength) {
+    uint8_t *body = malloc(fields->dataLength + 16 * HARNESS_FIELD_SIZE);
+    uint32_t length = 0;
+
+    if ((flags & TX_FLAG_TYPE) != 0) {
+        length += putField(body + length, &fields->type);
+    }
+    length += putField(body + length, &fields->nonce);
+    length += putField(body + length, &fields->gasPrice);
+    length += putField(body + length, &fields->startGas);
+    length += putField(body + length, &fields->recipient);
+    length += putField(body + length, &fields->value);
+    length += putString(body + length, fields->data, fields->dataLength, fields->isDataRaw);
+    length += putField(body + length, &fields->v);
+    length += putField(body + length, &fields->r);
+    length += putField(body + length, &fields->s);
+
+    uint8_t *rlp = malloc(length + 8);
+    uint32_t header = putHeader(rlp, length, 0xc0);
+    memcpy(rlp + header, body, length);
+    free(body);
+
+    *rlpLength = header + length;
+    return rlp;
+}
+
+// addTx implements building the transaction RLP and adding it to the corpus.
+static void addTx(const char *name, const tx_fields_t *fields, uint32_t flags, bool isValid) {
+    uint32_t length;
+    uint8_t *rlp = buildTx(fields, flags, &length);
+    addEntry(name, rlp, length, flags, isValid);
+}
+
+// operaTransfer implements the fields of a plain FTM transfer on the Opera main net.
+static void operaTransfer(tx_fields_t *fields) {
+    memset(fields, 0, sizeof(tx_fields_t));
+    setUint(&fields->nonce, 7);
+    setUint(&fields->gasPrice, 100000000000u);
+    setUint(&fields->startGas, 21000);
+    setBytes(&fields->recipient, REF_TX + 12, 20);
+    setUint(&fields->value, 12500000000000000000u);
+    setUint(&fields->v, 250);
+}
+
+// buildCorpus implements the named transactions of the corpus.
+static void buildCorpus() {
+    tx_fields_t fields;
+    uint8_t call[128];
+    static uint8_t deployment[70000];
+    randomBytes(deployment, sizeof(deployment));
+
+    uint8_t *rlp = malloc(sizeof(REF_TX));
+    memcpy(rlp, REF_TX, sizeof(REF_TX));
+    addEntry("ref_tx", rlp, sizeof(REF_TX), 0, true);
+
+    operaTransfer(&fields);
+    addTx("transfer", &fields, 0, true);
+
+    // the nonce is empty and the value is a single byte encoding itself
+    operaTransfer(&fields);
+    setUint(&fields.nonce, 0);
+    setUint(&fields.value, 1);
+    addTx("transfer_small", &fields, 0, true);
+
+    // the single byte values on both sides of the self encoding boundary
+    operaTransfer(&fields);
+    setUint(&fields.nonce, 0x7f);
+    setUint(&fields.value, 0x80);
+    setUint(&fields.v, 0x7f);
+    addTx("transfer_byte_edges", &fields, 0, true);
+
+    operaTransfer(&fields);
+    setUint(&fields.v, 4002 * 2 + 35);
+    addTx("transfer_testnet", &fields, 0, true);
+
+    // all the fields take the max length
+    operaTransfer(&fields);
+    memset(fields.nonce.value, 0xff, 8);
+    fields.nonce.length = 8;
+    memset(fields.gasPrice.value, 0xff, TX_MAX_INT256_LENGTH);
+    fields.gasPrice.length = TX_MAX_INT256_LENGTH;
+    memset(fields.startGas.value, 0xff, TX_MAX_INT256_LENGTH);
+    fields.startGas.length = TX_MAX_INT256_LENGTH;
+    memset(fields.value.value, 0xff, TX_MAX_INT256_LENGTH);
+    fields.value.length = TX_MAX_INT256_LENGTH;
+    memset(fields.v.value, 0xff, TX_MAX_V_LENGTH);
+    fields.v.length = TX_MAX_V_LENGTH;
+    addTx("full_width", &fields, 0, true);
+
+    // ERC-20 transfer(address,uint256)
+    operaTransfer(&fields);
+    setBytes(&fields.recipient, TOKEN_ADDRESS, 20);
+    setUint(&fields.value, 0);
+    setUint(&fields.startGas, 65000);
+    memset(call, 0, sizeof(call));
+    memcpy(call, "\xa9\x05\x9c\xbb", 4);
+    memcpy(call + 4 + 12, SFC_ADDRESS, 20);
+    call[4 + 32 + 24] = 0x0d;
+    call[4 + 32 + 25] = 0xe0;
+    fields.data = call;
+    fields.dataLength = 4 + 2 * 32;
+    addTx("erc20_transfer", &fields, 0, true);
+
+    // ERC-20 approve(address,uint256) of the unlimited amount
+    memcpy(call, "\x09\x5e\xa7\xb3", 4);
+    memset(call + 4 + 32, 0xff, 32);
+    addTx("erc20_approve", &fields, 0, true);
+
+    // SFC delegate(uint256)
+    operaTransfer(&fields);
+    setBytes(&fields.recipient, SFC_ADDRESS, 20);
+    setUint(&fields.value, 1000000000000000000u);
+    setUint(&fields.startGas, 250000);
+    memset(call, 0, sizeof(call));
+    memcpy(call, "\x9f\xa6\xdd\x35", 4);
+    call[4 + 31] = 0x11;
+    fields.data = call;
+    fields.dataLength = 4 + 32;
+    addTx("sfc_delegate", &fields, 0, true);
+
+    // data of one byte encoding itself, and one byte over the self encoding
+    operaTransfer(&fields);
+    call[0] = 0x00;
+    fields.data = call;
+    fields.dataLength = 1;
+    addTx("data_single_zero", &fields, 0, true);
+    call[0] = 0x80;
+    addTx("data_single_high", &fields, 0, true);
+
+    // deployments around the short and long string boundary and the long list headers
+    const uint32_t DEPLOYMENTS[] = {55, 56, 255, 256, 1000, 20480, 65535, 70000};
+    for (size_t i = 0; i < ARRAY_LEN(DEPLOYMENTS); i++) {
+        char name[32];
+        operaTransfer(&fields);
+        setUint(&fields.recipient, 0);
+        setUint(&fields.value, 0);
+        setUint(&fields.startGas, 5000000);
+        fields.data = deployment;
+        fields.dataLength = DEPLOYMENTS[i];
+        snprintf(name, sizeof(name), "deploy_%u", DEPLOYMENTS[i]);
+        addTx(name, &fields, 0, true);
+    }
+
+    // the type field precedes the nonce
+    operaTransfer(&fields);
+    setUint(&fields.type, 1);
+    addTx("typed_transfer", &fields, TX_FLAG_TYPE, true);
+
+    // the parser must reject these
+    operaTransfer(&fields);
+    memset(fields.v.value, 0x01, TX_MAX_V_LENGTH + 1);
+    fields.v.length = TX_MAX_V_LENGTH + 1;
+    addTx("invalid_v_length", &fields, 0, false);
+
+    operaTransfer(&fields);
+    fields.recipient.length = TX_MAX_ADDRESS_LENGTH + 1;
+    addTx("invalid_recipient_length", &fields, 0, false);
+
+    operaTransfer(&fields);
+    memset(fields.gasPrice.value, 0x01, TX_MAX_INT256_LENGTH + 1);
+    fields.gasPrice.length = TX_MAX_INT256_LENGTH + 1;
+    addTx("invalid_gas_price_length", &fields, 0, false);
+
+    operaTransfer(&fields);
+    setRaw(&fields.nonce, (const uint8_t *) "\xc1\x01", 2);
+    addTx("invalid_nonce_list", &fields, 0, false);
+
+    operaTransfer(&fields);
+    fields.data = (const uint8_t *) "\xbc\x00\x00\x00\x00\x01\x00";
+    fields.dataLength = 7;
+    fields.isDataRaw = true;
+    addTx("invalid_data_header", &fields, 0, false);
+
+    rlp = malloc(sizeof(REF_TX));
+    memcpy(rlp, REF_TX, sizeof(REF_TX));
+    rlp[0] = 0xb8;
+    addEntry("invalid_envelope", rlp, sizeof(REF_TX), 0, false);
+
+    rlp = malloc(sizeof(REF_TX));
+    memcpy(rlp, REF_TX, sizeof(REF_TX));
+    addEntry("invalid_truncated", rlp, sizeof(REF_TX) - 1, 0, false);
+}
+
+// randomField implements a random field of up to the max length, edge lengths preferred.
+static void randomField(field_t *field, uint32_t maxLength) {
+    memset(field, 0, sizeof(field_t));
+    switch (harnessRandom() % 4) {
+        case 0:
+            field->length = (uint32_t) (harnessRandom() % 2);
+            break;
+        case 1:
+            field->length = maxLength;
+            break;
+        default:
+            field->length = (uint32_t) (harnessRandom() % (maxLength + 1));
+            break;
+    }
+    randomBytes(field->value, field->length);
+
+    // single bytes on both sides of the self encoding boundary
+    if (field->length == 1 && (harnessRandom() % 2) == 0) {
+        field->value[0] &= 0x7f;
+    }
+}
+
+// buildRandomCorpus implements adding the random valid transactions to the corpus.
+static void buildRandomCorpus(size_t count) {
+    const uint32_t DATA_LENGTHS[] = {0, 1, 4, 36, 55, 56, 68, 100, 255, 256};
+    static uint8_t data[1024];
+
+    for (size_t i = 0; i < count; i++) {
+        tx_fields_t fields;
+        char name[32];
+        memset(&fields, 0, sizeof(fields));
+        uint32_t flags = ((harnessRandom() % 8) == 0) ? TX_FLAG_TYPE : 0;
+
+        randomField(&fields.type, 1);
+        randomField(&fields.nonce, 8);
+        randomField(&fields.gasPrice, TX_MAX_INT256_LENGTH);
+        randomField(&fields.startGas, 8);
+        randomField(&fields.recipient, TX_MAX_ADDRESS_LENGTH);
+        if ((harnessRandom() % 2) == 0) {
+            fields.recipient.length = (fields.recipient.length < 10) ? 0 : TX_MAX_ADDRESS_LENGTH;
+        }
+        randomField(&fields.value, TX_MAX_INT256_LENGTH);
+        randomField(&fields.v, TX_MAX_V_LENGTH);
+        randomField(&fields.r, HASH_LENGTH);
+        randomField(&fields.s, HASH_LENGTH);
+
+        if ((harnessRandom() % 2) == 0) {
+            fields.dataLength = DATA_LENGTHS[harnessRandom() % ARRAY_LEN(DATA_LENGTHS)];
+        } else {
+            fields.dataLength = (uint32_t) (harnessRandom() % sizeof(data));
+        }
+        randomBytes(data, fields.dataLength);
+        if (fields.dataLength == 1 && (harnessRandom() % 2) == 0) {
+            data[0] &= 0x7f;
+        }
+        fields.data = data;
+
+        snprintf(name, sizeof(name), "random_%zu", i);
+        addTx(name, &fields, flags, true);
+    }
+}
+
+// loadFile implements adding the raw RLP of the file to the corpus.
+static bool loadFile(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (file == NULL) {
+        perror(path);
+        return false;
+    }
+
+    size_t capacity = 4096;
+    size_t length = 0;
+    uint8_t *rlp = malloc(capacity);
+    for (;;) {
+        if (length == capacity) {
+            capacity *= 2;
+            rlp = realloc(rlp, capacity);
+        }
+        size_t read = fread(rlp + length, 1, capacity - length, file);
+        if (read == 0) {
+            break;
+        }
+        length += read;
+    }
+    fclose(file);
+
+    if (length == 0) {
+        fprintf(stderr, "%s: empty file\n", path);
+        free(rlp);
+        return false;
+    }
+
+    addEntry(path, rlp, (uint32_t) length, 0, true);
+    return true;
+}
+
+// refItem implements decoding the RLP item header at the position.
+// The position is advanced behind the whole item.
+static bool refItem(const uint8_t *rlp, uint32_t length, uint32_t *pos, bool *isList,
+                    const uint8_t **payload, uint32_t *payloadLength) {
+    if (*pos >= length) {
+        return false;
+    }
+
+    uint8_t prefix = rlp[*pos];
+    uint32_t header = 1;
+    uint32_t size;
+
+    *isList = (prefix >= 0xc0);
+    if (prefix <= 0x7f) {
+        header = 0;
+        size = 1;
+    } else if (prefix <= 0xb7 || (prefix >= 0xc0 && prefix <= 0xf7)) {
+        size = (uint32_t) (prefix - (*isList ? 0xc0 : 0x80));
+    } else {
+        uint32_t sizeLength = (uint32_t) (prefix - (*isList ? 0xf7 : 0xb7));
+        if (sizeLength > 4 || *pos + 1 + sizeLength > length) {
+            return false;
+        }
+        size = 0;
+        for (uint32_t i = 0; i < sizeLength; i++) {
+            size = (size << 8) | rlp[*pos + 1 + i];
+        }
+        header += sizeLength;
+    }
+
+    if (size > length - *pos - header) {
+        return false;
+    }
+
+    *payload = rlp + *pos + header;
+    *payloadLength = size;
+    *pos += header + size;
+    return true;
+}
+
+// refValue implements decoding the next non-list item of at most the max length.
+// The value is stored, if the target is given.
+static bool refValue(const uint8_t *rlp, uint32_t length, uint32_t *pos, uint32_t maxLength,
+                     uint8_t *value, uint8_t *valueLength) {
+    const uint8_t *payload;
+    uint32_t payloadLength;
+    bool isList;
+
+    if (!refItem(rlp, length, pos, &isList, &payload, &payloadLength)) {
+        return false;
+    }
+    if (isList || payloadLength > maxLength) {
+        return false;
+    }
+    if (value != NULL) {
+        memcpy(value, payload, payloadLength);
+        *valueLength = (uint8_t) payloadLength;
+    }
+    return true;
+}
+
+// referenceDecode implements the one-shot reference decoder of the whole transaction.
+static void referenceDecode(const corpus_entry_t *entry, reference_t *ref) {
+    const uint8_t *rlp = entry->rlp;
+    const uint8_t *payload;
+    const uint8_t *data;
+    uint32_t payloadLength;
+    uint32_t dataLength;
+    uint32_t pos = 0;
+    bool isList;
+
+    memset(ref, 0, sizeof(reference_t));
+    keccak(rlp, entry->length, ref->hash);
+
+    // the envelope must be a list covering the whole transaction
+    if (!refItem(rlp, entry->length, &pos, &isList, &payload, &payloadLength) || !isList ||
+        pos != entry->length) {
+        return;
+    }
+
+    uint32_t end = pos;
+    pos = (uint32_t) (payload - rlp);
+    transaction_t *tx = &ref->tx;
+
+    bool isValid = true;
+    if ((entry->flags & TX_FLAG_TYPE) != 0) {
+        isValid = isValid && refValue(rlp, end, &pos, TX_MAX_INT256_LENGTH, NULL, NULL);
+    }
+    isValid = isValid && refValue(rlp, end, &pos, TX_MAX_INT256_LENGTH, NULL, NULL);
+    isValid = isValid && refValue(rlp, end, &pos, TX_MAX_INT256_LENGTH, tx->gasPrice.value, &tx->gasPrice.length);
+    isValid = isValid && refValue(rlp, end, &pos, TX_MAX_INT256_LENGTH, tx->startGas.value, &tx->startGas.length);
+    isValid = isValid && refValue(rlp, end, &pos, TX_MAX_ADDRESS_LENGTH, tx->recipient.value,
+                                  &tx->recipient.length);
+    isValid = isValid && refValue(rlp, end, &pos, TX_MAX_INT256_LENGTH, tx->value.value, &tx->value.length);
+    isValid = isValid && refItem(rlp, end, &pos, &isList, &data, &dataLength) && !isList;
+    isValid = isValid && refValue(rlp, end, &pos, TX_MAX_V_LENGTH, tx->v.value, &tx->v.length);
+    isValid = isValid && refValue(rlp, end, &pos, UINT32_MAX, NULL, NULL);
+    isValid = isValid && refValue(rlp, end, &pos, UINT32_MAX, NULL, NULL);
+    if (!isValid || pos != end) {
+        return;
+    }
+
+    tx->dataLength = dataLength;
+    tx->isContractCall = (dataLength >= 4) && ((dataLength - 4) % 32 == 0);
+    keccak(data, dataLength, ref->dataHash);
+    memcpy(ref->capture, data, (dataLength < HARNESS_CAPTURE_SIZE) ? dataLength : HARNESS_CAPTURE_SIZE);
+    ref->isValid = true;
+}
+
+// streamRun implements feeding the input to the stream in the planned chunks.
+// The zero-run input is the compressed form of the transaction.
+static void streamRun(const corpus_entry_t *entry, uint8_t *input, const uint32_t *chunks, size_t chunkCount,
+                      bool isZeroRun, run_t *run) {
+    tx_stream_context_t stream;
+    uint32_t offset = 0;
+
+    memset(run, 0, sizeof(run_t));
+    txStreamInit(&stream, &run->sha3, &run->tx);
+    txStreamEnableDataDigest(&stream, &run->dataSha3);
+    txStreamEnableDataCapture(&stream, run->capture, HARNESS_CAPTURE_SIZE);
+
+    run->status = TX_STREAM_PROCESSING;
+    for (size_t i = 0; i < chunkCount; i++) {
+        if (run->status != TX_STREAM_PROCESSING) {
+            run->isEarly = true;
+            break;
+        }
+        if (isZeroRun) {
+            run->status = txStreamProcessZeroRun(&stream, input + offset, chunks[i], entry->flags);
+        } else {
+            run->status = txStreamProcess(&stream, input + offset, chunks[i], entry->flags);
+        }
+        offset += chunks[i];
+    }
+
+    if (run->status == TX_STREAM_FINISHED) {
+        cx_hash((cx_hash_t *) &run->sha3, CX_LAST, run->hash, 0, run->hash, HASH_LENGTH);
+        cx_hash((cx_hash_t *) &run->dataSha3, CX_LAST, run->dataHash, 0, run->dataHash, HASH_LENGTH);
+    }
+}
+
+// describePlan implements the short description of the chunk plan for the failure reports.
+static const char *describePlan(const uint32_t *chunks, size_t chunkCount) {
+    static char description[128];
+    size_t length = 0;
+
+    for (size_t i = 0; i < chunkCount && length < sizeof(description) - 16; i++) {
+        length += (size_t) snprintf(description + length, sizeof(description) - length, "%s%u",
+                                    (i == 0) ? "" : ",", chunks[i]);
+    }
+    if (length >= sizeof(description) - 16) {
+        snprintf(description + length, sizeof(description) - length, ",... (%zu chunks)", chunkCount);
+    }
+    return description;
+}
+
+// sameBytes implements comparison of the parsed field against the reference.
+static bool sameBytes(const uint8_t *actual, uint8_t actualLength, const uint8_t *expected, uint8_t expectedLength) {
+    return actualLength == expectedLength && memcmp(actual, expected, expectedLength) == 0;
+}
+
+// checkPlan implements the stream run of the chunk plan and the check against the reference.
+static void checkPlan(int strategy, const corpus_entry_t *entry, const reference_t *ref, uint8_t *input,
+                      const uint32_t *chunks, size_t chunkCount, bool isZeroRun) {
+    run_t run;
+
+    uint64_t start = harnessNowNs();
+    streamRun(entry, input, chunks, chunkCount, isZeroRun, &run);
+    strategies[strategy].ns += harnessNowNs() - start;
+    strategies[strategy].runs++;
+    strategies[strategy].chunks += chunkCount;
+    strategies[strategy].bytes += entry->length;
+
+    const char *name = strategies[strategy].name;
+    if (!ref->isValid) {
+        HARNESS_CHECK(run.status != TX_STREAM_FINISHED, "%s %s: invalid tx accepted, chunks %s",
+                      name, entry->name, describePlan(chunks, chunkCount));
+        return;
+    }
+
+    HARNESS_CHECK(run.status == TX_STREAM_FINISHED && !run.isEarly, "%s %s: status %d%s, chunks %s",
+                  name, entry->name, run.status, run.isEarly ? " early" : "", describePlan(chunks, chunkCount));
+    if (run.status != TX_STREAM_FINISHED) {
+        return;
+    }
+
+    const transaction_t *tx = &run.tx;
+    const transaction_t *expected = &ref->tx;
+    bool isSame = sameBytes(tx->gasPrice.value, tx->gasPrice.length, expected->gasPrice.value,
+                            expected->gasPrice.length) &&
+                  sameBytes(tx->startGas.value, tx->startGas.length, expected->startGas.value,
+                            expected->startGas.length) &&
+                  sameBytes(tx->value.value, tx->value.length, expected->value.value, expected->value.length) &&
+                  sameBytes(tx->recipient.value, tx->recipient.length, expected->recipient.value,
+                            expected->recipient.length) &&
+                  sameBytes(tx->v.value, tx->v.length, expected->v.value, expected->v.length) &&
+                  tx->dataLength == expected->dataLength &&
+                  tx->isContractCall == expected->isContractCall;
+    HARNESS_CHECK(isSame, "%s %s: transaction differs, chunks %s", name, entry->name,
+                  describePlan(chunks, chunkCount));
+    HARNESS_CHECK(memcmp(run.hash, ref->hash, HASH_LENGTH) == 0, "%s %s: digest differs, chunks %s",
+                  name, entry->name, describePlan(chunks, chunkCount));
+    HARNESS_CHECK(memcmp(run.dataHash, ref->dataHash, HASH_LENGTH) == 0, "%s %s: data digest differs, chunks %s",
+                  name, entry->name, describePlan(chunks, chunkCount));
+    HARNESS_CHECK(memcmp(run.capture, ref->capture, HARNESS_CAPTURE_SIZE) == 0,
+                  "%s %s: data capture differs, chunks %s", name, entry->name, describePlan(chunks, chunkCount));
+}
+
+// randomChunk implements a random chunk length; short chunks are preferred
+// so the boundaries fall inside the field headers often.
+static uint32_t randomChunk() {
+    switch (harnessRandom() % 4) {
+        case 0:
+        case 1:
+            return 1 + (uint32_t) (harnessRandom() % 4);
+        case 2:
+            return 5 + (uint32_t) (harnessRandom() % 36);
+        default:
+            return 41 + (uint32_t) (harnessRandom() % 215);
+    }
+}
+
+// zeroRunCompress implements the zero-run compression of the host library.
+// The pair positions mark the zero bytes followed by their run length; a chunk
+// must not split the pair.
+static uint32_t zeroRunCompress(const uint8_t *data, uint32_t length, uint8_t *out, bool *isPair) {
+    uint32_t outLength = 0;
+
+    for (uint32_t i = 0; i < length;) {
+        if (data[i] != 0) {
+            isPair[outLength] = false;
+            out[outLength++] = data[i++];
+            continue;
+        }
+
+        uint32_t run = 0;
+        while (i < length && data[i] == 0 && run < 255) {
+            run++;
+            i++;
+        }
+        isPair[outLength] = true;
+        out[outLength++] = 0;
+        isPair[outLength] = false;
+        out[outLength++] = (uint8_t) run;
+    }
+    return outLength;
+}
+
+// sweepEntry implements all the chunking strategies on the corpus transaction.
+static void sweepEntry(const corpus_entry_t *entry, uint64_t iterations) {
+    reference_t ref;
+    referenceDecode(entry, &ref);
+    HARNESS_CHECK(ref.isValid == entry->isValid, "%s: reference decoder says %s", entry->name,
+                  ref.isValid ? "valid" : "invalid");
+
+    uint32_t length = entry->length;
+    uint32_t *chunks = malloc((2 * (size_t) length + 2) * sizeof(uint32_t));
+    uint8_t *input = entry->rlp;
+
+    // whole
+    chunks[0] = length;
+    checkPlan(STRATEGY_WHOLE, entry, &ref, input, chunks, 1, false);
+
+    // 1 byte chunks
+    for (uint32_t i = 0; i < length; i++) {
+        chunks[i] = 1;
+    }
+    checkPlan(STRATEGY_ONE_BYTE, entry, &ref, input, chunks, length, false);
+
+    // every single split point; the long ones around both ends and sparse in between
+    uint32_t sparseStep = length / HARNESS_SPLIT_SPARSE;
+    for (uint32_t split = 1; split < length; split++) {
+        if (length > HARNESS_FULL_SPLIT_LIMIT && split > HARNESS_SPLIT_EDGE && split < length - HARNESS_SPLIT_EDGE &&
+            (split % sparseStep) != 0) {
+            continue;
+        }
+        chunks[0] = split;
+        chunks[1] = length - split;
+        checkPlan(STRATEGY_SPLIT, entry, &ref, input, chunks, 2, false);
+    }
+
+    // every pair of split points of the short ones
+    if (length <= HARNESS_PAIR_SPLIT_LIMIT) {
+        for (uint32_t first = 1; first < length; first++) {
+            for (uint32_t second = first + 1; second < length; second++) {
+                chunks[0] = first;
+                chunks[1] = second - first;
+                chunks[2] = length - second;
+                checkPlan(STRATEGY_PAIR, entry, &ref, input, chunks, 3, false);
+            }
+        }
+    }
+
+    // fixed chunk sizes, including the APDU payload sizes
+    const uint32_t FIXED[] = {2, 3, 4, 5, 7, 8, 16, 20, 21, 32, 33, 64, 128, 150, 250, 255};
+    for (size_t f = 0; f < ARRAY_LEN(FIXED); f++) {
+        size_t count = 0;
+        for (uint32_t pos = 0; pos < length; pos += FIXED[f]) {
+            chunks[count++] = (length - pos < FIXED[f]) ? length - pos : FIXED[f];
+        }
+        checkPlan(STRATEGY_FIXED, entry, &ref, input, chunks, count, false);
+    }
+
+    // random chunkings
+    for (uint64_t i = 0; i < iterations; i++) {
+        size_t count = 0;
+        for (uint32_t pos = 0; pos < length;) {
+            uint32_t chunk = randomChunk();
+            chunks[count++] = (length - pos < chunk) ? length - pos : chunk;
+            pos += chunks[count - 1];
+        }
+        checkPlan(STRATEGY_RANDOM, entry, &ref, input, chunks, count, false);
+    }
+
+    // random chunkings of the zero-run compressed form
+    uint8_t *compressed = malloc(2 * (size_t) length);
+    bool *isPair = malloc(2 * (size_t) length);
+    uint32_t compressedLength = zeroRunCompress(input, length, compressed, isPair);
+    for (uint64_t i = 0; i < iterations; i++) {
+        size_t count = 0;
+        for (uint32_t pos = 0; pos < compressedLength;) {
+            uint32_t chunk = randomChunk();
+            if (compressedLength - pos < chunk) {
+                chunk = compressedLength - pos;
+            }
+            if (isPair[pos + chunk - 1]) {
+                chunk++;
+            }
+            chunks[count++] = chunk;
+            pos += chunk;
+        }
+        checkPlan(STRATEGY_ZERO_RUN, entry, &ref, compressed, chunks, count, true);
+    }
+
+    free(isPair);
+    free(compressed);
+    free(chunks);
+}
+
+// checkKeccak implements the known answer check of the Keccak stand-in;
+// the digests would agree with each other even if the Keccak was wrong.
+static void checkKeccak() {
+    const uint8_t EMPTY[HASH_LENGTH] = {
+            0xc5, 0xd2, 0x46, 0x01, 0x86, 0xf7, 0x23, 0x3c, 0x92, 0x7e, 0x7d, 0xb2, 0xdc, 0xc7, 0x03, 0xc0,
+            0xe5, 0x00, 0xb6, 0x53, 0xca, 0x82, 0x27, 0x3b, 0x7b, 0xfa, 0xd8, 0x04, 0x5d, 0x85, 0xa4, 0x70,
+    };
+    const uint8_t TRANSFER[4] = {0xa9, 0x05, 0x9c, 0xbb};
+    uint8_t digest[HASH_LENGTH];
+
+    keccak(NULL, 0, digest);
+    HARNESS_CHECK(memcmp(digest, EMPTY, HASH_LENGTH) == 0, "keccak of empty data differs");
+
+    const char *signature = "transfer(address,uint256)";
+    keccak((const uint8_t *) signature, strlen(signature), digest);
+    HARNESS_CHECK(memcmp(digest, TRANSFER, sizeof(TRANSFER)) == 0, "keccak of the transfer signature differs");
+}
+
+// lastResponse keeps the status of the last response sent by the template handler.
+static uint16_t lastResponse = 0;
+
+// io_send_buf implements the response of the app modules; only the status is kept.
+void io_send_buf(uint16_t code, const uint8_t *buffer, size_t bufferSize) {
+    (void) buffer;
+    (void) bufferSize;
+    lastResponse = code;
+}
+
+// ui_idle implements the return of the app modules to the idle screen; there is no screen here.
+void ui_idle(void) {
+}
+
+// template_call_t declares a call of the template instruction, or of the template processing.
+typedef struct {
+    uint8_t p1;
+    uint8_t *wire;
+    size_t wireSize;
+    bool isOnInit;
+    tx_stream_context_t *stream;
+    tx_stream_status_e status;
+} template_call_t;
+
+// templateHandle implements a single template instruction call under harnessTry.
+static void templateHandle(void *arg) {
+    template_call_t *call = arg;
+    handleTxTemplate(call->p1, 0, call->wire, call->wireSize, call->isOnInit);
+}
+
+// templateProcess implements the template transaction processing under harnessTry.
+static void templateProcess(void *arg) {
+    template_call_t *call = arg;
+    call->status = txTemplateProcess(call->stream, call->wire, call->wireSize);
+}
+
+// putTemplateField implements writing the length prefixed template field.
+static size_t putTemplateField(uint8_t *out, const field_t *field) {
+    out[0] = (uint8_t) field->length;
+    memcpy(out + 1, field->value, field->length);
+    return 1 + field->length;
+}
+
+// uploadTemplate implements sending the template of the transaction fields to the template handler.
+// The data are sent in short blocks so the data block is exercised. Returns the first exception.
+static uint16_t uploadTemplate(const tx_fields_t *fields) {
+    uint8_t wire[256];
+    size_t size = 0;
+    size += putTemplateField(wire + size, &fields->gasPrice);
+    size += putTemplateField(wire + size, &fields->startGas);
+    size += putTemplateField(wire + size, &fields->v);
+    wire[size++] = (uint8_t) (fields->dataLength >> 8);
+    wire[size++] = (uint8_t) fields->dataLength;
+
+    template_call_t call = {.p1 = 0x00, .wire = wire, .wireSize = size, .isOnInit = true};
+    uint16_t exception = harnessTry(templateHandle, &call);
+    for (uint32_t offset = 0; exception == 0 && offset < fields->dataLength; offset += 64) {
+        uint32_t length = (fields->dataLength - offset < 64) ? fields->dataLength - offset : 64;
+        memcpy(wire, fields->data + offset, length);
+        call = (template_call_t) {.p1 = 0x01, .wire = wire, .wireSize = length, .isOnInit = false};
+        exception = harnessTry(templateHandle, &call);
+    }
+    return exception;
+}
+
+// templateRun implements building the transaction from the uploaded template and the per transaction fields.
+// Returns the exception thrown, if any.
+static uint16_t templateRun(const tx_fields_t *fields, run_t *run) {
+    uint8_t wire[3 + 2 * TX_MAX_INT256_LENGTH + TX_MAX_ADDRESS_LENGTH];
+    size_t size = 0;
+    size += putTemplateField(wire + size, &fields->nonce);
+    size += putTemplateField(wire + size, &fields->recipient);
+    size += putTemplateField(wire + size, &fields->value);
+
+    tx_stream_context_t stream;
+    memset(run, 0, sizeof(run_t));
+    txStreamInit(&stream, &run->sha3, &run->tx);
+    txStreamEnableDataDigest(&stream, &run->dataSha3);
+    txStreamEnableDataCapture(&stream, run->capture, HARNESS_CAPTURE_SIZE);
+
+    template_call_t call = {.wire = wire, .wireSize = size, .stream = &stream};
+    uint16_t exception = harnessTry(templateProcess, &call);
+    run->status = call.status;
+    if (exception == 0 && run->status == TX_STREAM_FINISHED) {
+        cx_hash((cx_hash_t *) &run->sha3, CX_LAST, run->hash, 0, run->hash, HASH_LENGTH);
+        cx_hash((cx_hash_t *) &run->dataSha3, CX_LAST, run->dataHash, 0, run->dataHash, HASH_LENGTH);
+    }
+    return exception;
+}
+
+// checkTemplate implements comparing the transaction built from the template with the streamed one.
+static void checkTemplate(const char *name, const tx_fields_t *fields) {
+    corpus_entry_t entry = {.flags = 0, .isValid = true};
+    snprintf(entry.name, sizeof(entry.name), "%s", name);
+    entry.rlp = buildTx(fields, 0, &entry.length);
+
+    static run_t streamed, built;
+    streamRun(&entry, entry.rlp, &entry.length, 1, false, &streamed);
+    HARNESS_CHECK(streamed.status == TX_STREAM_FINISHED, "%s: the streamed transaction did not finish", name);
+
+    uint16_t exception = uploadTemplate(fields);
+    HARNESS_CHECK(exception == 0 && lastResponse == SUCCESS, "%s: template upload failed 0x%04x", name, exception);
+
+    exception = templateRun(fields, &built);
+    HARNESS_CHECK(exception == 0 && built.status == TX_STREAM_FINISHED,
+                  "%s: template transaction failed 0x%04x, status %d", name, exception, built.status);
+    HARNESS_CHECK(memcmp(built.hash, streamed.hash, HASH_LENGTH) == 0, "%s: template hash differs", name);
+    HARNESS_CHECK(memcmp(&built.tx, &streamed.tx, sizeof(transaction_t)) == 0,
+                  "%s: template transaction_t differs", name);
+    HARNESS_CHECK(memcmp(built.dataHash, streamed.dataHash, HASH_LENGTH) == 0 &&
+                  memcmp(built.capture, streamed.capture, HARNESS_CAPTURE_SIZE) == 0,
+                  "%s: template data differ", name);
+    free(entry.rlp);
+}
+
+// checkTemplates implements the transaction template checks against the streamed transactions.
+static void checkTemplates() {
+    tx_fields_t fields;
+    uint8_t data[TX_TEMPLATE_MAX_DATA];
+    randomBytes(data, sizeof(data));
+
+    operaTransfer(&fields);
+    checkTemplate("template transfer", &fields);
+
+    // ERC-20 transfer call
+    uint8_t call[68] = {0xa9, 0x05, 0x9c, 0xbb};
+    memcpy(call + 16, REF_TX + 12, 20);
+    call[67] = 0x64;
+    operaTransfer(&fields);
+    fields.data = call;
+    fields.dataLength = sizeof(call);
+    checkTemplate("template erc20 call", &fields);
+
+    // contract deployment has no recipient; the data are longer than 55 bytes
+    operaTransfer(&fields);
+    setBytes(&fields.recipient, NULL, 0);
+    setUint(&fields.value, 0);
+    fields.data = data;
+    fields.dataLength = sizeof(data);
+    checkTemplate("template deployment", &fields);
+
+    // single byte data below 0x80 encodes itself, the empty nonce and value are zero
+    uint8_t byte = 0x42;
+    operaTransfer(&fields);
+    setUint(&fields.nonce, 0);
+    setUint(&fields.value, 0);
+    fields.data = &byte;
+    fields.dataLength = 1;
+    checkTemplate("template data below 0x80", &fields);
+
+    // single byte data and values on the other side of the self encoding boundary
+    uint8_t high = 0x80;
+    operaTransfer(&fields);
+    setUint(&fields.nonce, 0x7f);
+    setUint(&fields.value, 0x80);
+    fields.data = &high;
+    fields.dataLength = 1;
+    checkTemplate("template data 0x80", &fields);
+
+    // the integers with a leading zero are not minimal; they are refused
+    run_t run;
+    operaTransfer(&fields);
+    HARNESS_CHECK(uploadTemplate(&fields) == 0, "template upload failed");
+    setBytes(&fields.nonce, (const uint8_t[]) {0x00, 0x07}, 2);
+    HARNESS_CHECK(templateRun(&fields, &run) == ERR_INVALID_DATA, "zero prefixed nonce accepted");
+    setBytes(&fields.nonce, (const uint8_t[]) {0x00}, 1);
+    HARNESS_CHECK(templateRun(&fields, &run) == ERR_INVALID_DATA, "zero byte nonce accepted");
+    setUint(&fields.nonce, 7);
+    setBytes(&fields.value, (const uint8_t[]) {0x00, 0x01}, 2);
+    HARNESS_CHECK(templateRun(&fields, &run) == ERR_INVALID_DATA, "zero prefixed value accepted");
+    setBytes(&fields.gasPrice, (const uint8_t[]) {0x00, 0x01}, 2);
+    HARNESS_CHECK(uploadTemplate(&fields) == ERR_INVALID_DATA, "zero prefixed gas price accepted");
+}
+
+// report implements printing the throughput of the chunking strategies.
+static void report() {
+    printf("%-20s %10s %12s %14s %12s\n", "strategy", "runs", "chunks", "bytes", "MB/s");
+    for (int i = 0; i < STRATEGY_COUNT; i++) {
+        const strategy_t *strategy = &strategies[i];
+        double seconds = (double) strategy->ns / 1e9;
+        double throughput = (seconds > 0) ? (double) strategy->bytes / seconds / 1e6 : 0;
+        printf("%-20s %10" PRIu64 " %12" PRIu64 " %14" PRIu64 " %12.2f\n", strategy->name, strategy->runs,
+               strategy->chunks, strategy->bytes, throughput);
+    }
+}
+
+int main(int argc, char **argv) {
+    uint64_t iterations = HARNESS_DEFAULT_ITERATIONS;
+    uint64_t seed = 1;
+
+    buildCorpus();
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (argv[i][0] != '-') {
+            if (!loadFile(argv[i])) {
+                return 2;
+            }
+        } else {
+            fprintf(stderr, "usage: tx_stream_harness [--iterations N] [--seed S] [file...]\n");
+            return 2;
+        }
+    }
+
+    harnessSeed(seed);
+    buildRandomCorpus(HARNESS_RANDOM_TX_COUNT);
+    checkKeccak();
+
+    for (size_t i = 0; i < corpusCount; i++) {
+        sweepEntry(&corpus[i], iterations);
+    }
+    checkTemplates();
+    report();
+
+    for (size_t i = 0; i < corpusCount; i++) {
+        free(corpus[i].rlp);
+    }
+
+    printf("tx_stream: %zu transactions, %" PRIu64 " checks, %d failed, seed %" PRIu64 "\n", corpusCount,
+           harnessChecks, harnessFailures, seed);
+    return (harnessFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,623 @@
+/**
+ * Implements the differential harness of the uint256 module.
+ *
+ * Every public function of uint256.h is checked against the reference big numbers
+ * on edge case and random operands. The benchmark mode reports the time per operation
+ * of the functions used by the amount formatting, so the backends can be compared.
+ *
+ * Usage:
+ *   uint256_harness [--iterations N] [--seed S] [--bench]
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "harness.h"
+#include "bigint_ref.h"
+#include "utils.h"
+#include "errors.h"
+#include "uint256.h"
+
+// HARNESS_DEFAULT_ITERATIONS defines the default number of random operand pairs per width.
+#define HARNESS_DEFAULT_ITERATIONS 4000
+
+// HARNESS_MAX_EDGES defines how many edge case operands we keep.
+#define HARNESS_MAX_EDGES 1024
+
+// HARNESS_BENCH_OPERANDS defines the number of operands the benchmark cycles through.
+#define HARNESS_BENCH_OPERANDS 1024
+
+// HARNESS_STRING_SIZE defines the size of the string buffers; the base 2 form of 256 bits fits.
+#define HARNESS_STRING_SIZE 300
+
+// edges keeps the edge case operands of the width being checked
+static ref_t edges[HARNESS_MAX_EDGES];
+
+// edgeCount keeps the number of edge case operands
+static size_t edgeCount = 0;
+
+// toRef128 implements conversion of the 128 bit number to the reference.
+static void toRef128(const uint128_t *number, ref_t *out) {
+    refZero(out);
+    out->limbs[0] = (uint32_t) LOWER_P(number);
+    out->limbs[1] = (uint32_t) (LOWER_P(number) >> 32);
+    out->limbs[2] = (uint32_t) UPPER_P(number);
+    out->limbs[3] = (uint32_t) (UPPER_P(number) >> 32);
+}
+
+// fromRef128 implements conversion of the reference to the 128 bit number; the low bits only.
+static void fromRef128(const ref_t *number, uint128_t *out) {
+    LOWER_P(out) = ((uint64_t) number->limbs[1] << 32) | number->limbs[0];
+    UPPER_P(out) = ((uint64_t) number->limbs[3] << 32) | number->limbs[2];
+}
+
+// toRef256 implements conversion of the 256 bit number to the reference.
+static void toRef256(const uint256_t *number, ref_t *out) {
+    ref_t upper;
+    toRef128(&LOWER_P(number), out);
+    toRef128(&UPPER_P(number), &upper);
+    memcpy(out->limbs + 4, upper.limbs, 4 * sizeof(uint32_t));
+}
+
+// fromRef256 implements conversion of the reference to the 256 bit number; the low bits only.
+static void fromRef256(const ref_t *number, uint256_t *out) {
+    ref_t upper;
+    refShiftRight(number, 128, &upper);
+    fromRef128(number, &LOWER_P(out));
+    fromRef128(&upper, &UPPER_P(out));
+}
+
+// hex implements the hex form of the reference for the failure messages; a few buffers rotate.
+static const char *hex(const ref_t *number) {
+    static char buffers[4][2 * 4 * REF_LIMBS + 3];
+    static int next = 0;
+    char *out = buffers[next];
+    next = (next + 1) % 4;
+
+    out[0] = '0';
+    out[1] = 'x';
+    refToString(number, 16, out + 2, sizeof(buffers[0]) - 2);
+    return out;
+}
+
+// addEdge implements adding the edge case operand truncated to the width.
+static void addEdge(const ref_t *number, uint32_t width) {
+    if (edgeCount < HARNESS_MAX_EDGES) {
+        edges[edgeCount] = *number;
+        refTruncate(&edges[edgeCount], width);
+        edgeCount++;
+    }
+}
+
+// buildEdges implements the edge case operands of the width;
+// zero, one, max, powers of two and their neighbours, and the powers of ten around 10^18.
+static void buildEdges(uint32_t width) {
+    ref_t one;
+    ref_t value;
+    ref_t max;
+    refFromU64(&one, 1);
+    edgeCount = 0;
+
+    refZero(&value);
+    addEdge(&value, width);
+    addEdge(&one, width);
+
+    refShiftLeft(&one, width, &max);
+    refSub(&max, &one, &max);
+    addEdge(&max, width);
+    refSub(&max, &one, &value);
+    addEdge(&value, width);
+
+    for (uint32_t bit = 1; bit < width; bit++) {
+        ref_t power;
+        refShiftLeft(&one, bit, &power);
+        addEdge(&power, width);
+        refSub(&power, &one, &value);
+        addEdge(&value, width);
+        refAdd(&power, &one, &value);
+        addEdge(&value, width);
+    }
+
+    // the powers of ten while they fit; 10^18 is one FTM in WEI
+    ref_t ten;
+    ref_t power;
+    refFromU64(&ten, 10);
+    refFromU64(&power, 1);
+    while (refBits(&power) <= width) {
+        addEdge(&power, width);
+        refSub(&power, &one, &value);
+        addEdge(&value, width);
+        refAdd(&power, &one, &value);
+        addEdge(&value, width);
+        refMul(&power, &ten, &power);
+    }
+
+    // the multiples of 10^18; typical amounts
+    ref_t wei;
+    refFromU64(&wei, 1000000000000000000u);
+    for (uint64_t i = 2; i < 1u << 20; i *= 7) {
+        ref_t factor;
+        refFromU64(&factor, i);
+        refMul(&wei, &factor, &value);
+        addEdge(&value, width);
+    }
+}
+
+// randomOperand implements an operand of the width; a mix of edge cases and random shapes.
+static void randomOperand(ref_t *out, uint32_t width) {
+    refZero(out);
+    switch (harnessRandom() % 6) {
+        case 0:
+            *out = edges[harnessRandom() % edgeCount];
+            return;
+        case 1: {
+            // runs of ones and zeros
+            uint32_t bit = 0;
+            bool isOne = (harnessRandom() & 1) != 0;
+            while (bit < width) {
+                uint32_t run = 1 + (uint32_t) (harnessRandom() % 48);
+                for (uint32_t i = bit; isOne && i < bit + run && i < width; i++) {
+                    out->limbs[i / 32] |= 1u << (i % 32);
+                }
+                bit += run;
+                isOne = !isOne;
+            }
+            return;
+        }
+        case 2:
+            // small values
+            refFromU64(out, harnessRandom() >> (harnessRandom() % 64));
+            return;
+        default:
+            // random value of a random bit length
+            for (int i = 0; i < REF_LIMBS; i++) {
+                out->limbs[i] = (uint32_t) harnessRandom();
+            }
+            refTruncate(out, 1 + (uint32_t) (harnessRandom() % width));
+            return;
+    }
+}
+
+// expect128 implements comparison of the 128 bit result with the reference.
+static void expect128(const char *op, const uint128_t *actual, const ref_t *expected,
+                      const ref_t *a, const ref_t *b) {
+    ref_t value;
+    ref_t truncated = *expected;
+    toRef128(actual, &value);
+    refTruncate(&truncated, 128);
+    HARNESS_CHECK(refCompare(&value, &truncated) == 0, "%s(%s, %s) = %s, expected %s",
+                  op, hex(a), hex(b), hex(&value), hex(&truncated));
+}
+
+// expect256 implements comparison of the 256 bit result with the reference.
+static void expect256(const char *op, const uint256_t *actual, const ref_t *expected,
+                      const ref_t *a, const ref_t *b) {
+    ref_t value;
+    ref_t truncated = *expected;
+    toRef256(actual, &value);
+    refTruncate(&truncated, 256);
+    HARNESS_CHECK(refCompare(&value, &truncated) == 0, "%s(%s, %s) = %s, expected %s",
+                  op, hex(a), hex(b), hex(&value), hex(&truncated));
+}
+
+// shiftAmount implements the shift of the check; word boundaries and random values.
+static uint32_t shiftAmount(uint32_t width) {
+    static const uint32_t SHIFTS[] = {0, 1, 31, 32, 63, 64, 65, 127, 128, 129, 191, 192, 255, 256, 257, 300};
+    uint64_t pick = harnessRandom() % (2 * ARRAY_LEN(SHIFTS));
+    return (pick < ARRAY_LEN(SHIFTS)) ? SHIFTS[pick] : (uint32_t) (harnessRandom() % (width + 8));
+}
+
+// check128 implements checks of all the 128 bit functions on the operands.
+static void check128(const ref_t *ra, const ref_t *rb) {
+    uint128_t a;
+    uint128_t b;
+    uint128_t out;
+    uint128_t mod;
+    ref_t expected;
+    ref_t expectedMod;
+    ref_t shift;
+    fromRef128(ra, &a);
+    fromRef128(rb, &b);
+
+    HARNESS_CHECK(isZero128(&a) == refIsZero(ra), "isZero128(%s)", hex(ra));
+    HARNESS_CHECK(bits128(&a) == refBits(ra), "bits128(%s) = %u", hex(ra), bits128(&a));
+    HARNESS_CHECK(equal128(&a, &b) == (refCompare(ra, rb) == 0), "equal128(%s, %s)", hex(ra), hex(rb));
+    HARNESS_CHECK(gt128(&a, &b) == (refCompare(ra, rb) > 0), "gt128(%s, %s)", hex(ra), hex(rb));
+    HARNESS_CHECK(gte128(&a, &b) == (refCompare(ra, rb) >= 0), "gte128(%s, %s)", hex(ra), hex(rb));
+    HARNESS_CHECK(equal128(&a, &a) && gte128(&a, &a) && !gt128(&a, &a), "self compare128(%s)", hex(ra));
+
+    copy128(&out, &a);
+    expect128("copy128", &out, ra, ra, ra);
+    clear128(&out);
+    refZero(&expected);
+    expect128("clear128", &out, &expected, ra, ra);
+
+    refAdd(ra, rb, &expected);
+    add128(&a, &b, &out);
+    expect128("add128", &out, &expected, ra, rb);
+
+    refSub(ra, rb, &expected);
+    minus128(&a, &b, &out);
+    expect128("minus128", &out, &expected, ra, rb);
+
+    refOr(ra, rb, &expected);
+    or128(&a, &b, &out);
+    expect128("or128", &out, &expected, ra, rb);
+
+    refMul(ra, rb, &expected);
+    mul128(&a, &b, &out);
+    expect128("mul128", &out, &expected, ra, rb);
+
+    // in place; the target is the first operand
+    out = a;
+    mul128(&out, &b, &out);
+    expect128("mul128 in place", &out, &expected, ra, rb);
+
+    uint32_t bits = shiftAmount(128);
+    refFromU64(&shift, bits);
+    refShiftLeft(ra, bits, &expected);
+    shiftLeft128(&a, bits, &out);
+    expect128("shiftLeft128", &out, &expected, ra, &shift);
+    refShiftRight(ra, bits, &expected);
+    out = a;
+    shiftRight128(&out, bits, &out);
+    expect128("shiftRight128 in place", &out, &expected, ra, &shift);
+
+    // the division by zero does not terminate; the callers never divide by zero
+    if (!refIsZero(rb)) {
+        refDivMod(ra, rb, &expected, &expectedMod);
+        divMod128(&a, &b, &out, &mod);
+        expect128("divMod128 div", &out, &expected, ra, rb);
+        expect128("divMod128 mod", &mod, &expectedMod, ra, rb);
+    }
+}
+
+// checkToString implements checks of the textual form of the 256 bit number.
+// The conversion is slow, so it is checked once per operand rather than per operand pair.
+static void checkToString(const ref_t *ra) {
+    uint256_t a;
+    fromRef256(ra, &a);
+
+    uint32_t base = (harnessRandom() % 2 == 0) ? 10 : 2 + (uint32_t) (harnessRandom() % 15);
+
+    char expected[HARNESS_STRING_SIZE];
+    size_t expectedLength = refToString(ra, base, expected, sizeof(expected));
+
+    // enough space
+    char out[HARNESS_STRING_SIZE + 1];
+    uint256_t number = a;
+    size_t length = uint256ToString(&number, base, out, HARNESS_STRING_SIZE);
+    HARNESS_CHECK(length == expectedLength && strcmp(out, expected) == 0,
+                  "uint256ToString(%s, %u) = %s, expected %s", hex(ra), base, out, expected);
+
+    // exact fit; the digits and the terminator
+    memset(out, '#', sizeof(out));
+    length = uint256ToString(&number, base, out, expectedLength + 1);
+    HARNESS_CHECK(length == expectedLength && strcmp(out, expected) == 0 && out[expectedLength + 1] == '#',
+                  "uint256ToString(%s, %u) exact fit", hex(ra), base);
+
+    // one byte short; nothing is written past the buffer
+    memset(out, '#', sizeof(out));
+    length = uint256ToString(&number, base, out, expectedLength);
+    HARNESS_CHECK(length == 0 && out[expectedLength] == '#',
+                  "uint256ToString(%s, %u) short buffer", hex(ra), base);
+}
+
+// check256 implements checks of all the 256 bit functions on the operands.
+static void check256(const ref_t *ra, const ref_t *rb) {
+    uint256_t a;
+    uint256_t b;
+    uint256_t out;
+    uint256_t mod;
+    ref_t expected;
+    ref_t expectedMod;
+    ref_t shift;
+    fromRef256(ra, &a);
+    fromRef256(rb, &b);
+
+    HARNESS_CHECK(isZero256(&a) == refIsZero(ra), "isZero256(%s)", hex(ra));
+    HARNESS_CHECK(bits256(&a) == refBits(ra), "bits256(%s) = %u", hex(ra), bits256(&a));
+    HARNESS_CHECK(equal256(&a, &b) == (refCompare(ra, rb) == 0), "equal256(%s, %s)", hex(ra), hex(rb));
+    HARNESS_CHECK(gt256(&a, &b) == (refCompare(ra, rb) > 0), "gt256(%s, %s)", hex(ra), hex(rb));
+    HARNESS_CHECK(gte256(&a, &b) == (refCompare(ra, rb) >= 0), "gte256(%s, %s)", hex(ra), hex(rb));
+    HARNESS_CHECK(equal256(&a, &a) && gte256(&a, &a) && !gt256(&a, &a), "self compare256(%s)", hex(ra));
+
+    copy256(&out, &a);
+    expect256("copy256", &out, ra, ra, ra);
+    clear256(&out);
+    refZero(&expected);
+    expect256("clear256", &out, &expected, ra, ra);
+
+    refAdd(ra, rb, &expected);
+    add256(&a, &b, &out);
+    expect256("add256", &out, &expected, ra, rb);
+    out = a;
+    add256(&out, &b, &out);
+    expect256("add256 in place", &out, &expected, ra, rb);
+
+    refSub(ra, rb, &expected);
+    minus256(&a, &b, &out);
+    expect256("minus256", &out, &expected, ra, rb);
+    out = a;
+    minus256(&out, &b, &out);
+    expect256("minus256 in place", &out, &expected, ra, rb);
+
+    refOr(ra, rb, &expected);
+    or256(&a, &b, &out);
+    expect256("or256", &out, &expected, ra, rb);
+
+    refMul(ra, rb, &expected);
+    mul256(&a, &b, &out);
+    expect256("mul256", &out, &expected, ra, rb);
+    out = a;
+    mul256(&out, &b, &out);
+    expect256("mul256 in place", &out, &expected, ra, rb);
+
+    uint32_t bits = shiftAmount(256);
+    refFromU64(&shift, bits);
+    refShiftLeft(ra, bits, &expected);
+    shiftLeft256(&a, bits, &out);
+    expect256("shiftLeft256", &out, &expected, ra, &shift);
+    out = a;
+    shiftLeft256(&out, bits, &out);
+    expect256("shiftLeft256 in place", &out, &expected, ra, &shift);
+    refShiftRight(ra, bits, &expected);
+    shiftRight256(&a, bits, &out);
+    expect256("shiftRight256", &out, &expected, ra, &shift);
+    out = a;
+    shiftRight256(&out, bits, &out);
+    expect256("shiftRight256 in place", &out, &expected, ra, &shift);
+
+    if (!refIsZero(rb)) {
+        refDivMod(ra, rb, &expected, &expectedMod);
+        divMod256(&a, &b, &out, &mod);
+        expect256("divMod256 div", &out, &expected, ra, rb);
+        expect256("divMod256 mod", &mod, &expectedMod, ra, rb);
+
+        // in place the way the string conversion calls it
+        out = a;
+        divMod256(&out, &b, &out, &mod);
+        expect256("divMod256 in place div", &out, &expected, ra, rb);
+        expect256("divMod256 in place mod", &mod, &expectedMod, ra, rb);
+    }
+}
+
+// conversion_args_t declares the arguments of the conversion running under harnessTry.
+typedef struct {
+    int kind;
+    const uint8_t *data;
+    size_t length;
+    uint32_t base;
+    uint256_t out;
+    uint128_t out128;
+} conversion_args_t;
+
+// runConversion implements the conversion call; it may throw.
+static void runConversion(void *arg) {
+    conversion_args_t *args = arg;
+    char str[HARNESS_STRING_SIZE];
+    switch (args->kind) {
+        case 0:
+            uint256ConvertBE(&args->out, args->data, args->length);
+            break;
+        case 1:
+            readUint128BE(&args->out128, args->data, args->length);
+            break;
+        case 2:
+            readUint256BE(&args->out, args->data, args->length);
+            break;
+        default:
+            uint256ToString(&args->out, args->base, str, sizeof(str));
+            break;
+    }
+}
+
+// checkConversions implements checks of the big endian conversions and the argument validation.
+static void checkConversions(uint64_t iterations) {
+    uint8_t data[40];
+    for (uint64_t i = 0; i < iterations; i++) {
+        for (size_t j = 0; j < sizeof(data); j++) {
+            data[j] = (uint8_t) harnessRandom();
+        }
+        size_t length = (size_t) (harnessRandom() % 33);
+
+        ref_t expected;
+        ref_t actual;
+        refFromBE(&expected, data, length);
+        conversion_args_t args = {.kind = 0, .data = data, .length = length};
+        HARNESS_CHECK(harnessTry(runConversion, &args) == 0, "uint256ConvertBE(%zu bytes) throws", length);
+        toRef256(&args.out, &actual);
+        HARNESS_CHECK(refCompare(&actual, &expected) == 0, "uint256ConvertBE(%zu bytes) = %s, expected %s",
+                      length, hex(&actual), hex(&expected));
+
+        // the reads take the leading bytes of a longer buffer
+        refFromBE(&expected, data, 32);
+        args = (conversion_args_t) {.kind = 2, .data = data, .length = 32 + length % 8};
+        HARNESS_CHECK(harnessTry(runConversion, &args) == 0, "readUint256BE throws");
+        toRef256(&args.out, &actual);
+        HARNESS_CHECK(refCompare(&actual, &expected) == 0, "readUint256BE = %s, expected %s",
+                      hex(&actual), hex(&expected));
+
+        refFromBE(&expected, data, 16);
+        args = (conversion_args_t) {.kind = 1, .data = data, .length = 16 + length % 8};
+        HARNESS_CHECK(harnessTry(runConversion, &args) == 0, "readUint128BE throws");
+        toRef128(&args.out128, &actual);
+        HARNESS_CHECK(refCompare(&actual, &expected) == 0, "readUint128BE = %s, expected %s",
+                      hex(&actual), hex(&expected));
+    }
+
+    // invalid arguments
+    const struct {
+        int kind;
+        size_t length;
+        uint32_t base;
+    } INVALID[] = {{0, 33, 0}, {1, 15, 0}, {2, 31, 0}, {3, 0, 0}, {3, 0, 1}, {3, 0, 17}};
+    for (size_t i = 0; i < ARRAY_LEN(INVALID); i++) {
+        conversion_args_t args = {.kind = INVALID[i].kind, .data = data, .length = INVALID[i].length,
+                                  .base = INVALID[i].base};
+        HARNESS_CHECK(harnessTry(runConversion, &args) == ERR_FAULT, "invalid argument %zu accepted", i);
+    }
+}
+
+// checkWidth implements the edge case and random checks of the width.
+static void checkWidth(uint32_t width, uint64_t iterations) {
+    void (*check)(const ref_t *, const ref_t *) = (width == 128) ? check128 : check256;
+    buildEdges(width);
+
+    // each edge case against the most interesting ones
+    ref_t partners[8];
+    size_t partnerCount = 0;
+    for (size_t i = 0; i < 4; i++) {
+        partners[partnerCount++] = edges[i];
+    }
+    for (size_t i = 0; i < 4; i++) {
+        randomOperand(&partners[partnerCount++], width);
+    }
+    for (size_t i = 0; i < edgeCount; i++) {
+        for (size_t j = 0; j < partnerCount; j++) {
+            check(&edges[i], &partners[j]);
+            check(&partners[j], &edges[i]);
+        }
+        if (width == 256) {
+            checkToString(&edges[i]);
+        }
+    }
+
+    for (uint64_t i = 0; i < iterations; i++) {
+        ref_t a;
+        ref_t b;
+        randomOperand(&a, width);
+        randomOperand(&b, width);
+        check(&a, &b);
+        if (width == 256) {
+            checkToString(&a);
+        }
+    }
+}
+
+// benchOperands implements the benchmark operands of the bit length range.
+static void benchOperands(uint256_t *operands, uint32_t minBits, uint32_t maxBits) {
+    for (size_t i = 0; i < HARNESS_BENCH_OPERANDS; i++) {
+        ref_t value;
+        for (int j = 0; j < REF_LIMBS; j++) {
+            value.limbs[j] = (uint32_t) harnessRandom();
+        }
+        refTruncate(&value, minBits + (uint32_t) (harnessRandom() % (maxBits - minBits + 1)));
+        if (refIsZero(&value)) {
+            refFromU64(&value, 1);
+        }
+        fromRef256(&value, &operands[i]);
+    }
+}
+
+// benchReport implements printing the time per operation.
+static void benchReport(const char *label, uint64_t startNs, uint64_t operations) {
+    double ns = (double) (harnessNowNs() - startNs) / (double) operations;
+    printf("%-36s %10.1f ns/op\n", label, ns);
+}
+
+// bench implements the benchmark of the functions used by the amount formatting.
+static void bench(uint64_t operations) {
+    uint256_t *left = malloc(2 * HARNESS_BENCH_OPERANDS * sizeof(uint256_t));
+    uint256_t *right = left + HARNESS_BENCH_OPERANDS;
+    volatile uint64_t sink = 0;
+    uint256_t out;
+    uint256_t mod;
+    char str[HARNESS_STRING_SIZE];
+
+    // amounts are about 10^18 to 10^27 WEI, gas prices and limits are much smaller
+    const struct {
+        const char *label;
+        uint32_t leftMin, leftMax, rightMin, rightMax;
+    } MUL_SETS[] = {
+            {"mul256 gas price x gas limit", 30, 40, 14, 24},
+            {"mul256 full x full", 200, 256, 200, 256},
+    };
+    for (size_t s = 0; s < ARRAY_LEN(MUL_SETS); s++) {
+        benchOperands(left, MUL_SETS[s].leftMin, MUL_SETS[s].leftMax);
+        benchOperands(right, MUL_SETS[s].rightMin, MUL_SETS[s].rightMax);
+        uint64_t start = harnessNowNs();
+        for (uint64_t i = 0; i < operations; i++) {
+            mul256(&left[i % HARNESS_BENCH_OPERANDS], &right[(i * 7) % HARNESS_BENCH_OPERANDS], &out);
+            sink += LOWER(LOWER(out));
+        }
+        benchReport(MUL_SETS[s].label, start, operations);
+    }
+
+    const struct {
+        const char *label;
+        uint32_t leftMin, leftMax, rightMin, rightMax;
+    } DIV_SETS[] = {
+            {"divMod256 amount / 10", 60, 90, 4, 4},
+            {"divMod256 full / 64 bit", 200, 256, 40, 64},
+            {"divMod256 full / full", 200, 256, 150, 256},
+    };
+    for (size_t s = 0; s < ARRAY_LEN(DIV_SETS); s++) {
+        benchOperands(left, DIV_SETS[s].leftMin, DIV_SETS[s].leftMax);
+        benchOperands(right, DIV_SETS[s].rightMin, DIV_SETS[s].rightMax);
+        if (DIV_SETS[s].rightMax == 4) {
+            for (size_t i = 0; i < HARNESS_BENCH_OPERANDS; i++) {
+                clear256(&right[i]);
+                LOWER(LOWER(right[i])) = 10;
+            }
+        }
+        uint64_t start = harnessNowNs();
+        for (uint64_t i = 0; i < operations; i++) {
+            divMod256(&left[i % HARNESS_BENCH_OPERANDS], &right[(i * 7) % HARNESS_BENCH_OPERANDS], &out, &mod);
+            sink += LOWER(LOWER(mod));
+        }
+        benchReport(DIV_SETS[s].label, start, operations);
+    }
+
+    const struct {
+        const char *label;
+        uint32_t minBits, maxBits;
+    } STRING_SETS[] = {
+            {"uint256ToString amount base 10", 60, 90},
+            {"uint256ToString full base 10", 250, 256},
+    };
+    for (size_t s = 0; s < ARRAY_LEN(STRING_SETS); s++) {
+        benchOperands(left, STRING_SETS[s].minBits, STRING_SETS[s].maxBits);
+        uint64_t start = harnessNowNs();
+        uint64_t count = operations / 16;
+        for (uint64_t i = 0; i < count; i++) {
+            sink += uint256ToString(&left[i % HARNESS_BENCH_OPERANDS], 10, str, sizeof(str));
+        }
+        benchReport(STRING_SETS[s].label, start, count);
+    }
+
+    free(left);
+    (void) sink;
+}
+
+int main(int argc, char **argv) {
+    uint64_t iterations = HARNESS_DEFAULT_ITERATIONS;
+    uint64_t seed = 1;
+    bool isBench = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(argv[i], "--bench") == 0) {
+            isBench = true;
+        } else {
+            fprintf(stderr, "usage: uint256_harness [--iterations N] [--seed S] [--bench]\n");
+            return 2;
+        }
+    }
+
+    harnessSeed(seed);
+    if (isBench) {
+        bench(iterations * 50);
+        return 0;
+    }
+
+    checkWidth(128, iterations);
+    checkWidth(256, iterations);
+    checkConversions(iterations / 10);
+
+    printf("uint256: %" PRIu64 " checks, %d failed, seed %" PRIu64 "\n", harnessChecks, harnessFailures, seed);
+    return (harnessFailures == 0) ? 0 : 1;
+}
@@ -0,0 +1,9 @@
+#ifndef FANTOM_HARNESS_UX_H
+#define FANTOM_HARNESS_UX_H
+
+/**
+ * Stands in for the SDK ux.h; only the types the app io.h refers to are declared.
+ */
+typedef struct bagl_element_e bagl_element_t;
+
+#endif //FANTOM_HARNESS_UX_H
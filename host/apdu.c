@@ -0,0 +1,67 @@
+/**
+ * Implements the APDU request and response coding of the Fantom Ledger App.
+ * See doc/app_design.md for the communication protocol details.
+ */
+#include <string.h>
+
+#include "host_errors.h"
+#include "apdu.h"
+
+// APDU_MAX_PATH_DEPTH defines the max number of BIP32 derivations the app accepts.
+#define APDU_MAX_PATH_DEPTH 10
+
+// apduBuild implements building a request APDU into the output buffer.
+int apduBuild(
+        uint8_t ins, uint8_t p1, uint8_t p2,
+        const uint8_t *data, size_t dataLength,
+        uint8_t *out, size_t outSize
+) {
+    // the payload length must fit the single byte Lc
+    if (dataLength > APDU_MAX_DATA || (dataLength > 0 && data == NULL)) {
+        return HOST_ERR_PARAMETERS;
+    }
+    if (outSize < APDU_HEADER_SIZE + dataLength) {
+        return HOST_ERR_BUFFER;
+    }
+
+    out[0] = APDU_CLA;
+    out[1] = ins;
+    out[2] = p1;
+    out[3] = p2;
+    out[4] = (uint8_t) dataLength;
+    if (dataLength > 0) {
+        memcpy(out + APDU_HEADER_SIZE, data, dataLength);
+    }
+    return (int) (APDU_HEADER_SIZE + dataLength);
+}
+
+// apduStatus implements reading the status word from the end of a response.
+int apduStatus(const uint8_t *response, size_t *responseLength, uint16_t *status) {
+    // each response is closed by the status word
+    if (*responseLength < APDU_STATUS_SIZE) {
+        return HOST_ERR_PROTOCOL;
+    }
+
+    *responseLength -= APDU_STATUS_SIZE;
+    *status = (uint16_t) ((response[*responseLength] << 8) | response[*responseLength + 1]);
+    return HOST_OK;
+}
+
+// apduWritePath implements encoding of a BIP32 path the way the instructions expect it.
+int apduWritePath(const uint32_t *path, size_t depth, uint8_t *out, size_t outSize) {
+    if (depth == 0 || depth > APDU_MAX_PATH_DEPTH) {
+        return HOST_ERR_PARAMETERS;
+    }
+    if (outSize < 1 + 4 * depth) {
+        return HOST_ERR_BUFFER;
+    }
+
+    out[0] = (uint8_t) depth;
+    for (size_t i = 0; i < depth; i++) {
+        out[1 + 4 * i] = (uint8_t) (path[i] >> 24);
+        out[2 + 4 * i] = (uint8_t) (path[i] >> 16);
+        out[3 + 4 * i] = (uint8_t) (path[i] >> 8);
+        out[4 + 4 * i] = (uint8_t) path[i];
+    }
+    return (int) (1 + 4 * depth);
+}
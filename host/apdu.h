@@ -0,0 +1,38 @@
+#ifndef FANTOM_HOST_APDU_H
+#define FANTOM_HOST_APDU_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// APDU_CLA defines the fixed service class of the application.
+#define APDU_CLA 0xE0
+
+// APDU_HEADER_SIZE defines the size of the request header; CLA, INS, P1, P2, and Lc.
+#define APDU_HEADER_SIZE 5
+
+// APDU_MAX_DATA defines the max request payload size; the Lc is a single byte.
+#define APDU_MAX_DATA 255
+
+// APDU_STATUS_SIZE defines the size of the status word closing each response.
+#define APDU_STATUS_SIZE 2
+
+// APDU_MAX_RESPONSE defines the max size of a response including the status word.
+#define APDU_MAX_RESPONSE (256 + APDU_STATUS_SIZE)
+
+// apduBuild implements building a request APDU into the output buffer.
+// Returns the size of the request, or a negative host error code.
+int apduBuild(
+        uint8_t ins, uint8_t p1, uint8_t p2,
+        const uint8_t *data, size_t dataLength,
+        uint8_t *out, size_t outSize);
+
+// apduStatus implements reading the status word from the end of a response.
+// The status word is removed from the response length.
+int apduStatus(const uint8_t *response, size_t *responseLength, uint16_t *status);
+
+// apduWritePath implements encoding of a BIP32 path the way the instructions expect it;
+// number of derivations followed by big endian derivation indexes.
+// Returns the size of the encoded path, or a negative host error code.
+int apduWritePath(const uint32_t *path, size_t depth, uint8_t *out, size_t outSize);
+
+#endif //FANTOM_HOST_APDU_H
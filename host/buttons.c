@@ -0,0 +1,104 @@
+/**
+ * Implements pressing the buttons of a device simulator for the scripted sessions.
+ *
+ * The simulator button port takes single characters; the upper case letter presses
+ * the button and the lower case letter releases it, e.g. "LRlr" presses both buttons.
+ */
+#include <unistd.h>
+#include <string.h>
+#include <stdio.h>
+#include <time.h>
+#include <netdb.h>
+#include <sys/socket.h>
+
+#include "host_errors.h"
+#include "trace.h"
+#include "buttons.h"
+
+// tcpPress implements the button press over the simulator button port.
+static int tcpPress(buttons_t *buttons, char button) {
+    const char *keys;
+    switch (button) {
+        case TRACE_BUTTON_LEFT:
+            keys = "Ll";
+            break;
+        case TRACE_BUTTON_RIGHT:
+            keys = "Rr";
+            break;
+        case TRACE_BUTTON_BOTH:
+            keys = "LRlr";
+            break;
+        default:
+            return HOST_ERR_PARAMETERS;
+    }
+
+    size_t length = strlen(keys);
+    return (send(buttons->fd, keys, length, MSG_NOSIGNAL) == (ssize_t) length) ? HOST_OK : HOST_ERR_IO;
+}
+
+// tcpClose implements closing the button port connection.
+static void tcpClose(buttons_t *buttons) {
+    close(buttons->fd);
+}
+
+// buttonsOpenTcp implements connecting to the button port of a device simulator.
+int buttonsOpenTcp(buttons_t *buttons, const char *host, uint16_t port, int delayMs) {
+    memset(buttons, 0, sizeof(*buttons));
+    buttons->fd = -1;
+
+    char service[8];
+    snprintf(service, sizeof(service), "%u", (unsigned) port);
+
+    struct addrinfo hints = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM};
+    struct addrinfo *list = NULL;
+    if (getaddrinfo(host, service, &hints, &list) != 0) {
+        return HOST_ERR_OPEN;
+    }
+
+    for (struct addrinfo *ai = list; ai != NULL; ai = ai->ai_next) {
+        int fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            buttons->fd = fd;
+            break;
+        }
+        close(fd);
+    }
+    freeaddrinfo(list);
+
+    if (buttons->fd < 0) {
+        return HOST_ERR_OPEN;
+    }
+
+    buttons->press = tcpPress;
+    buttons->close = tcpClose;
+    buttons->delayMs = delayMs;
+    return HOST_OK;
+}
+
+// buttonsPress implements the scripted button press; it waits the delay first.
+int buttonsPress(buttons_t *buttons, char button) {
+    if (buttons == NULL || buttons->press == NULL) {
+        return HOST_ERR_PARAMETERS;
+    }
+
+    struct timespec delay = {
+            .tv_sec = buttons->delayMs / 1000,
+            .tv_nsec = (long) (buttons->delayMs % 1000) * 1000000L
+    };
+    nanosleep(&delay, NULL);
+    return buttons->press(buttons, button);
+}
+
+// buttonsClose implements closing the buttons.
+void buttonsClose(buttons_t *buttons) {
+    if (buttons == NULL || buttons->fd < 0) {
+        return;
+    }
+    if (buttons->close != NULL) {
+        buttons->close(buttons);
+    }
+    buttons->fd = -1;
+}
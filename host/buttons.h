@@ -0,0 +1,29 @@
+#ifndef FANTOM_HOST_BUTTONS_H
+#define FANTOM_HOST_BUTTONS_H
+
+#include <stdint.h>
+
+// BUTTONS_DEFAULT_DELAY_MS defines the default pause before each scripted button press.
+// The device needs a moment to draw the next screen.
+#define BUTTONS_DEFAULT_DELAY_MS 100
+
+// buttons_t declares the device buttons driven by the scripted presses.
+typedef struct buttons_t buttons_t;
+struct buttons_t {
+    // press implements a single press and release of the button; see trace_button_t
+    int (*press)(buttons_t *buttons, char button);
+    void (*close)(buttons_t *buttons);
+    int fd;
+    int delayMs;
+};
+
+// buttonsOpenTcp implements connecting to the button port of a device simulator.
+int buttonsOpenTcp(buttons_t *buttons, const char *host, uint16_t port, int delayMs);
+
+// buttonsPress implements the scripted button press; it waits the delay first.
+int buttonsPress(buttons_t *buttons, char button);
+
+// buttonsClose implements closing the buttons.
+void buttonsClose(buttons_t *buttons);
+
+#endif //FANTOM_HOST_BUTTONS_H
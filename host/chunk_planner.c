@@ -0,0 +1,263 @@
+/**
+ * Implements the planner of transaction stream chunks.
+ *
+ * The device parses the RLP stream on the fly, so any split of the data works.
+ * Some splits are cheaper than others though. An RLP header split across chunks
+ * has to be collected in the parser peek buffer and a split short field is copied
+ * in pieces. The planner keeps the number of APDU exchanges minimal and moves
+ * the chunk ends to the element boundaries where it's free to do so.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_errors.h"
+#include "chunk_planner.h"
+
+// what are the cut preferences
+enum {
+    CUT_POOR = 0,
+    CUT_FAIR = 1,
+    CUT_GOOD = 2,
+};
+
+// ZERO_RUN_MAX defines the longest zero run encoded by a single run length byte.
+#define ZERO_RUN_MAX 255
+
+// rlpReadHeader implements decoding of a single RLP element header.
+// Returns false if the header is not valid, or it exceeds the buffer.
+static bool rlpReadHeader(const uint8_t *rlp, uint32_t length, uint32_t pos,
+                          uint32_t *headerSize, uint32_t *payloadSize) {
+    if (pos >= length) {
+        return false;
+    }
+
+    uint8_t prefix = rlp[pos];
+    if (prefix < 0x80) {
+        // single byte element is its own payload
+        *headerSize = 0;
+        *payloadSize = 1;
+    } else if (prefix <= 0xB7 || (prefix >= 0xC0 && prefix <= 0xF7)) {
+        // short string, or list
+        *headerSize = 1;
+        *payloadSize = prefix - (prefix >= 0xC0 ? 0xC0 : 0x80);
+    } else {
+        // long string, or list; the length of length follows
+        uint32_t lengthSize = prefix - (prefix >= 0xF8 ? 0xF7 : 0xB7);
+        if (lengthSize > 4 || pos + 1 + lengthSize > length) {
+            return false;
+        }
+
+        *payloadSize = 0;
+        for (uint32_t i = 0; i < lengthSize; i++) {
+            *payloadSize = (*payloadSize << 8) | rlp[pos + 1 + i];
+        }
+        *headerSize = 1 + lengthSize;
+    }
+
+    return (uint64_t) pos + *headerSize + *payloadSize <= length;
+}
+
+// plannerScoreCuts implements rating of all the cut positions of the RLP data.
+// The cut at position i ends the chunk just before the byte i.
+static void plannerScoreCuts(const uint8_t *rlp, uint32_t length, uint8_t *score) {
+    // unknown structure; any cut is as good as the other
+    memset(score, CUT_FAIR, length + 1);
+
+    // the transaction is a list of elements
+    uint32_t headerSize, payloadSize;
+    if (!rlpReadHeader(rlp, length, 0, &headerSize, &payloadSize) || rlp[0] < 0xC0) {
+        return;
+    }
+    memset(score, CUT_POOR, headerSize + 1);
+
+    // rate the elements of the list
+    uint32_t pos = headerSize;
+    uint32_t end = headerSize + payloadSize;
+    while (pos < end) {
+        uint32_t elementHeader, elementPayload;
+        if (!rlpReadHeader(rlp, end, pos, &elementHeader, &elementPayload)) {
+            return;
+        }
+
+        // element start is the best place to cut; header and short payload are not
+        uint32_t next = pos + elementHeader + elementPayload;
+        score[pos] = CUT_GOOD;
+        if (elementPayload <= PLANNER_SHORT_FIELD) {
+            memset(score + pos + 1, CUT_POOR, next - pos - 1);
+        } else if (elementHeader > 1) {
+            memset(score + pos + 1, CUT_POOR, elementHeader - 1);
+        }
+        pos = next;
+    }
+    score[end] = CUT_GOOD;
+}
+
+// zeroRunLength implements measuring the zero run starting at the position, limited by the end.
+static uint32_t zeroRunLength(const uint8_t *rlp, uint32_t pos, uint32_t end) {
+    uint32_t run = 0;
+    while (pos + run < end && rlp[pos + run] == 0 && run < ZERO_RUN_MAX) {
+        run++;
+    }
+    return run;
+}
+
+// plannerMaxEnd implements finding the furthest end of a chunk starting at the position.
+static uint32_t plannerMaxEnd(const uint8_t *rlp, uint32_t length, bool isZeroRun, uint32_t pos, uint32_t *cost) {
+    uint32_t used = 0;
+    while (pos < length) {
+        uint32_t step = 1;
+        uint32_t stepCost = 1;
+        if (isZeroRun && rlp[pos] == 0) {
+            step = zeroRunLength(rlp, pos, length);
+            stepCost = 2;
+        }
+        if (used + stepCost > PLANNER_MAX_CHUNK) {
+            break;
+        }
+        used += stepCost;
+        pos += step;
+    }
+    *cost = used;
+    return pos;
+}
+
+// plannerSuffixChunks implements calculation of the number of chunks needed for every suffix of the data.
+// The suffix is split greedily; a zero run pair can not straddle the chunk end, so the encoded
+// size alone is only a lower bound of the chunks needed.
+static void plannerSuffixChunks(const uint8_t *rlp, uint32_t length, bool isZeroRun, uint32_t *chunks) {
+    chunks[length] = 0;
+    for (uint32_t i = length; i-- > 0;) {
+        uint32_t cost;
+        chunks[i] = 1 + chunks[plannerMaxEnd(rlp, length, isZeroRun, i, &cost)];
+    }
+}
+
+// plannerChunkCost implements calculation of the encoded size of a chunk.
+static uint32_t plannerChunkCost(const uint8_t *rlp, uint32_t start, uint32_t end, bool isZeroRun) {
+    if (!isZeroRun) {
+        return end - start;
+    }
+
+    uint32_t cost = 0;
+    while (start < end) {
+        if (rlp[start] == 0) {
+            start += zeroRunLength(rlp, start, end);
+            cost += 2;
+        } else {
+            start++;
+            cost++;
+        }
+    }
+    return cost;
+}
+
+// plannerPlan implements splitting the RLP encoded transaction into stream chunks.
+int plannerPlan(
+        const uint8_t *rlp, uint32_t rlpLength, bool isZeroRun,
+        planner_chunk_t *chunks, size_t maxChunks) {
+    if (rlp == NULL || rlpLength == 0 || chunks == NULL) {
+        return HOST_ERR_PARAMETERS;
+    }
+
+    uint8_t *score = malloc(rlpLength + 1);
+    uint32_t *suffix = malloc(sizeof(uint32_t) * (rlpLength + 1));
+    if (score == NULL || suffix == NULL) {
+        free(score);
+        free(suffix);
+        return HOST_ERR_BUFFER;
+    }
+    plannerScoreCuts(rlp, rlpLength, score);
+    plannerSuffixChunks(rlp, rlpLength, isZeroRun, suffix);
+
+    int count = 0;
+    uint32_t pos = 0;
+    while (pos < rlpLength) {
+        if ((size_t) count >= maxChunks) {
+            count = HOST_ERR_BUFFER;
+            break;
+        }
+
+        // how far can we get with this chunk
+        uint32_t cost;
+        uint32_t end = plannerMaxEnd(rlp, rlpLength, isZeroRun, pos, &cost);
+
+        // look for a better cut which does not need an extra chunk for the rest of the data
+        if (end < rlpLength) {
+            uint32_t needed = suffix[end];
+            uint32_t best = end;
+            uint32_t limit = (end - pos > PLANNER_MAX_BACKOFF) ? end - PLANNER_MAX_BACKOFF : pos + 1;
+            for (uint32_t cut = end; cut >= limit && cut > pos; cut--) {
+                if (score[cut] > score[best] && suffix[cut] <= needed) {
+                    best = cut;
+                }
+            }
+            if (best != end) {
+                end = best;
+                cost = plannerChunkCost(rlp, pos, end, isZeroRun);
+            }
+        }
+
+        chunks[count].offset = pos;
+        chunks[count].length = end - pos;
+        chunks[count].encodedLength = cost;
+        count++;
+        pos = end;
+    }
+
+    free(score);
+    free(suffix);
+    return count;
+}
+
+// plannerEncode implements building the wire payload of a planned chunk.
+int plannerEncode(
+        const uint8_t *rlp, const planner_chunk_t *chunk, bool isZeroRun,
+        uint8_t *out, size_t outSize) {
+    if (chunk->encodedLength > outSize) {
+        return HOST_ERR_BUFFER;
+    }
+
+    // raw chunk is just the slice of the data
+    const uint8_t *in = rlp + chunk->offset;
+    if (!isZeroRun) {
+        memcpy(out, in, chunk->length);
+        return (int) chunk->length;
+    }
+
+    // zero is followed by the run length, everything else is taken as is
+    size_t used = 0;
+    uint32_t pos = 0;
+    while (pos < chunk->length) {
+        if (in[pos] == 0) {
+            uint32_t run = zeroRunLength(in, pos, chunk->length);
+            out[used++] = 0;
+            out[used++] = (uint8_t) run;
+            pos += run;
+        } else {
+            out[used++] = in[pos++];
+        }
+    }
+    return (int) used;
+}
+
+// plannerDecodeZeroRun implements expanding zero-run compressed payload the way the device does.
+int plannerDecodeZeroRun(const uint8_t *in, size_t inLength, uint8_t *out, size_t outSize) {
+    size_t used = 0;
+    for (size_t i = 0; i < inLength; i++) {
+        size_t run = 1;
+        uint8_t value = in[i];
+        if (value == 0) {
+            // the run length must follow in the same chunk and can not be zero
+            if (i + 1 >= inLength || in[i + 1] == 0) {
+                return HOST_ERR_PROTOCOL;
+            }
+            run = in[++i];
+        }
+        if (used + run > outSize) {
+            return HOST_ERR_BUFFER;
+        }
+        memset(out + used, value, run);
+        used += run;
+    }
+    return (int) used;
+}
@@ -0,0 +1,44 @@
+#ifndef FANTOM_HOST_CHUNK_PLANNER_H
+#define FANTOM_HOST_CHUNK_PLANNER_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// PLANNER_MAX_CHUNK defines the max size of a chunk on the wire; the Lc is a single byte.
+#define PLANNER_MAX_CHUNK 255
+
+// PLANNER_MAX_BACKOFF defines how many bytes a chunk may give up to end on a better boundary.
+#define PLANNER_MAX_BACKOFF 32
+
+// PLANNER_SHORT_FIELD defines the max payload size of a field we prefer not to split.
+// It covers the nonce, gas, recipient and value fields of a transaction.
+#define PLANNER_SHORT_FIELD 32
+
+// planner_chunk_t declares a single chunk of the planned transaction stream.
+typedef struct {
+    uint32_t offset;
+    uint32_t length;
+    uint32_t encodedLength;
+} planner_chunk_t;
+
+// plannerPlan implements splitting the RLP encoded transaction into stream chunks.
+// The chunk count is kept minimal, but a chunk is ended early on an RLP element boundary
+// if it does not cost an extra chunk, so the device does not have to collect RLP headers
+// and short fields across chunks. The zero-run compression is applied if requested.
+// Returns the number of chunks, or a negative host error code.
+int plannerPlan(
+        const uint8_t *rlp, uint32_t rlpLength, bool isZeroRun,
+        planner_chunk_t *chunks, size_t maxChunks);
+
+// plannerEncode implements building the wire payload of a planned chunk.
+// Returns the size of the payload, or a negative host error code.
+int plannerEncode(
+        const uint8_t *rlp, const planner_chunk_t *chunk, bool isZeroRun,
+        uint8_t *out, size_t outSize);
+
+// plannerDecodeZeroRun implements expanding zero-run compressed payload the way the device does.
+// Returns the size of the expanded data, or a negative host error code.
+int plannerDecodeZeroRun(const uint8_t *in, size_t inLength, uint8_t *out, size_t outSize);
+
+#endif //FANTOM_HOST_CHUNK_PLANNER_H
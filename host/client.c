@@ -0,0 +1,230 @@
+/**
+ * Implements the client of the Fantom Ledger App instructions.
+ * See doc/cmd_*.md for the details of each instruction.
+ */
+#include <stdlib.h>
+#include <string.h>
+
+#include "../src/errors.h"
+#include "host_errors.h"
+#include "apdu.h"
+#include "chunk_planner.h"
+#include "client.h"
+
+// what are the Sign Transaction steps and stages we use
+enum {
+    SIGN_TX_P1_NEW = 0x00,
+    SIGN_TX_P1_STREAM = 0x01,
+    SIGN_TX_P1_GET_SIGNATURE = 0x80,
+    SIGN_TX_P2_ZERO_RUN = 0x01,
+    SIGN_TX_STAGE_COLLECT = 2,
+    SIGN_TX_STAGE_FINALIZE = 4,
+    GET_ADDR_P1_RETURN = 0x01,
+};
+
+// clientInit implements setting up the client over the opened transport.
+void clientInit(client_t *client, transport_t *transport) {
+    memset(client, 0, sizeof(*client));
+    client->transport = transport;
+}
+
+// clientExchange implements a single APDU exchange with the device.
+int clientExchange(
+        client_t *client,
+        uint8_t ins, uint8_t p1, uint8_t p2,
+        const uint8_t *data, size_t dataLength,
+        uint8_t *response, size_t responseSize, size_t *responseLength) {
+    uint8_t apdu[APDU_HEADER_SIZE + APDU_MAX_DATA];
+    int apduLength = apduBuild(ins, p1, p2, data, dataLength, apdu, sizeof(apdu));
+    if (apduLength < 0) {
+        return apduLength;
+    }
+
+    // exchange the request and measure the round trip
+    uint8_t buffer[APDU_MAX_RESPONSE];
+    size_t length = 0;
+    uint64_t start = latencyNowUs();
+    int res = transportExchange(client->transport, apdu, (size_t) apduLength, buffer, sizeof(buffer), &length);
+    latencyRecord(&client->latency[ins], latencyNowUs() - start);
+    if (res != HOST_OK) {
+        return res;
+    }
+
+    // split the status word
+    res = apduStatus(buffer, &length, &client->lastStatus);
+    if (res != HOST_OK) {
+        return res;
+    }
+    if (client->lastStatus != SUCCESS) {
+        return HOST_ERR_STATUS;
+    }
+
+    // pass the response data
+    if (length > responseSize) {
+        return HOST_ERR_BUFFER;
+    }
+    if (length > 0) {
+        memcpy(response, buffer, length);
+    }
+    *responseLength = length;
+    return HOST_OK;
+}
+
+// clientGetVersion implements the Get Application Version instruction.
+int clientGetVersion(client_t *client, client_version_t *version) {
+    uint8_t response[4];
+    size_t length;
+    int res = clientExchange(client, CLIENT_INS_VERSION, 0, 0, NULL, 0, response, sizeof(response), &length);
+    if (res != HOST_OK) {
+        return res;
+    }
+    if (length != sizeof(response)) {
+        return HOST_ERR_PROTOCOL;
+    }
+
+    version->major = response[0];
+    version->minor = response[1];
+    version->patch = response[2];
+    version->flags = response[3];
+    return HOST_OK;
+}
+
+// clientGetCapabilities implements the Get Capabilities instruction.
+int clientGetCapabilities(client_t *client, client_capabilities_t *caps) {
+    uint8_t response[12];
+    size_t length;
+    int res = clientExchange(client, CLIENT_INS_CAPABILITIES, 0, 0, NULL, 0, response, sizeof(response), &length);
+    if (res != HOST_OK) {
+        return res;
+    }
+    if (length != sizeof(response)) {
+        return HOST_ERR_PROTOCOL;
+    }
+
+    caps->features = ((uint32_t) response[0] << 24) | ((uint32_t) response[1] << 16) |
+                     ((uint32_t) response[2] << 8) | (uint32_t) response[3];
+    caps->accountsPerResponse = response[4];
+    caps->accountsMax = response[5];
+    caps->verifyPerRequest = response[6];
+    caps->chunkSize = response[7];
+    caps->signTxSlots = response[8];
+    caps->keySlots = response[9];
+    caps->signCacheSize = response[10];
+    caps->nodeCacheSize = response[11];
+    return HOST_OK;
+}
+
+// clientGetAddress implements the Get Address instruction returning the address to the host.
+int clientGetAddress(client_t *client, const uint32_t *path, size_t depth, uint8_t address[CLIENT_ADDRESS_SIZE]) {
+    uint8_t request[APDU_MAX_DATA];
+    int requestLength = apduWritePath(path, depth, request, sizeof(request));
+    if (requestLength < 0) {
+        return requestLength;
+    }
+
+    uint8_t response[1 + CLIENT_ADDRESS_SIZE];
+    size_t length;
+    int res = clientExchange(client, CLIENT_INS_GET_ADDR, GET_ADDR_P1_RETURN, 0,
+                             request, (size_t) requestLength, response, sizeof(response), &length);
+    if (res != HOST_OK) {
+        return res;
+    }
+    if (length != sizeof(response) || response[0] != CLIENT_ADDRESS_SIZE) {
+        return HOST_ERR_PROTOCOL;
+    }
+
+    memcpy(address, response + 1, CLIENT_ADDRESS_SIZE);
+    return HOST_OK;
+}
+
+// clientStreamTransaction implements streaming the planned chunks of the transaction.
+static int clientStreamTransaction(client_t *client, const uint8_t *rlp, bool isZeroRun,
+                                   const planner_chunk_t *chunks, int count) {
+    for (int i = 0; i < count; i++) {
+        uint8_t payload[PLANNER_MAX_CHUNK];
+        int payloadLength = plannerEncode(rlp, &chunks[i], isZeroRun, payload, sizeof(payload));
+        if (payloadLength < 0) {
+            return payloadLength;
+        }
+
+        uint8_t stage;
+        size_t length;
+        int res = clientExchange(client, CLIENT_INS_SIGN_TX, SIGN_TX_P1_STREAM,
+                                 isZeroRun ? SIGN_TX_P2_ZERO_RUN : 0,
+                                 payload, (size_t) payloadLength, &stage, sizeof(stage), &length);
+        if (res != HOST_OK) {
+            return res;
+        }
+
+        // the device expects more data until the last chunk
+        uint8_t expected = (i + 1 < count) ? SIGN_TX_STAGE_COLLECT : SIGN_TX_STAGE_FINALIZE;
+        if (length != sizeof(stage) || stage != expected) {
+            return HOST_ERR_PROTOCOL;
+        }
+    }
+    return HOST_OK;
+}
+
+// clientSignTransaction implements the Sign Transaction instruction.
+int clientSignTransaction(
+        client_t *client,
+        const uint32_t *path, size_t depth,
+        const uint8_t *rlp, uint32_t rlpLength, bool isZeroRun,
+        client_signature_t *signature) {
+    // plan the stream first so we don't start the signing we can not finish
+    size_t maxChunks = rlpLength / 2 + 1;
+    planner_chunk_t *chunks = malloc(sizeof(planner_chunk_t) * maxChunks);
+    if (chunks == NULL) {
+        return HOST_ERR_BUFFER;
+    }
+    int count = plannerPlan(rlp, rlpLength, isZeroRun, chunks, maxChunks);
+    if (count < 0) {
+        free(chunks);
+        return count;
+    }
+
+    // initialize the signing with the path
+    uint8_t request[APDU_MAX_DATA];
+    int res = apduWritePath(path, depth, request, sizeof(request));
+    if (res >= 0) {
+        size_t length;
+        res = clientExchange(client, CLIENT_INS_SIGN_TX, SIGN_TX_P1_NEW, 0,
+                             request, (size_t) res, NULL, 0, &length);
+    }
+
+    // stream the data
+    if (res == HOST_OK) {
+        res = clientStreamTransaction(client, rlp, isZeroRun, chunks, count);
+    }
+    free(chunks);
+
+    // ask for the signature; the user reviews the transaction in the meantime
+    if (res == HOST_OK) {
+        uint8_t response[1 + 32 + 32];
+        size_t length;
+        res = clientExchange(client, CLIENT_INS_SIGN_TX, SIGN_TX_P1_GET_SIGNATURE, 0,
+                             NULL, 0, response, sizeof(response), &length);
+        if (res == HOST_OK && length != sizeof(response)) {
+            res = HOST_ERR_PROTOCOL;
+        }
+        if (res == HOST_OK) {
+            signature->v = response[0];
+            memcpy(signature->r, response + 1, 32);
+            memcpy(signature->s, response + 33, 32);
+        }
+    }
+    return res;
+}
+
+// clientPrintLatency implements printing the latency report of all used instructions.
+void clientPrintLatency(const client_t *client, FILE *out) {
+    for (unsigned ins = 0; ins < 256; ins++) {
+        if (client->latency[ins].count == 0) {
+            continue;
+        }
+
+        char label[16];
+        snprintf(label, sizeof(label), "INS 0x%02X", ins);
+        latencyPrint(out, label, &client->latency[ins]);
+    }
+}
@@ -0,0 +1,96 @@
+#ifndef FANTOM_HOST_CLIENT_H
+#define FANTOM_HOST_CLIENT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+#include "transport.h"
+#include "latency.h"
+
+// Instructions of the Fantom Ledger App; see doc/app_design.md.
+#define CLIENT_INS_VERSION 0x01
+#define CLIENT_INS_CAPABILITIES 0x02
+#define CLIENT_INS_GET_KEY 0x10
+#define CLIENT_INS_GET_ADDR 0x11
+#define CLIENT_INS_SIGN_TX 0x20
+
+// CLIENT_ADDRESS_SIZE defines the size of a raw address.
+#define CLIENT_ADDRESS_SIZE 20
+
+// client_t declares a client of a single device.
+// The client keeps the latency histogram of each instruction.
+typedef struct {
+    transport_t *transport;
+    uint16_t lastStatus;
+    latency_histogram_t latency[256];
+} client_t;
+
+// client_version_t declares the application version details.
+typedef struct {
+    uint8_t major;
+    uint8_t minor;
+    uint8_t patch;
+    uint8_t flags;
+} client_version_t;
+
+// client_capabilities_t declares the features and limits reported by the application.
+typedef struct {
+    uint32_t features;
+    uint8_t accountsPerResponse;
+    uint8_t accountsMax;
+    uint8_t verifyPerRequest;
+    uint8_t chunkSize;
+    uint8_t signTxSlots;
+    uint8_t keySlots;
+    uint8_t signCacheSize;
+    uint8_t nodeCacheSize;
+} client_capabilities_t;
+
+// what features can be reported by the application; see doc/cmd_capabilities.md
+enum {
+    CLIENT_CAPS_ZERO_RUN_STREAM = 0x0010,
+    CLIENT_CAPS_RECOVERABLE_FAULTS = 0x4000,
+};
+
+// client_signature_t declares the transaction signature.
+typedef struct {
+    uint8_t v;
+    uint8_t r[32];
+    uint8_t s[32];
+} client_signature_t;
+
+// clientInit implements setting up the client over the opened transport.
+void clientInit(client_t *client, transport_t *transport);
+
+// clientExchange implements a single APDU exchange with the device.
+// The latency of the exchange is recorded under the instruction code.
+// Returns HOST_ERR_STATUS if the device responds with an error status; the status
+// is kept in the lastStatus of the client.
+int clientExchange(
+        client_t *client,
+        uint8_t ins, uint8_t p1, uint8_t p2,
+        const uint8_t *data, size_t dataLength,
+        uint8_t *response, size_t responseSize, size_t *responseLength);
+
+// clientGetVersion implements the Get Application Version instruction.
+int clientGetVersion(client_t *client, client_version_t *version);
+
+// clientGetCapabilities implements the Get Capabilities instruction.
+int clientGetCapabilities(client_t *client, client_capabilities_t *caps);
+
+// clientGetAddress implements the Get Address instruction returning the address to the host.
+int clientGetAddress(client_t *client, const uint32_t *path, size_t depth, uint8_t address[CLIENT_ADDRESS_SIZE]);
+
+// clientSignTransaction implements the Sign Transaction instruction.
+// The RLP data are streamed in chunks planned by the chunk planner, optionally zero-run compressed.
+int clientSignTransaction(
+        client_t *client,
+        const uint32_t *path, size_t depth,
+        const uint8_t *rlp, uint32_t rlpLength, bool isZeroRun,
+        client_signature_t *signature);
+
+// clientPrintLatency implements printing the latency report of all used instructions.
+void clientPrintLatency(const client_t *client, FILE *out);
+
+#endif //FANTOM_HOST_CLIENT_H
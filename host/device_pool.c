@@ -0,0 +1,461 @@
+/**
+ * Implements the pool of devices shared by the service workers.
+ *
+ * Each device is used exclusively by a single worker at a time. Interactive sessions
+ * are pinned to the devices holding the account, non-interactive requests go to the
+ * fastest idle device and bulk address derivation is spread over all the idle devices.
+ * The pool tracks the latency and the error rates of each device and stops using
+ * devices failing on the transport level.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <dirent.h>
+#include <inttypes.h>
+
+#include "../src/errors.h"
+#include "host_errors.h"
+#include "device_pool.h"
+
+// POOL_LEDGER_VENDOR defines the USB vendor identifier of Ledger devices as listed in the hidraw uevent.
+#define POOL_LEDGER_VENDOR "00002C97"
+
+// POOL_IDENTITY_PATH defines the path of the address identifying the device seed; m/44'/60'/0'/0/0.
+static const uint32_t POOL_IDENTITY_PATH[] = {0x8000002C, 0x8000003C, 0x80000000, 0, 0};
+
+// poolInit implements setting up an empty pool.
+int poolInit(device_pool_t *pool) {
+    memset(pool, 0, sizeof(*pool));
+    if (pthread_mutex_init(&pool->lock, NULL) != 0) {
+        return HOST_ERR_OPEN;
+    }
+    if (pthread_cond_init(&pool->released, NULL) != 0) {
+        pthread_mutex_destroy(&pool->lock);
+        return HOST_ERR_OPEN;
+    }
+    return HOST_OK;
+}
+
+// poolClose implements closing all the devices of the pool.
+void poolClose(device_pool_t *pool) {
+    for (size_t i = 0; i < pool->count; i++) {
+        transportClose(&pool->devices[i].transport);
+        free(pool->devices[i].client);
+    }
+    pool->count = 0;
+    pthread_cond_destroy(&pool->released);
+    pthread_mutex_destroy(&pool->lock);
+}
+
+// poolAddTransport implements adding a device on the opened transport to the pool.
+int poolAddTransport(device_pool_t *pool, const transport_t *transport) {
+    if (pool->count >= POOL_MAX_DEVICES) {
+        return HOST_ERR_BUFFER;
+    }
+
+    pool_device_t *device = &pool->devices[pool->count];
+    memset(device, 0, sizeof(*device));
+    device->client = malloc(sizeof(client_t));
+    if (device->client == NULL) {
+        return HOST_ERR_BUFFER;
+    }
+
+    // the client refers to the transport copy kept by the pool
+    device->transport = *transport;
+    clientInit(device->client, &device->transport);
+    device->isHealthy = true;
+    pool->count++;
+    return HOST_OK;
+}
+
+// isLedgerHidraw implements check of the hidraw uevent for the APDU interface of a Ledger device.
+static bool isLedgerHidraw(const char *name) {
+    char path[300];
+    snprintf(path, sizeof(path), "/sys/class/hidraw/%s/device/uevent", name);
+
+    FILE *file = fopen(path, "r");
+    if (file == NULL) {
+        return false;
+    }
+
+    // the APDU exchange runs on the first interface, the others serve U2F and such
+    bool isVendor = false;
+    bool isApdu = false;
+    char line[256];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        if (strncmp(line, "HID_ID=", 7) == 0 && strstr(line, ":" POOL_LEDGER_VENDOR ":") != NULL) {
+            isVendor = true;
+        }
+        if (strncmp(line, "HID_PHYS=", 9) == 0 && strstr(line, "/input0") != NULL) {
+            isApdu = true;
+        }
+    }
+    fclose(file);
+    return isVendor && isApdu;
+}
+
+// poolListHidraw implements listing hidraw device nodes of connected Ledger devices.
+size_t poolListHidraw(char paths[][POOL_HIDRAW_PATH_SIZE], size_t maxPaths) {
+    DIR *dir = opendir("/sys/class/hidraw");
+    if (dir == NULL) {
+        return 0;
+    }
+
+    size_t count = 0;
+    struct dirent *entry;
+    while (count < maxPaths && (entry = readdir(dir)) != NULL) {
+        if (strncmp(entry->d_name, "hidraw", 6) == 0 && isLedgerHidraw(entry->d_name)) {
+            snprintf(paths[count++], POOL_HIDRAW_PATH_SIZE, "/dev/%.20s", entry->d_name);
+        }
+    }
+    closedir(dir);
+    return count;
+}
+
+// poolOpenHidraw implements adding all the connected Ledger devices to the pool.
+int poolOpenHidraw(device_pool_t *pool, int timeoutMs) {
+    char paths[POOL_MAX_DEVICES][POOL_HIDRAW_PATH_SIZE];
+    size_t count = poolListHidraw(paths, POOL_MAX_DEVICES - pool->count);
+
+    int added = 0;
+    for (size_t i = 0; i < count; i++) {
+        transport_t transport;
+        if (transportOpenHidraw(&transport, paths[i], timeoutMs) != HOST_OK) {
+            continue;
+        }
+        if (poolAddTransport(pool, &transport) != HOST_OK) {
+            transportClose(&transport);
+            break;
+        }
+        added++;
+    }
+    return added;
+}
+
+// poolIdentify implements reading the identity of all the devices of the pool.
+int poolIdentify(device_pool_t *pool) {
+    int res = HOST_OK;
+    for (size_t i = 0; i < pool->count; i++) {
+        pool_device_t *device = &pool->devices[i];
+
+        // the device may be used by a worker already
+        pthread_mutex_lock(&pool->lock);
+        while (device->isBusy) {
+            pthread_cond_wait(&pool->released, &pool->lock);
+        }
+        device->isBusy = true;
+        pthread_mutex_unlock(&pool->lock);
+
+        int status = clientGetAddress(device->client, POOL_IDENTITY_PATH, 5, device->identity);
+        device->hasIdentity = (status == HOST_OK);
+        if (status != HOST_OK) {
+            res = status;
+        }
+        poolRelease(pool, device, status);
+    }
+    return res;
+}
+
+// deviceAverageUs implements calculation of the average exchange latency of the device.
+static uint64_t deviceAverageUs(const pool_device_t *device) {
+    uint64_t count = 0;
+    uint64_t total = 0;
+    for (unsigned ins = 0; ins < 256; ins++) {
+        count += device->client->latency[ins].count;
+        total += device->client->latency[ins].totalUs;
+    }
+    return (count > 0) ? total / count : 0;
+}
+
+// isEligible implements check if the device can serve the identity.
+static bool isEligible(const pool_device_t *device, const uint8_t *identity) {
+    if (!device->isHealthy) {
+        return false;
+    }
+    return identity == NULL || (device->hasIdentity && memcmp(device->identity, identity, CLIENT_ADDRESS_SIZE) == 0);
+}
+
+// poolTryAcquireLocked implements taking the fastest idle eligible device; the pool lock must be held.
+static pool_device_t *poolTryAcquireLocked(device_pool_t *pool, const uint8_t *identity, bool *hasEligible) {
+    pool_device_t *best = NULL;
+    uint64_t bestUs = 0;
+    *hasEligible = false;
+
+    for (size_t i = 0; i < pool->count; i++) {
+        pool_device_t *device = &pool->devices[i];
+        if (!isEligible(device, identity)) {
+            continue;
+        }
+        *hasEligible = true;
+        if (device->isBusy) {
+            continue;
+        }
+
+        uint64_t us = deviceAverageUs(device);
+        if (best == NULL || us < bestUs) {
+            best = device;
+            bestUs = us;
+        }
+    }
+
+    if (best != NULL) {
+        best->isBusy = true;
+    }
+    return best;
+}
+
+// poolAcquire implements taking an idle healthy device for exclusive use.
+pool_device_t *poolAcquire(device_pool_t *pool, const uint8_t *identity) {
+    pthread_mutex_lock(&pool->lock);
+
+    pool_device_t *device;
+    bool hasEligible;
+    while ((device = poolTryAcquireLocked(pool, identity, &hasEligible)) == NULL && hasEligible) {
+        pthread_cond_wait(&pool->released, &pool->lock);
+    }
+
+    pthread_mutex_unlock(&pool->lock);
+    return device;
+}
+
+// poolFindPin implements looking up the identity the address is pinned to.
+static bool poolFindPin(device_pool_t *pool, const uint8_t *address, uint8_t *identity) {
+    bool isFound = false;
+    pthread_mutex_lock(&pool->lock);
+    for (size_t i = 0; i < pool->pinCount && !isFound; i++) {
+        if (memcmp(pool->pins[i].address, address, CLIENT_ADDRESS_SIZE) == 0) {
+            memcpy(identity, pool->pins[i].identity, CLIENT_ADDRESS_SIZE);
+            isFound = true;
+        }
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return isFound;
+}
+
+// poolAddPin implements pinning the address to the identity; the oldest pin is replaced if full.
+static void poolAddPin(device_pool_t *pool, const uint8_t *address, const uint8_t *identity) {
+    pthread_mutex_lock(&pool->lock);
+    pool_pin_t *pin = &pool->pins[pool->nextPin];
+    memcpy(pin->address, address, CLIENT_ADDRESS_SIZE);
+    memcpy(pin->identity, identity, CLIENT_ADDRESS_SIZE);
+    pool->nextPin = (pool->nextPin + 1) % POOL_MAX_PINS;
+    if (pool->pinCount < POOL_MAX_PINS) {
+        pool->pinCount++;
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// poolAcquireForAddress implements taking a device holding the key of the address.
+pool_device_t *poolAcquireForAddress(
+        device_pool_t *pool, const uint32_t *path, size_t depth, const uint8_t address[CLIENT_ADDRESS_SIZE]) {
+    // known address goes straight to its devices
+    uint8_t identity[CLIENT_ADDRESS_SIZE];
+    if (poolFindPin(pool, address, identity)) {
+        return poolAcquire(pool, identity);
+    }
+
+    // ask a device of each identity for the address
+    for (size_t i = 0; i < pool->count; i++) {
+        if (!pool->devices[i].hasIdentity) {
+            continue;
+        }
+
+        // skip identities we already asked
+        bool isAsked = false;
+        for (size_t j = 0; j < i && !isAsked; j++) {
+            isAsked = pool->devices[j].hasIdentity &&
+                      memcmp(pool->devices[j].identity, pool->devices[i].identity, CLIENT_ADDRESS_SIZE) == 0;
+        }
+        if (isAsked) {
+            continue;
+        }
+
+        pool_device_t *device = poolAcquire(pool, pool->devices[i].identity);
+        if (device == NULL) {
+            continue;
+        }
+
+        uint8_t derived[CLIENT_ADDRESS_SIZE];
+        int res = clientGetAddress(device->client, path, depth, derived);
+        if (res == HOST_OK && memcmp(derived, address, CLIENT_ADDRESS_SIZE) == 0) {
+            // keep the device for the session
+            poolAddPin(pool, address, device->identity);
+            return device;
+        }
+        poolRelease(pool, device, res);
+    }
+    return NULL;
+}
+
+// poolRelease implements returning the device to the pool with the result of its last call.
+void poolRelease(device_pool_t *pool, pool_device_t *device, int result) {
+    pthread_mutex_lock(&pool->lock);
+    device->requests++;
+
+    if (result == HOST_OK) {
+        device->consecutiveFailures = 0;
+    } else if (result == HOST_ERR_STATUS) {
+        // the device responded, it's just not happy about the request
+        uint16_t status = device->client->lastStatus;
+        if (status >= _ERR_PASS_FROM && status < _ERR_PASS_FROM + POOL_STATUS_CODES) {
+            device->statusErrors[status - _ERR_PASS_FROM]++;
+        } else {
+            device->otherStatusErrors++;
+        }
+        device->consecutiveFailures = 0;
+    } else {
+        // the transport failed; the device may have been disconnected, or it's stuck
+        device->failures++;
+        device->consecutiveFailures++;
+        if (device->consecutiveFailures >= POOL_MAX_FAILURES) {
+            device->isHealthy = false;
+        }
+    }
+
+    device->isBusy = false;
+    pthread_cond_broadcast(&pool->released);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// derive_job_t declares the shared state of a parallel address derivation.
+typedef struct {
+    pthread_mutex_t lock;
+    uint32_t chainPath[4];
+    uint32_t firstIndex;
+    uint32_t count;
+    uint32_t next;
+    int error;
+    uint8_t (*addresses)[CLIENT_ADDRESS_SIZE];
+} derive_job_t;
+
+// derive_worker_t declares a single worker of the parallel address derivation.
+typedef struct {
+    pthread_t thread;
+    derive_job_t *job;
+    pool_device_t *device;
+    bool isStarted;
+    int result;
+} derive_worker_t;
+
+// deriveWorker implements the worker thread; it takes the next address index until the job is done.
+static void *deriveWorker(void *arg) {
+    derive_worker_t *worker = arg;
+    derive_job_t *job = worker->job;
+
+    uint32_t path[5];
+    memcpy(path, job->chainPath, sizeof(job->chainPath));
+    worker->result = HOST_OK;
+
+    for (;;) {
+        pthread_mutex_lock(&job->lock);
+        bool isDone = (job->error != HOST_OK || job->next >= job->count);
+        uint32_t i = job->next++;
+        pthread_mutex_unlock(&job->lock);
+        if (isDone) {
+            break;
+        }
+
+        path[4] = job->firstIndex + i;
+        worker->result = clientGetAddress(worker->device->client, path, 5, job->addresses[i]);
+        if (worker->result != HOST_OK) {
+            pthread_mutex_lock(&job->lock);
+            if (job->error == HOST_OK) {
+                job->error = worker->result;
+            }
+            pthread_mutex_unlock(&job->lock);
+            break;
+        }
+    }
+    return NULL;
+}
+
+// poolDeriveAddresses implements deriving a range of addresses on all the idle devices of the identity.
+int poolDeriveAddresses(
+        device_pool_t *pool, const uint8_t *identity,
+        const uint32_t chainPath[4], uint32_t firstIndex, uint32_t count,
+        uint8_t (*addresses)[CLIENT_ADDRESS_SIZE]) {
+    if (count == 0) {
+        return HOST_OK;
+    }
+
+    derive_job_t job = {.firstIndex = firstIndex, .count = count, .addresses = addresses, .error = HOST_OK};
+    memcpy(job.chainPath, chainPath, sizeof(job.chainPath));
+    if (pthread_mutex_init(&job.lock, NULL) != 0) {
+        return HOST_ERR_OPEN;
+    }
+
+    // take all the idle devices, but at least one
+    derive_worker_t workers[POOL_MAX_DEVICES];
+    size_t workerCount = 0;
+    pthread_mutex_lock(&pool->lock);
+    bool hasEligible;
+    pool_device_t *device;
+    while (workerCount < count && (device = poolTryAcquireLocked(pool, identity, &hasEligible)) != NULL) {
+        workers[workerCount++].device = device;
+    }
+    pthread_mutex_unlock(&pool->lock);
+
+    if (workerCount == 0) {
+        device = poolAcquire(pool, identity);
+        if (device == NULL) {
+            pthread_mutex_destroy(&job.lock);
+            return HOST_ERR_OPEN;
+        }
+        workers[workerCount++].device = device;
+    }
+
+    // run the workers; the first one runs on this thread
+    for (size_t i = 0; i < workerCount; i++) {
+        workers[i].job = &job;
+        workers[i].result = HOST_OK;
+        workers[i].isStarted = (i > 0 && pthread_create(&workers[i].thread, NULL, deriveWorker, &workers[i]) == 0);
+    }
+    deriveWorker(&workers[0]);
+
+    // collect the workers and return their devices
+    for (size_t i = 0; i < workerCount; i++) {
+        if (workers[i].isStarted) {
+            pthread_join(workers[i].thread, NULL);
+        }
+        poolRelease(pool, workers[i].device, workers[i].result);
+    }
+
+    pthread_mutex_destroy(&job.lock);
+    return job.error;
+}
+
+// poolPrintStats implements printing the latency and error statistics of all the devices.
+void poolPrintStats(device_pool_t *pool, FILE *out) {
+    pthread_mutex_lock(&pool->lock);
+    for (size_t i = 0; i < pool->count; i++) {
+        pool_device_t *device = &pool->devices[i];
+
+        // the histograms of a busy device are being updated by its worker without the pool lock
+        if (device->isBusy) {
+            fprintf(out, "device %zu (busy)\n", i);
+        } else {
+            // merge the instruction histograms of the device
+            latency_histogram_t latency;
+            memset(&latency, 0, sizeof(latency));
+            for (unsigned ins = 0; ins < 256; ins++) {
+                latencyMerge(&latency, &device->client->latency[ins]);
+            }
+
+            char label[32];
+            snprintf(label, sizeof(label), "device %zu%s", i, device->isHealthy ? "" : " (down)");
+            latencyPrint(out, label, &latency);
+        }
+
+        fprintf(out, "    calls=%" PRIu64 " transport failures=%" PRIu64, device->requests, device->failures);
+        for (unsigned code = 0; code < POOL_STATUS_CODES; code++) {
+            if (device->statusErrors[code] > 0) {
+                fprintf(out, " 0x%04X=%" PRIu64, _ERR_PASS_FROM + code, device->statusErrors[code]);
+            }
+        }
+        if (device->otherStatusErrors > 0) {
+            fprintf(out, " other=%" PRIu64, device->otherStatusErrors);
+        }
+        fprintf(out, "\n");
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
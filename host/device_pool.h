@@ -0,0 +1,109 @@
+#ifndef FANTOM_HOST_DEVICE_POOL_H
+#define FANTOM_HOST_DEVICE_POOL_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include "transport.h"
+#include "client.h"
+
+// POOL_MAX_DEVICES defines how many devices a pool can manage.
+#define POOL_MAX_DEVICES 16
+
+// POOL_MAX_PINS defines how many addresses can be pinned to their devices.
+#define POOL_MAX_PINS 64
+
+// POOL_MAX_FAILURES defines how many consecutive transport failures make the device unhealthy.
+#define POOL_MAX_FAILURES 3
+
+// POOL_STATUS_CODES defines how many device status codes we count; the ERR_* codes are 0x6E00 to 0x6E0F.
+#define POOL_STATUS_CODES 16
+
+// POOL_HIDRAW_PATH_SIZE defines the size of a hidraw device node path.
+#define POOL_HIDRAW_PATH_SIZE 32
+
+// pool_device_t declares a single device of the pool with its health statistics.
+// The identity is the address of m/44'/60'/0'/0/0; devices sharing the identity share the seed.
+typedef struct {
+    transport_t transport;
+    client_t *client;
+    uint8_t identity[CLIENT_ADDRESS_SIZE];
+    bool hasIdentity;
+    bool isBusy;
+    bool isHealthy;
+    uint32_t consecutiveFailures;
+    uint64_t requests;
+    uint64_t failures;
+    uint64_t statusErrors[POOL_STATUS_CODES];
+    uint64_t otherStatusErrors;
+} pool_device_t;
+
+// pool_pin_t declares an address pinned to the identity of the device holding it.
+typedef struct {
+    uint8_t address[CLIENT_ADDRESS_SIZE];
+    uint8_t identity[CLIENT_ADDRESS_SIZE];
+} pool_pin_t;
+
+// device_pool_t declares a pool of devices shared by the service workers.
+typedef struct {
+    pool_device_t devices[POOL_MAX_DEVICES];
+    size_t count;
+    pool_pin_t pins[POOL_MAX_PINS];
+    size_t pinCount;
+    size_t nextPin;
+    pthread_mutex_t lock;
+    pthread_cond_t released;
+} device_pool_t;
+
+// poolInit implements setting up an empty pool.
+int poolInit(device_pool_t *pool);
+
+// poolClose implements closing all the devices of the pool.
+void poolClose(device_pool_t *pool);
+
+// poolAddTransport implements adding a device on the opened transport to the pool.
+// The pool takes over the transport and closes it with the pool.
+int poolAddTransport(device_pool_t *pool, const transport_t *transport);
+
+// poolListHidraw implements listing hidraw device nodes of connected Ledger devices.
+// Returns the number of nodes found.
+size_t poolListHidraw(char paths[][POOL_HIDRAW_PATH_SIZE], size_t maxPaths);
+
+// poolOpenHidraw implements adding all the connected Ledger devices to the pool.
+// Returns the number of devices added.
+int poolOpenHidraw(device_pool_t *pool, int timeoutMs);
+
+// poolIdentify implements reading the identity of all the devices of the pool.
+int poolIdentify(device_pool_t *pool);
+
+// poolAcquire implements taking an idle healthy device for exclusive use.
+// If the identity is given, only devices of that identity are considered.
+// The fastest idle device is picked. The call waits until such a device is released;
+// NULL is returned if there is no healthy device of the identity at all.
+pool_device_t *poolAcquire(device_pool_t *pool, const uint8_t *identity);
+
+// poolAcquireForAddress implements taking a device holding the key of the address.
+// The address is pinned to the device identity on the first use so the next sessions
+// go straight to the devices holding the account.
+pool_device_t *poolAcquireForAddress(
+        device_pool_t *pool, const uint32_t *path, size_t depth, const uint8_t address[CLIENT_ADDRESS_SIZE]);
+
+// poolRelease implements returning the device to the pool with the result of its last call.
+// The result updates the device health statistics.
+void poolRelease(device_pool_t *pool, pool_device_t *device, int result);
+
+// poolDeriveAddresses implements deriving a range of addresses under the chain node
+// m/44'/60'/account'/change on all the idle devices of the identity in parallel.
+int poolDeriveAddresses(
+        device_pool_t *pool, const uint8_t *identity,
+        const uint32_t chainPath[4], uint32_t firstIndex, uint32_t count,
+        uint8_t (*addresses)[CLIENT_ADDRESS_SIZE]);
+
+// poolPrintStats implements printing the latency and error statistics of all the devices.
+// The latency of busy devices is skipped, their workers update it without the pool lock.
+void poolPrintStats(device_pool_t *pool, FILE *out);
+
+#endif //FANTOM_HOST_DEVICE_POOL_H
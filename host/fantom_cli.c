@@ -0,0 +1,256 @@
+/**
+ * Implements a command line client of the Fantom Ledger App.
+ *
+ * Usage:
+ *   fantom_cli [--hid /dev/hidrawN | --tcp host:port] [--zero-run] [--record file] <command> [args]
+ *
+ * Commands:
+ *   version                  prints the application version
+ *   caps                     prints the application capabilities
+ *   address <path>           prints the address of the path, e.g. 44'/60'/0'/0/0
+ *   sign <path> <rlp hex>    signs the RLP encoded transaction
+ *
+ * The latency report of all the exchanged instructions is printed at the end.
+ * The exchanged APDUs can be recorded to a trace file for the replay benchmark.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_errors.h"
+#include "client.h"
+#include "trace.h"
+
+// CLI_MAX_PATH_DEPTH defines the max number of BIP32 derivations we parse.
+#define CLI_MAX_PATH_DEPTH 10
+
+// recorded keeps the transport of the recorded session
+static transport_t recorded;
+
+// recording keeps the trace file of the recorded session
+static FILE *recording = NULL;
+
+// recordExchange implements the exchange on the recorded transport; each exchange goes to the trace.
+static int recordExchange(transport_t *transport,
+                          const uint8_t *apdu, size_t apduLength,
+                          uint8_t *response, size_t responseSize, size_t *responseLength) {
+    (void) transport;
+    int res = transportExchange(&recorded, apdu, apduLength, response, responseSize, responseLength);
+    if (res == HOST_OK) {
+        traceWriteExchange(recording, apdu, apduLength, response, *responseLength);
+    }
+    return res;
+}
+
+// parsePath implements parsing of the BIP32 path in the common textual form.
+static int parsePath(const char *str, uint32_t *path) {
+    int depth = 0;
+    if (str[0] == 'm' && str[1] == '/') {
+        str += 2;
+    }
+    while (*str != '\0' && depth < CLI_MAX_PATH_DEPTH) {
+        char *end;
+        unsigned long index = strtoul(str, &end, 10);
+        if (end == str || index >= 0x80000000ul) {
+            return HOST_ERR_PARAMETERS;
+        }
+        path[depth] = (uint32_t) index;
+        if (*end == '\'' || *end == 'h') {
+            path[depth] |= 0x80000000u;
+            end++;
+        }
+        depth++;
+        if (*end == '/') {
+            end++;
+        } else if (*end != '\0') {
+            return HOST_ERR_PARAMETERS;
+        }
+        str = end;
+    }
+    return (*str == '\0' && depth > 0) ? depth : HOST_ERR_PARAMETERS;
+}
+
+// parseHex implements decoding of hex string into a newly allocated buffer.
+static uint8_t *parseHex(const char *str, uint32_t *length) {
+    if (str[0] == '0' && (str[1] == 'x' || str[1] == 'X')) {
+        str += 2;
+    }
+    size_t size = strlen(str);
+    if (size % 2 != 0) {
+        return NULL;
+    }
+
+    uint8_t *out = malloc(size / 2 + 1);
+    for (size_t i = 0; out != NULL && i < size / 2; i++) {
+        unsigned value;
+        if (sscanf(str + 2 * i, "%2x", &value) != 1) {
+            free(out);
+            return NULL;
+        }
+        out[i] = (uint8_t) value;
+    }
+    *length = (uint32_t) (size / 2);
+    return out;
+}
+
+// printHex implements printing the buffer in hex.
+static void printHex(const char *label, const uint8_t *data, size_t length) {
+    printf("%s", label);
+    for (size_t i = 0; i < length; i++) {
+        printf("%02x", data[i]);
+    }
+    printf("\n");
+}
+
+// usage implements printing the usage help.
+static int usage() {
+    fprintf(stderr, "usage: fantom_cli [--hid /dev/hidrawN | --tcp host:port] [--zero-run] [--record file] "
+                    "version | caps | address <path> | sign <path> <rlp hex>\n");
+    return 2;
+}
+
+// runCommand implements the command execution on the connected device.
+static int runCommand(client_t *client, int argc, char **argv, bool isZeroRun) {
+    uint32_t path[CLI_MAX_PATH_DEPTH];
+
+    if (strcmp(argv[0], "version") == 0) {
+        client_version_t version;
+        int res = clientGetVersion(client, &version);
+        if (res == HOST_OK) {
+            printf("version %u.%u.%u flags 0x%02x\n", version.major, version.minor, version.patch, version.flags);
+        }
+        return res;
+    }
+
+    if (strcmp(argv[0], "caps") == 0) {
+        client_capabilities_t caps;
+        int res = clientGetCapabilities(client, &caps);
+        if (res == HOST_OK) {
+            printf("features 0x%08x\n", (unsigned) caps.features);
+            printf("accounts %u per response, %u max\n", caps.accountsPerResponse, caps.accountsMax);
+            printf("verify %u per batch\n", caps.verifyPerRequest);
+            printf("chunk %u, tx slots %u, key slots %u, sign cache %u, node cache %u\n",
+                   caps.chunkSize, caps.signTxSlots, caps.keySlots, caps.signCacheSize, caps.nodeCacheSize);
+        }
+        return res;
+    }
+
+    if (strcmp(argv[0], "address") == 0 && argc == 2) {
+        int depth = parsePath(argv[1], path);
+        if (depth < 0) {
+            return depth;
+        }
+
+        uint8_t address[CLIENT_ADDRESS_SIZE];
+        int res = clientGetAddress(client, path, (size_t) depth, address);
+        if (res == HOST_OK) {
+            printHex("address 0x", address, sizeof(address));
+        }
+        return res;
+    }
+
+    if (strcmp(argv[0], "sign") == 0 && argc == 3) {
+        int depth = parsePath(argv[1], path);
+        if (depth < 0) {
+            return depth;
+        }
+
+        uint32_t rlpLength;
+        uint8_t *rlp = parseHex(argv[2], &rlpLength);
+        if (rlp == NULL) {
+            return HOST_ERR_PARAMETERS;
+        }
+
+        client_signature_t signature;
+        int res = clientSignTransaction(client, path, (size_t) depth, rlp, rlpLength, isZeroRun, &signature);
+        free(rlp);
+        if (res == HOST_OK) {
+            printf("v %u\n", signature.v);
+            printHex("r ", signature.r, sizeof(signature.r));
+            printHex("s ", signature.s, sizeof(signature.s));
+        }
+        return res;
+    }
+
+    return HOST_ERR_PARAMETERS;
+}
+
+int main(int argc, char **argv) {
+    const char *hidPath = NULL;
+    const char *tcpAddress = NULL;
+    bool isZeroRun = false;
+    const char *recordPath = NULL;
+
+    // parse the options
+    int i = 1;
+    for (; i < argc && strncmp(argv[i], "--", 2) == 0; i++) {
+        if (strcmp(argv[i], "--hid") == 0 && i + 1 < argc) {
+            hidPath = argv[++i];
+        } else if (strcmp(argv[i], "--tcp") == 0 && i + 1 < argc) {
+            tcpAddress = argv[++i];
+        } else if (strcmp(argv[i], "--zero-run") == 0) {
+            isZeroRun = true;
+        } else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else {
+            return usage();
+        }
+    }
+    if (i >= argc || (hidPath == NULL) == (tcpAddress == NULL)) {
+        return usage();
+    }
+
+    // open the transport
+    transport_t transport;
+    int res;
+    if (hidPath != NULL) {
+        res = transportOpenHidraw(&transport, hidPath, TRANSPORT_DEFAULT_TIMEOUT_MS);
+    } else {
+        char host[256];
+        unsigned port;
+        if (sscanf(tcpAddress, "%255[^:]:%u", host, &port) != 2 || port > 0xFFFF) {
+            return usage();
+        }
+        res = transportOpenTcp(&transport, host, (uint16_t) port, TRANSPORT_DEFAULT_TIMEOUT_MS);
+    }
+    if (res != HOST_OK) {
+        fprintf(stderr, "can not open the device: %d\n", res);
+        return 1;
+    }
+
+    // the recorded session goes through the recording transport
+    transport_t *used = &transport;
+    transport_t recorder = {.exchange = recordExchange, .fd = transport.fd, .timeoutMs = transport.timeoutMs};
+    if (recordPath != NULL) {
+        recording = fopen(recordPath, "w");
+        if (recording == NULL) {
+            fprintf(stderr, "can not open %s\n", recordPath);
+            transportClose(&transport);
+            return 1;
+        }
+        recorded = transport;
+        used = &recorder;
+    }
+
+    // run the command
+    client_t *client = malloc(sizeof(client_t));
+    if (client == NULL) {
+        transportClose(&transport);
+        return 1;
+    }
+    clientInit(client, used);
+    res = runCommand(client, argc - i, argv + i, isZeroRun);
+    if (res == HOST_ERR_STATUS) {
+        fprintf(stderr, "device error status 0x%04x\n", client->lastStatus);
+    } else if (res != HOST_OK) {
+        fprintf(stderr, "failed: %d\n", res);
+    }
+
+    clientPrintLatency(client, stderr);
+    free(client);
+    if (recording != NULL) {
+        fclose(recording);
+    }
+    transportClose(&transport);
+    return (res == HOST_OK) ? 0 : 1;
+}
@@ -0,0 +1,203 @@
+/**
+ * Implements the replay benchmark of recorded APDU sessions.
+ *
+ * Usage:
+ *   fantom_replay [--hid /dev/hidrawN | --tcp host:port] [--buttons host:port] [--delay ms]
+ *                 [--repeat N] <trace file> ...
+ *   fantom_replay --compare <baseline report> <current report> [threshold %]
+ *
+ * Each trace is replayed the given number of times and the latency report of all
+ * the instructions and trace stages is printed on the standard output. Reports of two
+ * commits can be diffed, or compared with the --compare mode flagging slower lines.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_errors.h"
+#include "transport.h"
+#include "buttons.h"
+#include "trace.h"
+#include "replay.h"
+
+// REPLAY_DEFAULT_THRESHOLD defines the default slowdown in percent reported as a regression.
+#define REPLAY_DEFAULT_THRESHOLD 10.0
+
+// usage implements printing the usage help.
+static int usage() {
+    fprintf(stderr, "usage: fantom_replay [--hid /dev/hidrawN | --tcp host:port] [--buttons host:port] "
+                    "[--delay ms] [--repeat N] <trace> ...\n"
+                    "       fantom_replay --compare <baseline> <current> [threshold %%]\n");
+    return 2;
+}
+
+// parseAddress implements parsing of the host:port address.
+static bool parseAddress(const char *str, char *host, size_t hostSize, uint16_t *port) {
+    const char *colon = strrchr(str, ':');
+    if (colon == NULL || (size_t) (colon - str) >= hostSize) {
+        return false;
+    }
+
+    char *end;
+    unsigned long value = strtoul(colon + 1, &end, 10);
+    if (*end != '\0' || value == 0 || value > 0xFFFF) {
+        return false;
+    }
+
+    memcpy(host, str, (size_t) (colon - str));
+    host[colon - str] = '\0';
+    *port = (uint16_t) value;
+    return true;
+}
+
+// traceName implements the trace name; the file name without the directory and the extension.
+static void traceName(const char *path, char *name, size_t nameSize) {
+    const char *slash = strrchr(path, '/');
+    snprintf(name, nameSize, "%s", (slash != NULL) ? slash + 1 : path);
+
+    char *dot = strrchr(name, '.');
+    if (dot != NULL && dot != name) {
+        *dot = '\0';
+    }
+}
+
+// compareReports implements the --compare mode.
+static int compareReports(int argc, char **argv) {
+    if (argc < 2 || argc > 3) {
+        return usage();
+    }
+    double threshold = (argc == 3) ? atof(argv[2]) : REPLAY_DEFAULT_THRESHOLD;
+
+    FILE *baseline = fopen(argv[0], "r");
+    FILE *current = fopen(argv[1], "r");
+    int res = 1;
+    if (baseline != NULL && current != NULL) {
+        int regressions = replayCompare(baseline, current, threshold, stdout);
+        if (regressions >= 0) {
+            printf("%d regression(s) over %.1f%%\n", regressions, threshold);
+        }
+        res = (regressions == 0) ? 0 : 1;
+    } else {
+        fprintf(stderr, "can not open the reports\n");
+    }
+
+    if (baseline != NULL) {
+        fclose(baseline);
+    }
+    if (current != NULL) {
+        fclose(current);
+    }
+    return res;
+}
+
+// replayFile implements loading the trace file and replaying it.
+static int replayFile(const char *path, int repeat, transport_t *transport, buttons_t *buttons,
+                      replay_report_t *report) {
+    FILE *in = fopen(path, "r");
+    if (in == NULL) {
+        fprintf(stderr, "can not open %s\n", path);
+        return HOST_ERR_OPEN;
+    }
+
+    trace_t trace;
+    int line;
+    int res = traceLoad(&trace, in, &line);
+    fclose(in);
+    if (res != HOST_OK) {
+        fprintf(stderr, "%s:%d: invalid trace line\n", path, line);
+        return res;
+    }
+
+    char name[REPLAY_LABEL_SIZE / 2];
+    traceName(path, name, sizeof(name));
+    for (int i = 0; i < repeat && res == HOST_OK; i++) {
+        res = replayTrace(transport, buttons, name, &trace, report);
+    }
+
+    traceFree(&trace);
+    return res;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && strcmp(argv[1], "--compare") == 0) {
+        return compareReports(argc - 2, argv + 2);
+    }
+
+    const char *hidPath = NULL;
+    const char *tcpAddress = NULL;
+    const char *buttonsAddress = NULL;
+    int delayMs = BUTTONS_DEFAULT_DELAY_MS;
+    int repeat = 1;
+
+    // parse the options
+    int i = 1;
+    for (; i < argc && strncmp(argv[i], "--", 2) == 0; i++) {
+        if (strcmp(argv[i], "--hid") == 0 && i + 1 < argc) {
+            hidPath = argv[++i];
+        } else if (strcmp(argv[i], "--tcp") == 0 && i + 1 < argc) {
+            tcpAddress = argv[++i];
+        } else if (strcmp(argv[i], "--buttons") == 0 && i + 1 < argc) {
+            buttonsAddress = argv[++i];
+        } else if (strcmp(argv[i], "--delay") == 0 && i + 1 < argc) {
+            delayMs = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) {
+            repeat = atoi(argv[++i]);
+        } else {
+            return usage();
+        }
+    }
+    if (i >= argc || (hidPath == NULL) == (tcpAddress == NULL) || repeat < 1 || delayMs < 0) {
+        return usage();
+    }
+
+    // open the transport and the buttons
+    char host[256];
+    uint16_t port;
+    transport_t transport;
+    int res;
+    if (hidPath != NULL) {
+        res = transportOpenHidraw(&transport, hidPath, TRANSPORT_DEFAULT_TIMEOUT_MS);
+    } else if (parseAddress(tcpAddress, host, sizeof(host), &port)) {
+        res = transportOpenTcp(&transport, host, port, TRANSPORT_DEFAULT_TIMEOUT_MS);
+    } else {
+        return usage();
+    }
+    if (res != HOST_OK) {
+        fprintf(stderr, "can not open the device: %d\n", res);
+        return 1;
+    }
+
+    buttons_t buttons;
+    buttons_t *buttonsPtr = NULL;
+    if (buttonsAddress != NULL) {
+        if (!parseAddress(buttonsAddress, host, sizeof(host), &port) ||
+            buttonsOpenTcp(&buttons, host, port, delayMs) != HOST_OK) {
+            fprintf(stderr, "can not open the buttons\n");
+            transportClose(&transport);
+            return 1;
+        }
+        buttonsPtr = &buttons;
+    }
+
+    // replay the traces
+    replay_report_t *report = malloc(sizeof(replay_report_t));
+    if (report == NULL) {
+        transportClose(&transport);
+        return 1;
+    }
+    replayInit(report);
+    for (; i < argc && res == HOST_OK; i++) {
+        res = replayFile(argv[i], repeat, &transport, buttonsPtr, report);
+    }
+
+    if (res == HOST_OK) {
+        replayPrintReport(stdout, report);
+    }
+
+    free(report);
+    if (buttonsPtr != NULL) {
+        buttonsClose(buttonsPtr);
+    }
+    transportClose(&transport);
+    return (res == HOST_OK) ? 0 : 1;
+}
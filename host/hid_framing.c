@@ -0,0 +1,103 @@
+/**
+ * Implements the Ledger HID transport framing.
+ *
+ * An APDU is split into 64 byte HID reports. Each report starts with the channel
+ * identifier, the command tag and the big endian sequence index. The first report
+ * carries the big endian length of the whole APDU, the last report is zero padded.
+ */
+#include <string.h>
+
+#include "host_errors.h"
+#include "hid_framing.h"
+
+// hidPacketCount implements calculation of how many packets the APDU of given length takes.
+size_t hidPacketCount(size_t apduLength) {
+    if (apduLength <= HID_FIRST_PAYLOAD) {
+        return 1;
+    }
+    return 1 + (apduLength - HID_FIRST_PAYLOAD + HID_NEXT_PAYLOAD - 1) / HID_NEXT_PAYLOAD;
+}
+
+// hidWriteHeader implements writing the packet header.
+static size_t hidWriteHeader(uint16_t sequence, uint8_t packet[HID_PACKET_SIZE]) {
+    packet[0] = (uint8_t) (HID_CHANNEL >> 8);
+    packet[1] = (uint8_t) (HID_CHANNEL & 0xFF);
+    packet[2] = HID_TAG_APDU;
+    packet[3] = (uint8_t) (sequence >> 8);
+    packet[4] = (uint8_t) (sequence & 0xFF);
+    return HID_HEADER_SIZE;
+}
+
+// hidWrapPacket implements building the packet of given sequence index carrying the APDU.
+bool hidWrapPacket(const uint8_t *apdu, size_t apduLength, uint16_t sequence, uint8_t packet[HID_PACKET_SIZE]) {
+    // the length field is 16 bits wide
+    if (apduLength > 0xFFFF || sequence >= hidPacketCount(apduLength)) {
+        return false;
+    }
+
+    memset(packet, 0, HID_PACKET_SIZE);
+    size_t pos = hidWriteHeader(sequence, packet);
+
+    // the first packet carries the APDU length
+    size_t offset;
+    size_t capacity;
+    if (sequence == 0) {
+        packet[pos++] = (uint8_t) (apduLength >> 8);
+        packet[pos++] = (uint8_t) (apduLength & 0xFF);
+        offset = 0;
+        capacity = HID_FIRST_PAYLOAD;
+    } else {
+        offset = HID_FIRST_PAYLOAD + (size_t) (sequence - 1) * HID_NEXT_PAYLOAD;
+        capacity = HID_NEXT_PAYLOAD;
+    }
+
+    // copy the APDU slice
+    size_t length = apduLength - offset;
+    if (length > capacity) {
+        length = capacity;
+    }
+    memcpy(packet + pos, apdu + offset, length);
+    return true;
+}
+
+// hidUnwrapInit implements setting up the response reassembly into the given buffer.
+void hidUnwrapInit(hid_unwrap_t *state, uint8_t *buffer, size_t bufferSize) {
+    memset(state, 0, sizeof(*state));
+    state->buffer = buffer;
+    state->bufferSize = bufferSize;
+}
+
+// hidUnwrapPacket implements consuming the next response packet.
+int hidUnwrapPacket(hid_unwrap_t *state, const uint8_t packet[HID_PACKET_SIZE]) {
+    // validate the packet header
+    uint16_t channel = (uint16_t) ((packet[0] << 8) | packet[1]);
+    uint16_t sequence = (uint16_t) ((packet[3] << 8) | packet[4]);
+    if (channel != HID_CHANNEL || packet[2] != HID_TAG_APDU || sequence != state->sequence) {
+        return HOST_ERR_PROTOCOL;
+    }
+
+    // the first packet tells us how long the response is
+    size_t pos = HID_HEADER_SIZE;
+    size_t capacity = HID_NEXT_PAYLOAD;
+    if (sequence == 0) {
+        state->expected = (size_t) ((packet[pos] << 8) | packet[pos + 1]);
+        state->received = 0;
+        pos += 2;
+        capacity = HID_FIRST_PAYLOAD;
+
+        if (state->expected > state->bufferSize) {
+            return HOST_ERR_BUFFER;
+        }
+    }
+
+    // collect the payload
+    size_t length = state->expected - state->received;
+    if (length > capacity) {
+        length = capacity;
+    }
+    memcpy(state->buffer + state->received, packet + pos, length);
+    state->received += length;
+    state->sequence++;
+
+    return (state->received == state->expected) ? 1 : 0;
+}
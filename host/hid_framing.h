@@ -0,0 +1,51 @@
+#ifndef FANTOM_HOST_HID_FRAMING_H
+#define FANTOM_HOST_HID_FRAMING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// HID_PACKET_SIZE defines the size of a single HID report; matches IO_HID_EP_LENGTH of the app.
+#define HID_PACKET_SIZE 64
+
+// HID_CHANNEL defines the channel identifier Ledger devices use for APDU exchange.
+#define HID_CHANNEL 0x0101
+
+// HID_TAG_APDU defines the command tag of APDU carrying packets.
+#define HID_TAG_APDU 0x05
+
+// HID_HEADER_SIZE defines the size of the packet header; channel, tag, and sequence index.
+#define HID_HEADER_SIZE 5
+
+// HID_FIRST_PAYLOAD defines the payload size of the first packet; it also carries the APDU length.
+#define HID_FIRST_PAYLOAD (HID_PACKET_SIZE - HID_HEADER_SIZE - 2)
+
+// HID_NEXT_PAYLOAD defines the payload size of the continuation packets.
+#define HID_NEXT_PAYLOAD (HID_PACKET_SIZE - HID_HEADER_SIZE)
+
+// hidPacketCount implements calculation of how many packets the APDU of given length takes.
+size_t hidPacketCount(size_t apduLength);
+
+// hidWrapPacket implements building the packet of given sequence index carrying the APDU.
+// The packets are zero padded to the full HID report size.
+// Returns false if the APDU does not reach the packet.
+bool hidWrapPacket(const uint8_t *apdu, size_t apduLength, uint16_t sequence, uint8_t packet[HID_PACKET_SIZE]);
+
+// hid_unwrap_t declares the state of a response being reassembled from packets.
+typedef struct {
+    uint8_t *buffer;
+    size_t bufferSize;
+    size_t expected;
+    size_t received;
+    uint16_t sequence;
+} hid_unwrap_t;
+
+// hidUnwrapInit implements setting up the response reassembly into the given buffer.
+void hidUnwrapInit(hid_unwrap_t *state, uint8_t *buffer, size_t bufferSize);
+
+// hidUnwrapPacket implements consuming the next response packet.
+// Returns 1 if the response is complete, 0 if more packets are expected,
+// or a negative host error code.
+int hidUnwrapPacket(hid_unwrap_t *state, const uint8_t packet[HID_PACKET_SIZE]);
+
+#endif //FANTOM_HOST_HID_FRAMING_H
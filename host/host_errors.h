@@ -0,0 +1,33 @@
+#ifndef FANTOM_HOST_ERRORS_H
+#define FANTOM_HOST_ERRORS_H
+
+// Status codes returned by the host library calls.
+// Negative values are host side failures, the device status words
+// are passed separately; see ../src/errors.h for their meaning.
+enum {
+    // Call succeeded.
+    HOST_OK = 0,
+
+    // Transport failed to send, or receive data.
+    HOST_ERR_IO = -1,
+
+    // Device did not respond in time.
+    HOST_ERR_TIMEOUT = -2,
+
+    // Device response does not follow the protocol.
+    HOST_ERR_PROTOCOL = -3,
+
+    // Provided buffer is too small for the data.
+    HOST_ERR_BUFFER = -4,
+
+    // Call parameters are not valid.
+    HOST_ERR_PARAMETERS = -5,
+
+    // Device responded with an error status word.
+    HOST_ERR_STATUS = -6,
+
+    // Device, or the transport, could not be opened.
+    HOST_ERR_OPEN = -7,
+};
+
+#endif //FANTOM_HOST_ERRORS_H
@@ -0,0 +1,88 @@
+/**
+ * Implements latency histograms of the APDU exchange.
+ */
+#include <time.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "latency.h"
+
+// latencyNowUs implements reading the monotonic clock in microseconds.
+uint64_t latencyNowUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000u + (uint64_t) ts.tv_nsec / 1000u;
+}
+
+// latencyBucket implements finding the bucket of the latency.
+static unsigned latencyBucket(uint64_t us) {
+    unsigned bucket = 0;
+    while (bucket < LATENCY_BUCKETS - 1 && us >= ((uint64_t) 1 << bucket)) {
+        bucket++;
+    }
+    return bucket;
+}
+
+// latencyRecord implements adding a latency sample to the histogram.
+void latencyRecord(latency_histogram_t *histogram, uint64_t us) {
+    if (histogram->count == 0 || us < histogram->minUs) {
+        histogram->minUs = us;
+    }
+    if (us > histogram->maxUs) {
+        histogram->maxUs = us;
+    }
+    histogram->count++;
+    histogram->totalUs += us;
+    histogram->buckets[latencyBucket(us)]++;
+}
+
+// latencyMerge implements adding all the samples of one histogram to another.
+void latencyMerge(latency_histogram_t *into, const latency_histogram_t *from) {
+    if (from->count == 0) {
+        return;
+    }
+    if (into->count == 0 || from->minUs < into->minUs) {
+        into->minUs = from->minUs;
+    }
+    if (from->maxUs > into->maxUs) {
+        into->maxUs = from->maxUs;
+    }
+    into->count += from->count;
+    into->totalUs += from->totalUs;
+    for (unsigned i = 0; i < LATENCY_BUCKETS; i++) {
+        into->buckets[i] += from->buckets[i];
+    }
+}
+
+// latencyPercentile implements estimating the latency percentile from the histogram.
+uint64_t latencyPercentile(const latency_histogram_t *histogram, double percentile) {
+    if (histogram->count == 0) {
+        return 0;
+    }
+
+    // the rank of the sample we look for
+    uint64_t rank = (uint64_t) (percentile / 100.0 * (double) histogram->count + 0.5);
+    if (rank < 1) {
+        rank = 1;
+    }
+
+    uint64_t seen = 0;
+    for (unsigned i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += histogram->buckets[i];
+        if (seen >= rank) {
+            // the bucket bound can not be above the observed max
+            uint64_t bound = ((uint64_t) 1 << i);
+            return (bound < histogram->maxUs) ? bound : histogram->maxUs;
+        }
+    }
+    return histogram->maxUs;
+}
+
+// latencyPrint implements printing the histogram summary as a single report line.
+void latencyPrint(FILE *out, const char *label, const latency_histogram_t *histogram) {
+    uint64_t avg = (histogram->count > 0) ? histogram->totalUs / histogram->count : 0;
+    fprintf(out, "%-24s n=%-8" PRIu64 " min=%-8" PRIu64 " avg=%-8" PRIu64
+                 " p50<=%-8" PRIu64 " p99<=%-8" PRIu64 " max=%" PRIu64 " us\n",
+            label, histogram->count, histogram->minUs, avg,
+            latencyPercentile(histogram, 50.0), latencyPercentile(histogram, 99.0), histogram->maxUs);
+}
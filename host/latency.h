@@ -0,0 +1,36 @@
+#ifndef FANTOM_HOST_LATENCY_H
+#define FANTOM_HOST_LATENCY_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+// LATENCY_BUCKETS defines the number of histogram buckets; bucket i holds
+// latencies below 2^i microseconds, the last one everything longer.
+#define LATENCY_BUCKETS 28
+
+// latency_histogram_t declares a log2 histogram of latencies in microseconds.
+typedef struct {
+    uint64_t count;
+    uint64_t totalUs;
+    uint64_t minUs;
+    uint64_t maxUs;
+    uint64_t buckets[LATENCY_BUCKETS];
+} latency_histogram_t;
+
+// latencyNowUs implements reading the monotonic clock in microseconds.
+uint64_t latencyNowUs();
+
+// latencyRecord implements adding a latency sample to the histogram.
+void latencyRecord(latency_histogram_t *histogram, uint64_t us);
+
+// latencyMerge implements adding all the samples of one histogram to another.
+void latencyMerge(latency_histogram_t *into, const latency_histogram_t *from);
+
+// latencyPercentile implements estimating the latency percentile from the histogram.
+// The upper bound of the bucket the percentile falls into is returned.
+uint64_t latencyPercentile(const latency_histogram_t *histogram, double percentile);
+
+// latencyPrint implements printing the histogram summary as a single report line.
+void latencyPrint(FILE *out, const char *label, const latency_histogram_t *histogram);
+
+#endif //FANTOM_HOST_LATENCY_H
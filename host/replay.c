@@ -0,0 +1,232 @@
+/**
+ * Implements replaying the APDU traces on a device with the latency report.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <pthread.h>
+
+#include "host_errors.h"
+#include "apdu.h"
+#include "replay.h"
+
+// REPLAY_MAX_LINES defines how many report lines we compare.
+#define REPLAY_MAX_LINES (256 + REPLAY_MAX_STAGES)
+
+// replay_presser_t declares the scripted presses running while the request waits for the user.
+typedef struct {
+    pthread_t thread;
+    buttons_t *buttons;
+    const trace_step_t *step;
+    int result;
+} replay_presser_t;
+
+// replay_line_t declares a single parsed report line.
+typedef struct {
+    char label[REPLAY_LABEL_SIZE];
+    uint64_t count;
+    uint64_t avgUs;
+} replay_line_t;
+
+// replayInit implements setting up an empty report.
+void replayInit(replay_report_t *report) {
+    memset(report, 0, sizeof(*report));
+}
+
+// pressButtons implements the thread pressing the scripted buttons.
+static void *pressButtons(void *arg) {
+    replay_presser_t *presser = arg;
+    presser->result = HOST_OK;
+    for (size_t i = 0; i < presser->step->buttonCount && presser->result == HOST_OK; i++) {
+        presser->result = buttonsPress(presser->buttons, presser->step->buttons[i]);
+    }
+    return NULL;
+}
+
+// replayStage implements finding, or adding, the report stage of the label.
+static latency_histogram_t *replayStage(replay_report_t *report, const char *name, const char *stage) {
+    char label[REPLAY_LABEL_SIZE];
+    snprintf(label, sizeof(label), "%s/%s", name, stage);
+
+    for (size_t i = 0; i < report->stageCount; i++) {
+        if (strcmp(report->stageLabels[i], label) == 0) {
+            return &report->stages[i];
+        }
+    }
+    if (report->stageCount >= REPLAY_MAX_STAGES) {
+        return NULL;
+    }
+    memcpy(report->stageLabels[report->stageCount], label, sizeof(label));
+    return &report->stages[report->stageCount++];
+}
+
+// replayExchange implements a single exchange of the trace with the scripted presses.
+static int replayExchange(transport_t *transport, buttons_t *buttons, const trace_step_t *step,
+                          uint8_t *response, size_t *responseLength) {
+    replay_presser_t presser = {.buttons = buttons, .step = step, .result = HOST_OK};
+    bool isPressing = false;
+    if (step->buttonCount > 0) {
+        if (buttons == NULL) {
+            return HOST_ERR_PARAMETERS;
+        }
+        if (pthread_create(&presser.thread, NULL, pressButtons, &presser) != 0) {
+            return HOST_ERR_IO;
+        }
+        isPressing = true;
+    }
+
+    int res = transportExchange(transport, step->apdu, step->apduLength, response, APDU_MAX_RESPONSE, responseLength);
+
+    if (isPressing) {
+        pthread_join(presser.thread, NULL);
+        if (res == HOST_OK) {
+            res = presser.result;
+        }
+    }
+    return res;
+}
+
+// checkResponse implements verification of the response against the trace.
+static int checkResponse(const trace_step_t *step, const uint8_t *response, size_t responseLength, uint16_t *status) {
+    size_t dataLength = responseLength;
+    int res = apduStatus(response, &dataLength, status);
+    if (res != HOST_OK) {
+        return res;
+    }
+    if (*status != step->expectedStatus) {
+        return HOST_ERR_PROTOCOL;
+    }
+    if (!step->isAnyData && (dataLength != step->expectedLength || memcmp(response, step->expected, dataLength) != 0)) {
+        return HOST_ERR_PROTOCOL;
+    }
+    return HOST_OK;
+}
+
+// replayTrace implements a single run of the trace on the device.
+int replayTrace(transport_t *transport, buttons_t *buttons, const char *name,
+                const trace_t *trace, replay_report_t *report) {
+    uint64_t stageUs = 0;
+    for (size_t i = 0; i < trace->count; i++) {
+        const trace_step_t *step = &trace->steps[i];
+
+        uint8_t response[APDU_MAX_RESPONSE];
+        size_t responseLength;
+        uint64_t start = latencyNowUs();
+        int res = replayExchange(transport, buttons, step, response, &responseLength);
+        uint64_t us = latencyNowUs() - start;
+        if (res != HOST_OK) {
+            fprintf(stderr, "%s:%d: exchange failed: %d\n", name, step->line, res);
+            return res;
+        }
+        uint16_t status = 0;
+        res = checkResponse(step, response, responseLength, &status);
+        if (res != HOST_OK) {
+            fprintf(stderr, "%s:%d: unexpected response, status 0x%04x\n", name, step->line, (unsigned) status);
+            return res;
+        }
+
+        latencyRecord(&report->instructions[step->apdu[1]], us);
+
+        // the stage ends on the change of the stage, or with the trace
+        stageUs += us;
+        if (i + 1 == trace->count || trace->steps[i + 1].stage != step->stage) {
+            latency_histogram_t *stage = replayStage(report, name, trace->stages[step->stage]);
+            if (stage != NULL) {
+                latencyRecord(stage, stageUs);
+            }
+            stageUs = 0;
+        }
+    }
+
+    report->sessions++;
+    return HOST_OK;
+}
+
+// replayPrintReport implements printing the report; one line per instruction and stage.
+void replayPrintReport(FILE *out, const replay_report_t *report) {
+    fprintf(out, "# sessions %" PRIu64 "\n", report->sessions);
+
+    for (unsigned ins = 0; ins < 256; ins++) {
+        if (report->instructions[ins].count > 0) {
+            char label[16];
+            snprintf(label, sizeof(label), "ins-0x%02x", ins);
+            latencyPrint(out, label, &report->instructions[ins]);
+        }
+    }
+    for (size_t i = 0; i < report->stageCount; i++) {
+        latencyPrint(out, report->stageLabels[i], &report->stages[i]);
+    }
+}
+
+// readReport implements parsing the report lines printed by replayPrintReport.
+static size_t readReport(FILE *in, replay_line_t *lines, size_t maxLines) {
+    char text[256];
+    size_t count = 0;
+    while (count < maxLines && fgets(text, sizeof(text), in) != NULL) {
+        replay_line_t *line = &lines[count];
+        uint64_t minUs;
+        if (text[0] != '#' &&
+            sscanf(text, "%63s n=%" SCNu64 " min=%" SCNu64 " avg=%" SCNu64,
+                   line->label, &line->count, &minUs, &line->avgUs) == 4) {
+            count++;
+        }
+    }
+    return count;
+}
+
+// findLine implements search for the report line of the given label.
+static const replay_line_t *findLine(const replay_line_t *lines, size_t count, const char *label) {
+    for (size_t i = 0; i < count; i++) {
+        if (strcmp(lines[i].label, label) == 0) {
+            return &lines[i];
+        }
+    }
+    return NULL;
+}
+
+// replayCompare implements comparing the average latencies of two reports.
+int replayCompare(FILE *baseline, FILE *current, double thresholdPercent, FILE *out) {
+    replay_line_t *before = malloc(2 * REPLAY_MAX_LINES * sizeof(replay_line_t));
+    if (before == NULL) {
+        return HOST_ERR_BUFFER;
+    }
+    replay_line_t *after = before + REPLAY_MAX_LINES;
+    size_t beforeCount = readReport(baseline, before, REPLAY_MAX_LINES);
+    size_t afterCount = readReport(current, after, REPLAY_MAX_LINES);
+
+    int regressions = 0;
+    for (size_t i = 0; i < afterCount; i++) {
+        const replay_line_t *line = &after[i];
+        const replay_line_t *base = findLine(before, beforeCount, line->label);
+        if (base == NULL) {
+            fprintf(out, "%-24s new avg=%" PRIu64 " us\n", line->label, line->avgUs);
+            continue;
+        }
+
+        // a line rising from zero has no relative change; it regressed only if it got
+        // over the floor, a few microseconds above zero are just the timer noise
+        bool isRegression;
+        if (base->avgUs == 0) {
+            isRegression = line->avgUs > REPLAY_ZERO_FLOOR_US;
+            fprintf(out, "%-24s avg %" PRIu64 " -> %" PRIu64 " us%s\n",
+                    line->label, base->avgUs, line->avgUs, isRegression ? " from zero REGRESSION" : "");
+        } else {
+            double change = 100.0 * ((double) line->avgUs - (double) base->avgUs) / (double) base->avgUs;
+            isRegression = change > thresholdPercent;
+            fprintf(out, "%-24s avg %" PRIu64 " -> %" PRIu64 " us %+.1f%%%s\n",
+                    line->label, base->avgUs, line->avgUs, change, isRegression ? " REGRESSION" : "");
+        }
+        regressions += isRegression ? 1 : 0;
+    }
+
+    // a line dropped from the current report, e.g. a renamed stage, can not be compared
+    for (size_t i = 0; i < beforeCount; i++) {
+        if (findLine(after, afterCount, before[i].label) == NULL) {
+            fprintf(out, "%-24s missing REGRESSION\n", before[i].label);
+            regressions++;
+        }
+    }
+
+    free(before);
+    return regressions;
+}
@@ -0,0 +1,53 @@
+#ifndef FANTOM_HOST_REPLAY_H
+#define FANTOM_HOST_REPLAY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "transport.h"
+#include "buttons.h"
+#include "trace.h"
+#include "latency.h"
+
+// REPLAY_MAX_STAGES defines how many trace stages a single report can hold.
+#define REPLAY_MAX_STAGES 64
+
+// REPLAY_ZERO_FLOOR_US defines the average latency a line with zero baseline
+// has to exceed to be marked as a regression.
+#define REPLAY_ZERO_FLOOR_US 1000
+
+// REPLAY_LABEL_SIZE defines the size of the report label; the trace name and the stage name.
+#define REPLAY_LABEL_SIZE 64
+
+// replay_report_t declares the latency report of the replayed traces.
+// Instructions keep the latency of each exchange, stages the total latency of each stage run.
+typedef struct {
+    latency_histogram_t instructions[256];
+    char stageLabels[REPLAY_MAX_STAGES][REPLAY_LABEL_SIZE];
+    latency_histogram_t stages[REPLAY_MAX_STAGES];
+    size_t stageCount;
+    uint64_t sessions;
+} replay_report_t;
+
+// replayInit implements setting up an empty report.
+void replayInit(replay_report_t *report);
+
+// replayTrace implements a single run of the trace on the device.
+// The buttons are optional; a trace with scripted presses fails without them.
+// Returns HOST_ERR_PROTOCOL if the response does not match the trace.
+int replayTrace(transport_t *transport, buttons_t *buttons, const char *name,
+                const trace_t *trace, replay_report_t *report);
+
+// replayPrintReport implements printing the report; one line per instruction and stage.
+// The lines are stable so reports of two commits can be diffed, or compared by replayCompare.
+void replayPrintReport(FILE *out, const replay_report_t *report);
+
+// replayCompare implements comparing the average latencies of two reports.
+// Lines slower by more than the threshold percentage are marked as regressions,
+// and so are the lines rising from a zero average over REPLAY_ZERO_FLOOR_US
+// and the baseline lines missing from the current report.
+// Returns the number of regressions found.
+int replayCompare(FILE *baseline, FILE *current, double thresholdPercent, FILE *out);
+
+#endif //FANTOM_HOST_REPLAY_H
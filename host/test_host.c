@@ -0,0 +1,686 @@
+/**
+ * Implements tests of the host library which do not need a device.
+ * The device side of the exchange is emulated by a loopback transport.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../src/errors.h"
+#include "host_errors.h"
+#include "apdu.h"
+#include "hid_framing.h"
+#include "chunk_planner.h"
+#include "latency.h"
+#include "client.h"
+#include "device_pool.h"
+#include "trace.h"
+#include "replay.h"
+
+// failures counts the failed checks
+static int failures = 0;
+
+// CHECK reports the failed condition and keeps going.
+#define CHECK(cond) \
+    do { \
+        if (!(cond)) { \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+            failures++; \
+        } \
+    } while (0)
+
+// the reference transaction of the fuzzer corpus; a contract call with zero padded data
+static const uint8_t REF_TX[] = {
+        0xf8, 0x50, 0x02, 0x84, 0x3b, 0x9a, 0xca, 0x00, 0x82, 0xab, 0xe0, 0x94, 0x76, 0xae, 0x07, 0xe6,
+        0xd2, 0x36, 0xc1, 0xae, 0x3f, 0x5c, 0x31, 0x12, 0xf3, 0x87, 0xad, 0x82, 0xc6, 0x9a, 0x24, 0x71,
+        0x88, 0x0d, 0xe0, 0xb6, 0xb3, 0xa7, 0x64, 0x00, 0x00, 0xa4, 0xc3, 0x12, 0xeb, 0x07, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x03, 0x81, 0xfa, 0x80, 0x80,
+};
+
+// buildDeployment implements building RLP of a contract deployment with the data of given size.
+static uint8_t *buildDeployment(uint32_t dataLength, uint32_t *length) {
+    uint8_t *rlp = malloc(dataLength + 64);
+    uint32_t pos = 4;
+
+    // nonce, gas price, gas limit, empty recipient, zero value
+    const uint8_t fields[] = {0x05, 0x84, 0x3b, 0x9a, 0xca, 0x00, 0x83, 0x1e, 0x84, 0x80, 0x80, 0x80};
+    memcpy(rlp + pos, fields, sizeof(fields));
+    pos += sizeof(fields);
+
+    // the byte code; mostly code with some zero padded constants
+    if (dataLength > 0xFF) {
+        rlp[pos++] = 0xb9;
+        rlp[pos++] = (uint8_t) (dataLength >> 8);
+    } else {
+        rlp[pos++] = 0xb8;
+    }
+    rlp[pos++] = (uint8_t) dataLength;
+    for (uint32_t i = 0; i < dataLength; i++) {
+        rlp[pos++] = ((i / 64) % 3 == 0) ? 0 : (uint8_t) (0x60 + i % 31);
+    }
+
+    // chain id, r, s
+    rlp[pos++] = 0x81;
+    rlp[pos++] = 0xfa;
+    rlp[pos++] = 0x80;
+    rlp[pos++] = 0x80;
+
+    // the list header
+    uint32_t payload = pos - 4;
+    rlp[1] = (uint8_t) (payload >> 16);
+    rlp[2] = (uint8_t) (payload >> 8);
+    rlp[3] = (uint8_t) payload;
+    rlp[0] = 0xfa;
+    *length = pos;
+    return rlp;
+}
+
+// testHidFraming implements round trip of APDU through the HID packets.
+static void testHidFraming() {
+    uint8_t apdu[600];
+    for (size_t i = 0; i < sizeof(apdu); i++) {
+        apdu[i] = (uint8_t) (i * 7 + 1);
+    }
+
+    for (size_t length = 0; length <= sizeof(apdu); length++) {
+        uint8_t out[600];
+        hid_unwrap_t state;
+        hidUnwrapInit(&state, out, sizeof(out));
+
+        size_t count = hidPacketCount(length);
+        int res = 0;
+        for (size_t i = 0; i < count; i++) {
+            uint8_t packet[HID_PACKET_SIZE];
+            CHECK(hidWrapPacket(apdu, length, (uint16_t) i, packet));
+            CHECK(packet[0] == 0x01 && packet[1] == 0x01 && packet[2] == HID_TAG_APDU);
+            res = hidUnwrapPacket(&state, packet);
+            CHECK(res == ((i + 1 == count) ? 1 : 0));
+        }
+        CHECK(res == 1 && state.received == length && memcmp(out, apdu, length) == 0);
+    }
+
+    // the packet of a different channel is refused
+    uint8_t packet[HID_PACKET_SIZE];
+    uint8_t out[16];
+    hid_unwrap_t state;
+    hidUnwrapInit(&state, out, sizeof(out));
+    CHECK(hidWrapPacket(apdu, 4, 0, packet));
+    packet[1] = 0x02;
+    CHECK(hidUnwrapPacket(&state, packet) == HOST_ERR_PROTOCOL);
+}
+
+// checkPlan implements verification of a planned stream of the RLP data.
+static void checkPlan(const uint8_t *rlp, uint32_t length, bool isZeroRun) {
+    planner_chunk_t chunks[256];
+    int count = plannerPlan(rlp, length, isZeroRun, chunks, 256);
+    CHECK(count > 0);
+
+    uint8_t *expanded = malloc(length);
+    uint32_t pos = 0;
+    uint32_t wire = 0;
+    for (int i = 0; i < count; i++) {
+        CHECK(chunks[i].offset == pos);
+        CHECK(chunks[i].length > 0);
+        CHECK(chunks[i].encodedLength <= PLANNER_MAX_CHUNK);
+
+        uint8_t payload[PLANNER_MAX_CHUNK];
+        int size = plannerEncode(rlp, &chunks[i], isZeroRun, payload, sizeof(payload));
+        CHECK(size == (int) chunks[i].encodedLength);
+
+        // the payload expands back to the original data
+        if (isZeroRun) {
+            int expandedSize = plannerDecodeZeroRun(payload, (size_t) size, expanded + pos, length - pos);
+            CHECK(expandedSize == (int) chunks[i].length);
+        } else {
+            memcpy(expanded + pos, payload, (size_t) size);
+        }
+        pos += chunks[i].length;
+        wire += (uint32_t) size;
+    }
+    CHECK(pos == length);
+    CHECK(memcmp(expanded, rlp, length) == 0);
+
+    // the boundary preference never costs an extra chunk
+    if (!isZeroRun) {
+        CHECK((uint32_t) count == (length + PLANNER_MAX_CHUNK - 1) / PLANNER_MAX_CHUNK);
+    }
+    free(expanded);
+}
+
+// testChunkPlanner implements tests of the chunk planner.
+static void testChunkPlanner() {
+    // small transaction fits a single chunk
+    checkPlan(REF_TX, sizeof(REF_TX), false);
+    checkPlan(REF_TX, sizeof(REF_TX), true);
+
+    planner_chunk_t chunks[4];
+    CHECK(plannerPlan(REF_TX, sizeof(REF_TX), false, chunks, 4) == 1);
+    CHECK(plannerPlan(REF_TX, sizeof(REF_TX), true, chunks, 4) == 1);
+    CHECK(chunks[0].encodedLength < sizeof(REF_TX));
+
+    // large deployments
+    uint32_t sizes[] = {200, 245, 250, 1000, 4096, 20480};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        uint32_t length;
+        uint8_t *rlp = buildDeployment(sizes[i], &length);
+        checkPlan(rlp, length, false);
+        checkPlan(rlp, length, true);
+        free(rlp);
+    }
+
+    // the first chunk ends on the second element start rather than just after its header
+    uint8_t list[548];
+    memset(list, 0x11, sizeof(list));
+    list[0] = 0xf9;
+    list[1] = 0x02;
+    list[2] = 0x21;
+    list[3] = 0xb8;
+    list[4] = 240;
+    list[245] = 0xb9;
+    list[246] = 0x01;
+    list[247] = 0x2c;
+    CHECK(plannerPlan(list, sizeof(list), false, chunks, 4) == 3);
+    CHECK(chunks[0].length == 245);
+
+    // a zero run can not straddle the chunk end; ending the first chunk on the second element
+    // start would push the run over the end of the next chunk and cost an extra chunk
+    uint8_t straddle[760];
+    memset(straddle, 0x11, sizeof(straddle));
+    straddle[0] = 0xf9;
+    straddle[1] = 0x02;
+    straddle[2] = 0xf5;
+    straddle[3] = 0xb8;
+    straddle[4] = 245;
+    straddle[250] = 0xb9;
+    straddle[251] = 0x01;
+    straddle[252] = 0xfb;
+    straddle[504] = 0x00;
+    straddle[505] = 0x00;
+    checkPlan(straddle, sizeof(straddle), true);
+    CHECK(plannerPlan(straddle, sizeof(straddle), true, chunks, 4) == 3);
+    CHECK(chunks[0].length == 255);
+
+    // zero-run payload must carry the run length
+    uint8_t bad[] = {0x01, 0x00};
+    uint8_t out[8];
+    CHECK(plannerDecodeZeroRun(bad, sizeof(bad), out, sizeof(out)) == HOST_ERR_PROTOCOL);
+}
+
+// testLatency implements tests of the latency histogram.
+static void testLatency() {
+    latency_histogram_t histogram;
+    memset(&histogram, 0, sizeof(histogram));
+    for (uint64_t us = 1; us <= 1000; us++) {
+        latencyRecord(&histogram, us);
+    }
+    CHECK(histogram.count == 1000);
+    CHECK(histogram.minUs == 1 && histogram.maxUs == 1000);
+    CHECK(latencyPercentile(&histogram, 50.0) == 512);
+    CHECK(latencyPercentile(&histogram, 100.0) == 1000);
+
+    latency_histogram_t merged;
+    memset(&merged, 0, sizeof(merged));
+    latencyMerge(&merged, &histogram);
+    latencyMerge(&merged, &histogram);
+    CHECK(merged.count == 2000 && merged.totalUs == 2 * histogram.totalUs);
+}
+
+// loopback_device_t declares the emulated device of the loopback transport.
+typedef struct {
+    uint8_t data[32768];
+    uint32_t length;
+    uint32_t expected;
+    uint32_t requests;
+} loopback_device_t;
+
+// loopback keeps the emulated device state
+static loopback_device_t loopback;
+
+// loopbackRespond implements building the emulated response with the status word.
+static size_t loopbackRespond(uint8_t *response, const uint8_t *data, size_t length, uint16_t status) {
+    if (length > 0) {
+        memcpy(response, data, length);
+    }
+    response[length] = (uint8_t) (status >> 8);
+    response[length + 1] = (uint8_t) status;
+    return length + 2;
+}
+
+// loopbackExchange implements the emulated device; it collects the streamed transaction.
+static int loopbackExchange(transport_t *transport,
+                            const uint8_t *apdu, size_t apduLength,
+                            uint8_t *response, size_t responseSize, size_t *responseLength) {
+    (void) transport;
+    (void) responseSize;
+    loopback.requests++;
+
+    // the request goes through the HID framing the same way as on the wire
+    uint8_t request[APDU_HEADER_SIZE + APDU_MAX_DATA];
+    hid_unwrap_t state;
+    hidUnwrapInit(&state, request, sizeof(request));
+    for (size_t i = 0; i < hidPacketCount(apduLength); i++) {
+        uint8_t packet[HID_PACKET_SIZE];
+        hidWrapPacket(apdu, apduLength, (uint16_t) i, packet);
+        hidUnwrapPacket(&state, packet);
+    }
+    CHECK(state.received == apduLength && request[0] == APDU_CLA && request[4] == apduLength - APDU_HEADER_SIZE);
+
+    const uint8_t *data = request + APDU_HEADER_SIZE;
+    uint8_t ins = request[1];
+    uint8_t p1 = request[2];
+    uint8_t p2 = request[3];
+    uint8_t lc = request[4];
+
+    if (ins == CLIENT_INS_VERSION) {
+        uint8_t version[] = {1, 0, 7, 0};
+        *responseLength = loopbackRespond(response, version, sizeof(version), SUCCESS);
+    } else if (ins == CLIENT_INS_SIGN_TX && p1 == 0x00) {
+        loopback.length = 0;
+        loopback.expected = 0;
+        *responseLength = loopbackRespond(response, NULL, 0, SUCCESS);
+    } else if (ins == CLIENT_INS_SIGN_TX && p1 == 0x01) {
+        // expand the chunk and learn the total length from the list header
+        int size = lc;
+        if (p2 == 0x01) {
+            size = plannerDecodeZeroRun(data, lc, loopback.data + loopback.length,
+                                        sizeof(loopback.data) - loopback.length);
+        } else {
+            memcpy(loopback.data + loopback.length, data, lc);
+        }
+        CHECK(size > 0);
+        loopback.length += (uint32_t) size;
+        if (loopback.expected == 0) {
+            uint8_t prefix = loopback.data[0];
+            uint32_t lengthSize = (prefix > 0xF7) ? prefix - 0xF7u : 0;
+            uint32_t payload = (prefix > 0xF7) ? 0 : prefix - 0xC0u;
+            for (uint32_t i = 0; i < lengthSize; i++) {
+                payload = (payload << 8) | loopback.data[1 + i];
+            }
+            loopback.expected = 1 + lengthSize + payload;
+        }
+        uint8_t stage = (loopback.length >= loopback.expected) ? 4 : 2;
+        *responseLength = loopbackRespond(response, &stage, 1, SUCCESS);
+    } else if (ins == CLIENT_INS_SIGN_TX && p1 == 0x80) {
+        uint8_t signature[65];
+        memset(signature, 0x5A, sizeof(signature));
+        signature[0] = 0x27;
+        *responseLength = loopbackRespond(response, signature, sizeof(signature), SUCCESS);
+    } else {
+        *responseLength = loopbackRespond(response, NULL, 0, ERR_UNKNOWN_INS);
+    }
+    return HOST_OK;
+}
+
+// testClient implements tests of the client over the loopback transport.
+static void testClient() {
+    transport_t transport = {.exchange = loopbackExchange, .fd = 0};
+    client_t *client = malloc(sizeof(client_t));
+    clientInit(client, &transport);
+
+    client_version_t version;
+    CHECK(clientGetVersion(client, &version) == HOST_OK);
+    CHECK(version.major == 1 && version.minor == 0 && version.patch == 7);
+
+    // unknown instruction passes the status
+    client_capabilities_t caps;
+    CHECK(clientGetCapabilities(client, &caps) == HOST_ERR_STATUS);
+    CHECK(client->lastStatus == ERR_UNKNOWN_INS);
+
+    // the streamed transaction arrives intact in both modes
+    uint32_t path[] = {0x8000002C, 0x8000003C, 0x80000000, 0, 0};
+    uint32_t length;
+    uint8_t *rlp = buildDeployment(20480, &length);
+    for (int isZeroRun = 0; isZeroRun <= 1; isZeroRun++) {
+        client_signature_t signature;
+        loopback.requests = 0;
+        CHECK(clientSignTransaction(client, path, 5, rlp, length, isZeroRun, &signature) == HOST_OK);
+        CHECK(signature.v == 0x27 && signature.r[0] == 0x5A);
+        CHECK(loopback.length == length && memcmp(loopback.data, rlp, length) == 0);
+        CHECK(!isZeroRun || loopback.requests < 2 + (length + 254) / 255);
+    }
+    free(rlp);
+
+    CHECK(client->latency[CLIENT_INS_SIGN_TX].count > 0);
+    free(client);
+}
+
+// POOL_FAKE_LATENCY_US defines the artificial latency of a fake pool device exchange.
+#define POOL_FAKE_LATENCY_US 2000
+
+// POOL_FAKE_BROKEN defines the seed of a fake device failing on the transport level.
+#define POOL_FAKE_BROKEN 0xFF
+
+// poolFakeExchange implements a fake device of the pool; the transport fd is the device seed.
+// The address is made of the seed and the last path index so the results can be checked.
+static int poolFakeExchange(transport_t *transport,
+                            const uint8_t *apdu, size_t apduLength,
+                            uint8_t *response, size_t responseSize, size_t *responseLength) {
+    (void) responseSize;
+    usleep(POOL_FAKE_LATENCY_US);
+    if (transport->fd == POOL_FAKE_BROKEN) {
+        return HOST_ERR_IO;
+    }
+
+    // the request is [header][depth][path] and we only know the Get Address
+    if (apdu[1] != CLIENT_INS_GET_ADDR || apduLength < APDU_HEADER_SIZE + 1 + 4) {
+        *responseLength = loopbackRespond(response, NULL, 0, ERR_UNKNOWN_INS);
+        return HOST_OK;
+    }
+
+    uint8_t address[1 + CLIENT_ADDRESS_SIZE];
+    memset(address, 0, sizeof(address));
+    address[0] = CLIENT_ADDRESS_SIZE;
+    address[1] = (uint8_t) transport->fd;
+    memcpy(address + 1 + CLIENT_ADDRESS_SIZE - 4, apdu + apduLength - 4, 4);
+    *responseLength = loopbackRespond(response, address, sizeof(address), SUCCESS);
+    return HOST_OK;
+}
+
+// poolFakeAddress implements the address the fake device of the seed gives for the index.
+static void poolFakeAddress(uint8_t seed, uint32_t index, uint8_t address[CLIENT_ADDRESS_SIZE]) {
+    memset(address, 0, CLIENT_ADDRESS_SIZE);
+    address[0] = seed;
+    address[CLIENT_ADDRESS_SIZE - 4] = (uint8_t) (index >> 24);
+    address[CLIENT_ADDRESS_SIZE - 3] = (uint8_t) (index >> 16);
+    address[CLIENT_ADDRESS_SIZE - 2] = (uint8_t) (index >> 8);
+    address[CLIENT_ADDRESS_SIZE - 1] = (uint8_t) index;
+}
+
+// poolFakeSetup implements a pool of fake devices with the given seeds.
+static void poolFakeSetup(device_pool_t *pool, const uint8_t *seeds, size_t count) {
+    CHECK(poolInit(pool) == HOST_OK);
+    for (size_t i = 0; i < count; i++) {
+        transport_t transport = {.exchange = poolFakeExchange, .fd = seeds[i]};
+        CHECK(poolAddTransport(pool, &transport) == HOST_OK);
+    }
+}
+
+// poolTimeDerive implements timing a parallel derivation of addresses on the pool of the same devices.
+static uint64_t poolTimeDerive(size_t devices, uint32_t count) {
+    uint8_t seeds[POOL_MAX_DEVICES];
+    memset(seeds, 1, sizeof(seeds));
+
+    device_pool_t *pool = malloc(sizeof(device_pool_t));
+    poolFakeSetup(pool, seeds, devices);
+    CHECK(poolIdentify(pool) == HOST_OK);
+
+    uint8_t (*addresses)[CLIENT_ADDRESS_SIZE] = malloc(count * CLIENT_ADDRESS_SIZE);
+    uint32_t chain[] = {0x8000002C, 0x8000003C, 0x80000000, 0};
+    uint64_t start = latencyNowUs();
+    CHECK(poolDeriveAddresses(pool, NULL, chain, 100, count, addresses) == HOST_OK);
+    uint64_t elapsed = latencyNowUs() - start;
+
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t expected[CLIENT_ADDRESS_SIZE];
+        poolFakeAddress(1, 100 + i, expected);
+        CHECK(memcmp(addresses[i], expected, CLIENT_ADDRESS_SIZE) == 0);
+    }
+
+    free(addresses);
+    poolClose(pool);
+    free(pool);
+    return elapsed;
+}
+
+// testPool implements tests of the device pool over the fake devices.
+static void testPool() {
+    // two devices of seed 1, one of seed 2 and a broken one
+    const uint8_t seeds[] = {1, 1, 2, POOL_FAKE_BROKEN};
+    device_pool_t *pool = malloc(sizeof(device_pool_t));
+    poolFakeSetup(pool, seeds, sizeof(seeds));
+
+    CHECK(poolIdentify(pool) == HOST_ERR_IO);
+    CHECK(pool->devices[0].hasIdentity && pool->devices[2].hasIdentity && !pool->devices[3].hasIdentity);
+    CHECK(pool->devices[0].identity[0] == 1 && pool->devices[2].identity[0] == 2);
+
+    // the broken device drops out after repeated failures; the identification was the first one
+    for (int i = 1; i < POOL_MAX_FAILURES; i++) {
+        pool_device_t *device = &pool->devices[3];
+        CHECK(device->isHealthy);
+        device->isBusy = true;
+        uint8_t address[CLIENT_ADDRESS_SIZE];
+        uint32_t path[] = {0x8000002C, 0x8000003C, 0x80000000, 0, 0};
+        poolRelease(pool, device, clientGetAddress(device->client, path, 5, address));
+    }
+    CHECK(!pool->devices[3].isHealthy && pool->devices[3].failures == POOL_MAX_FAILURES);
+
+    // status errors are counted, but keep the device healthy
+    pool_device_t *device = poolAcquire(pool, pool->devices[2].identity);
+    CHECK(device == &pool->devices[2]);
+    client_version_t version;
+    poolRelease(pool, device, clientGetVersion(device->client, &version));
+    CHECK(device->isHealthy && device->statusErrors[ERR_UNKNOWN_INS - _ERR_PASS_FROM] == 1);
+
+    // the session goes to the devices holding the address and is pinned to them
+    uint32_t path[] = {0x8000002C, 0x8000003C, 0x80000000, 0, 7};
+    uint8_t address[CLIENT_ADDRESS_SIZE];
+    poolFakeAddress(2, 7, address);
+    device = poolAcquireForAddress(pool, path, 5, address);
+    CHECK(device == &pool->devices[2] && pool->pinCount == 1);
+    uint64_t requests = device->client->latency[CLIENT_INS_GET_ADDR].count;
+    poolRelease(pool, device, HOST_OK);
+    device = poolAcquireForAddress(pool, path, 5, address);
+    CHECK(device == &pool->devices[2] && device->client->latency[CLIENT_INS_GET_ADDR].count == requests);
+    poolRelease(pool, device, HOST_OK);
+
+    // the latency of a busy device is not read while its worker runs
+    device = poolAcquire(pool, pool->devices[2].identity);
+    char *stats = NULL;
+    size_t statsSize = 0;
+    FILE *out = open_memstream(&stats, &statsSize);
+    poolPrintStats(pool, out);
+    fclose(out);
+    CHECK(strstr(stats, "device 2 (busy)\n") != NULL && strstr(stats, "device 0 ") != NULL);
+    free(stats);
+    poolRelease(pool, device, HOST_OK);
+
+    // unknown address has no device
+    poolFakeAddress(3, 7, address);
+    CHECK(poolAcquireForAddress(pool, path, 5, address) == NULL);
+
+    // no healthy device of the identity
+    CHECK(poolAcquire(pool, pool->devices[3].identity) == NULL);
+    poolClose(pool);
+    free(pool);
+
+    // the derivation scales with the devices; a loose bound keeps the check stable on busy machines
+    uint32_t count = 64;
+    uint64_t single = poolTimeDerive(1, count);
+    uint64_t quad = poolTimeDerive(4, count);
+    CHECK(single >= count * POOL_FAKE_LATENCY_US);
+    CHECK(quad * 2 < single);
+}
+
+// fakePresses counts the buttons pressed on the fake buttons.
+static int fakePresses = 0;
+
+// fakePress implements the fake buttons of the replay tests.
+static int fakePress(buttons_t *buttons, char button) {
+    (void) buttons;
+    CHECK(button == TRACE_BUTTON_LEFT || button == TRACE_BUTTON_RIGHT || button == TRACE_BUTTON_BOTH);
+    fakePresses++;
+    return HOST_OK;
+}
+
+// loadTrace implements parsing of the trace given as text.
+static int loadTrace(trace_t *trace, const char *text, int *errorLine) {
+    FILE *in = fmemopen((void *) text, strlen(text), "r");
+    int res = traceLoad(trace, in, errorLine);
+    fclose(in);
+    return res;
+}
+
+// loadTraceFile implements parsing of the trace shipped with the benchmark.
+static int loadTraceFile(trace_t *trace, const char *name) {
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.trace", HOST_TRACES_DIR, name);
+    FILE *in = fopen(path, "r");
+    if (in == NULL) {
+        return HOST_ERR_OPEN;
+    }
+    int line;
+    int res = traceLoad(trace, in, &line);
+    fclose(in);
+    return res;
+}
+
+// testTrace implements tests of the trace file format.
+static void testTrace() {
+    trace_t trace;
+    int line;
+    CHECK(loadTrace(&trace,
+                    "# comment\n"
+                    "> e001000000\n"
+                    "< 01000700 9000\n"
+                    "@ sign\n"
+                    "> e020800000\n"
+                    "! right*2 both\n"
+                    "< * 9000\n"
+                    "> e02001000101\n"
+                    "< 6e06\n", &line) == HOST_OK);
+    CHECK(trace.count == 3 && trace.stageCount == 2 && strcmp(trace.stages[1], "sign") == 0);
+    CHECK(trace.steps[0].stage == 0 && trace.steps[0].expectedLength == 4 && trace.steps[0].expectedStatus == 0x9000);
+    CHECK(trace.steps[1].stage == 1 && trace.steps[1].isAnyData && trace.steps[1].buttonCount == 3);
+    CHECK(memcmp(trace.steps[1].buttons, "RRB", 3) == 0);
+    CHECK(trace.steps[2].apduLength == 6 && trace.steps[2].expectedStatus == ERR_INVALID_DATA);
+    traceFree(&trace);
+
+    // broken traces tell the line
+    CHECK(loadTrace(&trace, "> e001000000\n> e001000000\n", &line) == HOST_ERR_PARAMETERS && line == 2);
+    CHECK(loadTrace(&trace, "> e00100000200\n< 9000\n", &line) == HOST_ERR_PARAMETERS && line == 1);
+    CHECK(loadTrace(&trace, "> e001000000\n! middle\n", &line) == HOST_ERR_PARAMETERS && line == 2);
+    CHECK(loadTrace(&trace, "> e001000000\n", &line) == HOST_ERR_PARAMETERS);
+
+    // the recorded exchange reads back
+    char *text = NULL;
+    size_t size = 0;
+    FILE *out = open_memstream(&text, &size);
+    const uint8_t apdu[] = {0xE0, 0x01, 0x00, 0x00, 0x00};
+    const uint8_t response[] = {0x01, 0x00, 0x07, 0x00, 0x90, 0x00};
+    traceWriteExchange(out, apdu, sizeof(apdu), response, sizeof(response));
+    fclose(out);
+    CHECK(loadTrace(&trace, text, &line) == HOST_OK);
+    CHECK(trace.count == 1 && trace.steps[0].expectedLength == 4 && trace.steps[0].expected[2] == 0x07);
+    traceFree(&trace);
+    free(text);
+
+    // all the shipped traces parse
+    const char *names[] = {"transfer", "erc20_transfer", "sfc_delegate", "deploy_20k", "address_scan"};
+    for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++) {
+        CHECK(loadTraceFile(&trace, names[i]) == HOST_OK);
+        CHECK(trace.count > 0);
+        traceFree(&trace);
+    }
+}
+
+// testReplay implements tests of the replay over the loopback transport.
+static void testReplay() {
+    transport_t transport = {.exchange = loopbackExchange, .fd = 0};
+    buttons_t buttons = {.press = fakePress, .fd = 0, .delayMs = 0};
+    replay_report_t *report = malloc(sizeof(replay_report_t));
+    replayInit(report);
+
+    // the shipped signing sessions replay on the emulated device
+    trace_t trace;
+    CHECK(loadTraceFile(&trace, "transfer") == HOST_OK);
+    fakePresses = 0;
+    CHECK(replayTrace(&transport, &buttons, "transfer", &trace, report) == HOST_OK);
+    CHECK(fakePresses == 6);
+
+    // the scripted presses need the buttons
+    CHECK(replayTrace(&transport, NULL, "transfer", &trace, report) == HOST_ERR_PARAMETERS);
+    traceFree(&trace);
+
+    CHECK(loadTraceFile(&trace, "deploy_20k") == HOST_OK);
+    CHECK(replayTrace(&transport, &buttons, "deploy_20k", &trace, report) == HOST_OK);
+    CHECK(replayTrace(&transport, &buttons, "deploy_20k", &trace, report) == HOST_OK);
+    traceFree(&trace);
+
+    CHECK(report->sessions == 3);
+    CHECK(report->instructions[CLIENT_INS_VERSION].count == 2);
+    CHECK(report->instructions[CLIENT_INS_SIGN_TX].count == 3 + 2 * (2 + (20480 + 254) / 255));
+    CHECK(report->stageCount == 7 && strcmp(report->stageLabels[5], "deploy_20k/stream") == 0);
+    CHECK(report->stages[5].count == 2);
+
+    // unexpected response fails the replay
+    CHECK(loadTrace(&trace, "> e001000000\n< 01000800 9000\n", &(int) {0}) == HOST_OK);
+    CHECK(replayTrace(&transport, &buttons, "version", &trace, report) == HOST_ERR_PROTOCOL);
+    traceFree(&trace);
+
+    // the printed report parses back line by line
+    char *text = NULL;
+    size_t size = 0;
+    FILE *out = open_memstream(&text, &size);
+    replayPrintReport(out, report);
+    fclose(out);
+    FILE *sink = fopen("/dev/null", "w");
+    FILE *printed = fmemopen(text, size, "r");
+    FILE *same = fmemopen(text, size, "r");
+    CHECK(replayCompare(printed, same, 10.0, sink) == 0);
+    fclose(same);
+    fclose(printed);
+    free(text);
+
+    // the comparison runs on fixed reports, the live timing over loopback is too noisy
+    const char *baselineText =
+            "# latency report\n"
+            "ins-0x01                 n=2        min=0        avg=0        p50<=1 p99<=1 max=1 us\n"
+            "ins-0x02                 n=2        min=0        avg=0        p50<=1 p99<=1 max=1 us\n"
+            "ins-0x04                 n=10       min=100      avg=200      p50<=256 p99<=512 max=400 us\n"
+            "transfer/review          n=1        min=5000     avg=5000     p50<=8192 p99<=8192 max=5000 us\n";
+    const char *sameText =
+            "ins-0x01                 n=2        min=0        avg=0        p50<=1 p99<=1 max=1 us\n"
+            "ins-0x02                 n=2        min=0        avg=0        p50<=1 p99<=1 max=1 us\n"
+            "ins-0x04                 n=10       min=100      avg=215      p50<=256 p99<=512 max=400 us\n"
+            "transfer/review          n=1        min=5000     avg=4000     p50<=8192 p99<=8192 max=5000 us\n";
+    const char *slowerText =
+            "ins-0x01                 n=2        min=0        avg=3        p50<=4 p99<=4 max=4 us\n"
+            "ins-0x02                 n=2        min=2000     avg=2000     p50<=2048 p99<=2048 max=2000 us\n"
+            "ins-0x04                 n=10       min=100      avg=300      p50<=512 p99<=512 max=400 us\n"
+            "transfer/review          n=1        min=5000     avg=5000     p50<=8192 p99<=8192 max=5000 us\n"
+            "sfc_delegate/review      n=1        min=5000     avg=5000     p50<=8192 p99<=8192 max=5000 us\n";
+    const char *droppedText =
+            "ins-0x01                 n=2        min=0        avg=0        p50<=1 p99<=1 max=1 us\n"
+            "ins-0x02                 n=2        min=0        avg=0        p50<=1 p99<=1 max=1 us\n"
+            "ins-0x04                 n=10       min=100      avg=200      p50<=256 p99<=512 max=400 us\n";
+
+    FILE *baseline = fmemopen((void *) baselineText, strlen(baselineText), "r");
+    FILE *current = fmemopen((void *) sameText, strlen(sameText), "r");
+    CHECK(replayCompare(baseline, current, 10.0, sink) == 0);
+    fclose(current);
+
+    // both the rise from zero over the floor and the relative rise count,
+    // the noise over zero and the new line do not
+    rewind(baseline);
+    current = fmemopen((void *) slowerText, strlen(slowerText), "r");
+    CHECK(replayCompare(baseline, current, 10.0, sink) == 2);
+    fclose(current);
+
+    // the line dropped from the current report counts
+    rewind(baseline);
+    current = fmemopen((void *) droppedText, strlen(droppedText), "r");
+    CHECK(replayCompare(baseline, current, 10.0, sink) == 1);
+    fclose(current);
+    fclose(baseline);
+    fclose(sink);
+    free(report);
+}
+
+int main() {
+    testHidFraming();
+    testChunkPlanner();
+    testLatency();
+    testClient();
+    testPool();
+    testTrace();
+    testReplay();
+
+    if (failures > 0) {
+        fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    printf("all host checks passed\n");
+    return 0;
+}
@@ -0,0 +1,254 @@
+/**
+ * Implements the APDU trace files of recorded sessions.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "host_errors.h"
+#include "trace.h"
+
+// TRACE_LINE_SIZE defines the max length of a trace line; a full APDU in hex fits easily.
+#define TRACE_LINE_SIZE 1024
+
+// skipSpaces implements skipping the white space of the line.
+static char *skipSpaces(char *str) {
+    while (*str != '\0' && isspace((unsigned char) *str)) {
+        str++;
+    }
+    return str;
+}
+
+// parseHexBytes implements decoding of the hex token; spaces are not allowed inside.
+static int parseHexBytes(const char *str, size_t strLength, uint8_t *out, size_t outSize) {
+    if (strLength % 2 != 0 || strLength / 2 > outSize) {
+        return HOST_ERR_PARAMETERS;
+    }
+    for (size_t i = 0; i < strLength / 2; i++) {
+        unsigned value;
+        if (!isxdigit((unsigned char) str[2 * i]) || !isxdigit((unsigned char) str[2 * i + 1]) ||
+            sscanf(str + 2 * i, "%2x", &value) != 1) {
+            return HOST_ERR_PARAMETERS;
+        }
+        out[i] = (uint8_t) value;
+    }
+    return (int) (strLength / 2);
+}
+
+// tokenLength implements the length of the token at the string start.
+static size_t tokenLength(const char *str) {
+    size_t length = 0;
+    while (str[length] != '\0' && !isspace((unsigned char) str[length])) {
+        length++;
+    }
+    return length;
+}
+
+// parseButtons implements parsing of the scripted button presses.
+static int parseButtons(char *str, trace_step_t *step) {
+    for (str = skipSpaces(str); *str != '\0'; str = skipSpaces(str)) {
+        size_t length = tokenLength(str);
+
+        // the optional repeat count
+        unsigned repeat = 1;
+        char *star = memchr(str, '*', length);
+        size_t nameLength = (star != NULL) ? (size_t) (star - str) : length;
+        if (star != NULL && (sscanf(star + 1, "%u", &repeat) != 1 || repeat == 0)) {
+            return HOST_ERR_PARAMETERS;
+        }
+
+        char button;
+        if (nameLength == 4 && strncmp(str, "left", 4) == 0) {
+            button = TRACE_BUTTON_LEFT;
+        } else if (nameLength == 5 && strncmp(str, "right", 5) == 0) {
+            button = TRACE_BUTTON_RIGHT;
+        } else if (nameLength == 4 && strncmp(str, "both", 4) == 0) {
+            button = TRACE_BUTTON_BOTH;
+        } else {
+            return HOST_ERR_PARAMETERS;
+        }
+
+        if (repeat > TRACE_MAX_BUTTONS - step->buttonCount) {
+            return HOST_ERR_BUFFER;
+        }
+        memset(step->buttons + step->buttonCount, button, repeat);
+        step->buttonCount += repeat;
+        str += length;
+    }
+    return HOST_OK;
+}
+
+// parseResponse implements parsing of the expected response.
+static int parseResponse(char *str, trace_step_t *step) {
+    str = skipSpaces(str);
+    size_t length = tokenLength(str);
+    if (length == 0) {
+        return HOST_ERR_PARAMETERS;
+    }
+
+    // the data is optional; a lone token is the status word
+    char *status = skipSpaces(str + length);
+    if (*status == '\0') {
+        status = str;
+        step->expectedLength = 0;
+    } else if (length == 1 && str[0] == '*') {
+        step->isAnyData = true;
+    } else {
+        int res = parseHexBytes(str, length, step->expected, sizeof(step->expected));
+        if (res < 0) {
+            return res;
+        }
+        step->expectedLength = (size_t) res;
+    }
+
+    uint8_t sw[APDU_STATUS_SIZE];
+    size_t statusLength = tokenLength(status);
+    if (parseHexBytes(status, statusLength, sw, sizeof(sw)) != APDU_STATUS_SIZE ||
+        *skipSpaces(status + statusLength) != '\0') {
+        return HOST_ERR_PARAMETERS;
+    }
+    step->expectedStatus = (uint16_t) ((sw[0] << 8) | sw[1]);
+    return HOST_OK;
+}
+
+// traceAddStep implements appending a new empty step to the trace.
+static trace_step_t *traceAddStep(trace_t *trace) {
+    if (trace->count == trace->capacity) {
+        size_t capacity = (trace->capacity > 0) ? 2 * trace->capacity : 64;
+        trace_step_t *steps = realloc(trace->steps, capacity * sizeof(trace_step_t));
+        if (steps == NULL) {
+            return NULL;
+        }
+        trace->steps = steps;
+        trace->capacity = capacity;
+    }
+
+    trace_step_t *step = &trace->steps[trace->count++];
+    memset(step, 0, sizeof(*step));
+    return step;
+}
+
+// traceStage implements finding, or adding, the stage of the name.
+static int traceStage(trace_t *trace, const char *name, size_t length) {
+    if (length == 0 || length >= TRACE_STAGE_NAME_SIZE) {
+        return HOST_ERR_PARAMETERS;
+    }
+    for (size_t i = 0; i < trace->stageCount; i++) {
+        if (strlen(trace->stages[i]) == length && strncmp(trace->stages[i], name, length) == 0) {
+            return (int) i;
+        }
+    }
+    if (trace->stageCount >= TRACE_MAX_STAGES) {
+        return HOST_ERR_BUFFER;
+    }
+    memcpy(trace->stages[trace->stageCount], name, length);
+    trace->stages[trace->stageCount][length] = '\0';
+    return (int) trace->stageCount++;
+}
+
+// traceLoad implements parsing of the trace file.
+int traceLoad(trace_t *trace, FILE *in, int *errorLine) {
+    memset(trace, 0, sizeof(*trace));
+    *errorLine = 0;
+
+    // exchanges before the first stage marker go to the default stage
+    traceStage(trace, "main", 4);
+
+    char line[TRACE_LINE_SIZE];
+    int stage = 0;
+    bool isPending = false;
+    int res = HOST_OK;
+    while (res == HOST_OK && fgets(line, sizeof(line), in) != NULL) {
+        (*errorLine)++;
+        if (strchr(line, '\n') == NULL && !feof(in)) {
+            res = HOST_ERR_BUFFER;
+            break;
+        }
+
+        char *str = skipSpaces(line);
+        char kind = *str;
+        if (kind == '\0' || kind == '#') {
+            continue;
+        }
+        str = skipSpaces(str + 1);
+
+        trace_step_t *last = (trace->count > 0) ? &trace->steps[trace->count - 1] : NULL;
+        switch (kind) {
+            case '@':
+                stage = traceStage(trace, str, tokenLength(str));
+                res = (stage < 0) ? stage : (isPending ? HOST_ERR_PARAMETERS : HOST_OK);
+                break;
+            case '>': {
+                trace_step_t *step = isPending ? NULL : traceAddStep(trace);
+                if (step == NULL) {
+                    res = isPending ? HOST_ERR_PARAMETERS : HOST_ERR_BUFFER;
+                    break;
+                }
+                step->line = *errorLine;
+                step->stage = (uint8_t) stage;
+                int length = parseHexBytes(str, tokenLength(str), step->apdu, sizeof(step->apdu));
+                if (length < (int) APDU_HEADER_SIZE || (size_t) length != APDU_HEADER_SIZE + (size_t) step->apdu[4]) {
+                    res = HOST_ERR_PARAMETERS;
+                    break;
+                }
+                step->apduLength = (size_t) length;
+                isPending = true;
+                break;
+            }
+            case '!':
+                res = isPending ? parseButtons(str, last) : HOST_ERR_PARAMETERS;
+                break;
+            case '<':
+                res = isPending ? parseResponse(str, last) : HOST_ERR_PARAMETERS;
+                isPending = false;
+                break;
+            default:
+                res = HOST_ERR_PARAMETERS;
+                break;
+        }
+    }
+
+    // the last request must have its response
+    if (res == HOST_OK && isPending) {
+        res = HOST_ERR_PARAMETERS;
+    }
+    if (res != HOST_OK) {
+        traceFree(trace);
+        return res;
+    }
+    *errorLine = 0;
+    return HOST_OK;
+}
+
+// traceFree implements releasing the steps of the trace.
+void traceFree(trace_t *trace) {
+    free(trace->steps);
+    trace->steps = NULL;
+    trace->count = 0;
+    trace->capacity = 0;
+}
+
+// writeHex implements writing the buffer in hex.
+static void writeHex(FILE *out, const uint8_t *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        fprintf(out, "%02x", data[i]);
+    }
+}
+
+// traceWriteExchange implements writing a single APDU exchange to the trace file being recorded.
+void traceWriteExchange(FILE *out, const uint8_t *apdu, size_t apduLength,
+                        const uint8_t *response, size_t responseLength) {
+    fprintf(out, "> ");
+    writeHex(out, apdu, apduLength);
+    fprintf(out, "\n< ");
+
+    // the status word closes the response
+    if (responseLength > APDU_STATUS_SIZE) {
+        writeHex(out, response, responseLength - APDU_STATUS_SIZE);
+        fprintf(out, " ");
+    }
+    if (responseLength >= APDU_STATUS_SIZE) {
+        writeHex(out, response + responseLength - APDU_STATUS_SIZE, APDU_STATUS_SIZE);
+    }
+    fprintf(out, "\n");
+}
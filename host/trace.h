@@ -0,0 +1,67 @@
+#ifndef FANTOM_HOST_TRACE_H
+#define FANTOM_HOST_TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+#include "apdu.h"
+
+// TRACE_MAX_BUTTONS defines how many button presses can be scripted for a single request.
+#define TRACE_MAX_BUTTONS 32
+
+// TRACE_MAX_STAGES defines how many stages a single trace can define.
+#define TRACE_MAX_STAGES 32
+
+// TRACE_STAGE_NAME_SIZE defines the size of the stage name including the terminating zero.
+#define TRACE_STAGE_NAME_SIZE 24
+
+// trace_button_t declares the buttons we can press on the device.
+// The values are the characters used in the trace file.
+typedef enum {
+    TRACE_BUTTON_LEFT = 'L',
+    TRACE_BUTTON_RIGHT = 'R',
+    TRACE_BUTTON_BOTH = 'B',
+} trace_button_t;
+
+// trace_step_t declares a single APDU exchange of the trace.
+typedef struct {
+    int line;
+    uint8_t stage;
+    uint8_t apdu[APDU_HEADER_SIZE + APDU_MAX_DATA];
+    size_t apduLength;
+    char buttons[TRACE_MAX_BUTTONS];
+    size_t buttonCount;
+    uint8_t expected[APDU_MAX_RESPONSE - APDU_STATUS_SIZE];
+    size_t expectedLength;
+    bool isAnyData;
+    uint16_t expectedStatus;
+} trace_step_t;
+
+// trace_t declares a recorded APDU session.
+typedef struct {
+    char stages[TRACE_MAX_STAGES][TRACE_STAGE_NAME_SIZE];
+    size_t stageCount;
+    trace_step_t *steps;
+    size_t count;
+    size_t capacity;
+} trace_t;
+
+// traceLoad implements parsing of the trace file.
+// The file is line oriented, empty lines and lines starting with # are ignored:
+//   @ <stage>                 the next exchanges belong to the stage, e.g. "@ stream"
+//   > <apdu hex>              the request sent to the device
+//   ! <button> ...            buttons pressed while the request waits; left, right, both, or e.g. right*3
+//   < <data hex | *> <status> the expected response data and the status word; * accepts any data
+// Each request must be followed by its response. On failure the number of the offending line is set.
+int traceLoad(trace_t *trace, FILE *in, int *errorLine);
+
+// traceFree implements releasing the steps of the trace.
+void traceFree(trace_t *trace);
+
+// traceWriteExchange implements writing a single APDU exchange to the trace file being recorded.
+void traceWriteExchange(FILE *out, const uint8_t *apdu, size_t apduLength,
+                        const uint8_t *response, size_t responseLength);
+
+#endif //FANTOM_HOST_TRACE_H
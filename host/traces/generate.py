@@ -0,0 +1,170 @@
+#!/usr/bin/env python3
+"""
+Generates the APDU traces of typical sessions for the replay benchmark.
+
+The traces follow the default review flow on a device with the expert mode off;
+each review screen and the final prompt is confirmed by pressing both buttons.
+Signatures and addresses depend on the device seed, so their data is not checked.
+
+Usage: python3 generate.py [output directory]
+"""
+import os
+import struct
+import sys
+
+CLA = 0xE0
+INS_VERSION = 0x01
+INS_GET_ADDR = 0x11
+INS_VERIFY_ADDRESSES = 0x13
+INS_SIGN_TX = 0x20
+
+CHAIN_ID = 250
+SFC_ADDRESS = bytes.fromhex("fc00face00000000000000000000000000000000")
+TOKEN_ADDRESS = bytes.fromhex("04068da6c83afcfa0e13ba15a6696662335d5b75")
+RECIPIENT = bytes.fromhex("76ae07e6d236c1ae3f5c3112f387ad82c69a2471")
+
+
+def hardened(index):
+    return index | 0x80000000
+
+
+def encode_path(path):
+    return bytes([len(path)]) + b"".join(struct.pack(">I", i) for i in path)
+
+
+def rlp_int(value):
+    if value == 0:
+        return b""
+    return value.to_bytes((value.bit_length() + 7) // 8, "big")
+
+
+def rlp_length(length, offset):
+    if length < 56:
+        return bytes([offset + length])
+    size = rlp_int(length)
+    return bytes([offset + 55 + len(size)]) + size
+
+
+def rlp_item(data):
+    if len(data) == 1 and data[0] < 0x80:
+        return data
+    return rlp_length(len(data), 0x80) + data
+
+
+def rlp_list(items):
+    payload = b"".join(rlp_item(i) for i in items)
+    return rlp_length(len(payload), 0xC0) + payload
+
+
+def legacy_tx(nonce, gas_price, gas, to, value, data):
+    # EIP-155 signing payload; the chain id with empty r and s
+    return rlp_list([rlp_int(nonce), rlp_int(gas_price), rlp_int(gas), to, rlp_int(value), data,
+                     rlp_int(CHAIN_ID), b"", b""])
+
+
+class Trace:
+    def __init__(self, description):
+        self.lines = ["# " + description]
+
+    def stage(self, name):
+        self.lines.append("")
+        self.lines.append("@ " + name)
+
+    def exchange(self, ins, p1, p2, data=b"", buttons=None, response="*", status=0x9000):
+        apdu = bytes([CLA, ins, p1, p2, len(data)]) + data
+        self.lines.append("> " + apdu.hex())
+        if buttons:
+            self.lines.append("! " + buttons)
+        expected = (response + " ") if response else ""
+        self.lines.append("< %s%04x" % (expected, status))
+
+    def sign(self, path, rlp, review):
+        self.stage("init")
+        self.exchange(INS_SIGN_TX, 0x00, 0x00, encode_path(path), buttons="both", response="")
+
+        self.stage("stream")
+        for offset in range(0, len(rlp), 255):
+            chunk = rlp[offset:offset + 255]
+            stage = "04" if offset + len(chunk) == len(rlp) else "02"
+            self.exchange(INS_SIGN_TX, 0x01, 0x00, chunk, response=stage)
+
+        self.stage("review")
+        self.exchange(INS_SIGN_TX, 0x80, 0x00, buttons="both*%d" % review)
+
+    def write(self, path):
+        with open(path, "w") as f:
+            f.write("\n".join(self.lines) + "\n")
+
+
+def account_path(index=0):
+    return [hardened(44), hardened(60), hardened(0), 0, index]
+
+
+def transfer():
+    trace = Trace("plain FTM transfer; 1.5 FTM to an address")
+    trace.stage("version")
+    trace.exchange(INS_VERSION, 0x00, 0x00)
+    rlp = legacy_tx(12, 50 * 10 ** 9, 21000, RECIPIENT, 15 * 10 ** 17, b"")
+    # to, from, amount, fee, confirm
+    trace.sign(account_path(), rlp, 5)
+    return trace
+
+
+def erc20_transfer():
+    trace = Trace("ERC-20 token transfer call")
+    data = bytes.fromhex("a9059cbb") + bytes(12) + RECIPIENT + (25 * 10 ** 18).to_bytes(32, "big")
+    rlp = legacy_tx(13, 50 * 10 ** 9, 65000, TOKEN_ADDRESS, 0, data)
+    # to, from, amount, fee, method, data digest, confirm
+    trace.sign(account_path(), rlp, 7)
+    return trace
+
+
+def sfc_delegate():
+    trace = Trace("SFC staking delegation call")
+    data = bytes.fromhex("9fa6dd35") + (12).to_bytes(32, "big")
+    rlp = legacy_tx(14, 50 * 10 ** 9, 250000, SFC_ADDRESS, 500 * 10 ** 18, data)
+    # to, from, amount, fee, method, data digest, confirm
+    trace.sign(account_path(), rlp, 7)
+    return trace
+
+
+def deployment():
+    trace = Trace("contract deployment with 20 KB of byte code")
+    code = bytes((0 if (i // 64) % 3 == 0 else 0x60 + i % 31) for i in range(20480))
+    rlp = legacy_tx(15, 50 * 10 ** 9, 6000000, b"", 0, code)
+    trace.sign(account_path(), rlp, 6)
+    return trace
+
+
+def address_scan():
+    trace = Trace("wallet restore; address derivation and verification of the first 1000 addresses")
+    trace.stage("derive")
+    for index in range(20):
+        trace.exchange(INS_GET_ADDR, 0x01, 0x00, encode_path(account_path(index)))
+
+    trace.stage("verify-init")
+    chain = [hardened(44), hardened(60), hardened(0), 0]
+    # chain node path, confirm
+    trace.exchange(INS_VERIFY_ADDRESSES, 0x00, 0x00, encode_path(chain), buttons="both*2", response="")
+
+    # the addresses are not expected to match, the whole range is derived
+    trace.stage("verify")
+    for first in range(0, 1000, 10):
+        pairs = b"".join(struct.pack(">I", first + i) + TOKEN_ADDRESS for i in range(10))
+        trace.exchange(INS_VERIFY_ADDRESSES, 0x01, 0x00, pairs, response="0a0000")
+
+    trace.stage("verify-finish")
+    trace.exchange(INS_VERIFY_ADDRESSES, 0x80, 0x00)
+    return trace
+
+
+def main():
+    out = sys.argv[1] if len(sys.argv) > 1 else os.path.dirname(os.path.abspath(__file__))
+    for name, build in [("transfer", transfer), ("erc20_transfer", erc20_transfer),
+                        ("sfc_delegate", sfc_delegate), ("deploy_20k", deployment),
+                        ("address_scan", address_scan)]:
+        build().write(os.path.join(out, name + ".trace"))
+
+
+if __name__ == "__main__":
+    main()
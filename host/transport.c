@@ -0,0 +1,48 @@
+/**
+ * Implements the transport independent part of the APDU exchange.
+ */
+#include <poll.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include "host_errors.h"
+#include "transport.h"
+
+// transportExchange implements the APDU exchange over the transport.
+int transportExchange(transport_t *transport,
+                      const uint8_t *apdu, size_t apduLength,
+                      uint8_t *response, size_t responseSize, size_t *responseLength) {
+    if (transport == NULL || transport->exchange == NULL || transport->fd < 0) {
+        return HOST_ERR_PARAMETERS;
+    }
+    return transport->exchange(transport, apdu, apduLength, response, responseSize, responseLength);
+}
+
+// transportClose implements closing the transport.
+void transportClose(transport_t *transport) {
+    if (transport == NULL || transport->fd < 0) {
+        return;
+    }
+    if (transport->close != NULL) {
+        transport->close(transport);
+    }
+    transport->fd = -1;
+}
+
+// transportWaitReadable implements waiting for the transport to have data available.
+int transportWaitReadable(transport_t *transport) {
+    struct pollfd pfd = {.fd = transport->fd, .events = POLLIN};
+
+    for (;;) {
+        int res = poll(&pfd, 1, transport->timeoutMs);
+        if (res > 0) {
+            return (pfd.revents & POLLIN) ? HOST_OK : HOST_ERR_IO;
+        }
+        if (res == 0) {
+            return HOST_ERR_TIMEOUT;
+        }
+        if (errno != EINTR) {
+            return HOST_ERR_IO;
+        }
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef FANTOM_HOST_TRANSPORT_H
+#define FANTOM_HOST_TRANSPORT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// TRANSPORT_DEFAULT_TIMEOUT_MS defines how long we wait for a response by default.
+// The user may be reviewing a transaction so the timeout must be generous.
+#define TRANSPORT_DEFAULT_TIMEOUT_MS 120000
+
+// transport_t declares a transport the APDU exchange runs over.
+// The exchange sends the request APDU and receives the whole response
+// including the status word.
+typedef struct transport_t transport_t;
+struct transport_t {
+    int (*exchange)(transport_t *transport,
+                    const uint8_t *apdu, size_t apduLength,
+                    uint8_t *response, size_t responseSize, size_t *responseLength);
+    void (*close)(transport_t *transport);
+    int fd;
+    int timeoutMs;
+};
+
+// transportOpenHidraw implements opening Linux hidraw device node of a Ledger device, e.g. /dev/hidraw0.
+int transportOpenHidraw(transport_t *transport, const char *devicePath, int timeoutMs);
+
+// transportOpenTcp implements opening TCP APDU connection to a device simulator.
+// Each APDU is prefixed by its 4 bytes big endian length in both directions,
+// the response length does not include the status word.
+int transportOpenTcp(transport_t *transport, const char *host, uint16_t port, int timeoutMs);
+
+// transportExchange implements the APDU exchange over the transport.
+int transportExchange(transport_t *transport,
+                      const uint8_t *apdu, size_t apduLength,
+                      uint8_t *response, size_t responseSize, size_t *responseLength);
+
+// transportClose implements closing the transport.
+void transportClose(transport_t *transport);
+
+// transportWaitReadable implements waiting for the transport to have data available.
+int transportWaitReadable(transport_t *transport);
+
+#endif //FANTOM_HOST_TRANSPORT_H
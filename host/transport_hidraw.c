@@ -0,0 +1,73 @@
+/**
+ * Implements the APDU exchange over Linux hidraw device node.
+ */
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+
+#include "host_errors.h"
+#include "hid_framing.h"
+#include "transport.h"
+
+// hidrawExchange implements the APDU exchange over hidraw device.
+static int hidrawExchange(transport_t *transport,
+                          const uint8_t *apdu, size_t apduLength,
+                          uint8_t *response, size_t responseSize, size_t *responseLength) {
+    // hidraw expects the report number in front of the report; Ledger uses report zero
+    uint8_t report[1 + HID_PACKET_SIZE];
+
+    // send all the packets
+    size_t count = hidPacketCount(apduLength);
+    for (size_t i = 0; i < count; i++) {
+        report[0] = 0;
+        if (!hidWrapPacket(apdu, apduLength, (uint16_t) i, report + 1)) {
+            return HOST_ERR_PARAMETERS;
+        }
+        if (write(transport->fd, report, sizeof(report)) != (ssize_t) sizeof(report)) {
+            return HOST_ERR_IO;
+        }
+    }
+
+    // collect the response packets
+    hid_unwrap_t state;
+    hidUnwrapInit(&state, response, responseSize);
+    for (;;) {
+        int res = transportWaitReadable(transport);
+        if (res != HOST_OK) {
+            return res;
+        }
+
+        uint8_t packet[HID_PACKET_SIZE];
+        if (read(transport->fd, packet, sizeof(packet)) != (ssize_t) sizeof(packet)) {
+            return HOST_ERR_IO;
+        }
+
+        res = hidUnwrapPacket(&state, packet);
+        if (res < 0) {
+            return res;
+        }
+        if (res == 1) {
+            *responseLength = state.received;
+            return HOST_OK;
+        }
+    }
+}
+
+// hidrawClose implements closing the hidraw device.
+static void hidrawClose(transport_t *transport) {
+    close(transport->fd);
+}
+
+// transportOpenHidraw implements opening Linux hidraw device node of a Ledger device.
+int transportOpenHidraw(transport_t *transport, const char *devicePath, int timeoutMs) {
+    memset(transport, 0, sizeof(*transport));
+    transport->fd = open(devicePath, O_RDWR | O_CLOEXEC);
+    if (transport->fd < 0) {
+        return HOST_ERR_OPEN;
+    }
+
+    transport->exchange = hidrawExchange;
+    transport->close = hidrawClose;
+    transport->timeoutMs = timeoutMs;
+    return HOST_OK;
+}
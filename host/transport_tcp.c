@@ -0,0 +1,130 @@
+/**
+ * Implements the APDU exchange over TCP connection to a device simulator.
+ */
+#include <unistd.h>
+#include <string.h>
+#include <stdio.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#include "host_errors.h"
+#include "apdu.h"
+#include "transport.h"
+
+// tcpWriteAll implements sending the whole buffer.
+static int tcpWriteAll(transport_t *transport, const uint8_t *buffer, size_t length) {
+    while (length > 0) {
+        ssize_t res = send(transport->fd, buffer, length, MSG_NOSIGNAL);
+        if (res <= 0) {
+            return HOST_ERR_IO;
+        }
+        buffer += res;
+        length -= (size_t) res;
+    }
+    return HOST_OK;
+}
+
+// tcpReadAll implements receiving the exact number of bytes.
+static int tcpReadAll(transport_t *transport, uint8_t *buffer, size_t length) {
+    while (length > 0) {
+        int res = transportWaitReadable(transport);
+        if (res != HOST_OK) {
+            return res;
+        }
+
+        ssize_t received = recv(transport->fd, buffer, length, 0);
+        if (received <= 0) {
+            return HOST_ERR_IO;
+        }
+        buffer += received;
+        length -= (size_t) received;
+    }
+    return HOST_OK;
+}
+
+// tcpExchange implements the APDU exchange over the TCP connection.
+static int tcpExchange(transport_t *transport,
+                       const uint8_t *apdu, size_t apduLength,
+                       uint8_t *response, size_t responseSize, size_t *responseLength) {
+    // send the length prefixed APDU
+    uint8_t header[4] = {
+            (uint8_t) (apduLength >> 24), (uint8_t) (apduLength >> 16),
+            (uint8_t) (apduLength >> 8), (uint8_t) apduLength
+    };
+    int res = tcpWriteAll(transport, header, sizeof(header));
+    if (res == HOST_OK) {
+        res = tcpWriteAll(transport, apdu, apduLength);
+    }
+    if (res != HOST_OK) {
+        return res;
+    }
+
+    // receive the response length; the status word follows the response data
+    res = tcpReadAll(transport, header, sizeof(header));
+    if (res != HOST_OK) {
+        return res;
+    }
+    size_t length = ((size_t) header[0] << 24) | ((size_t) header[1] << 16) |
+                    ((size_t) header[2] << 8) | (size_t) header[3];
+    if (length + APDU_STATUS_SIZE > responseSize) {
+        return HOST_ERR_BUFFER;
+    }
+
+    res = tcpReadAll(transport, response, length + APDU_STATUS_SIZE);
+    if (res != HOST_OK) {
+        return res;
+    }
+
+    *responseLength = length + APDU_STATUS_SIZE;
+    return HOST_OK;
+}
+
+// tcpClose implements closing the TCP connection.
+static void tcpClose(transport_t *transport) {
+    close(transport->fd);
+}
+
+// transportOpenTcp implements opening TCP APDU connection to a device simulator.
+int transportOpenTcp(transport_t *transport, const char *host, uint16_t port, int timeoutMs) {
+    memset(transport, 0, sizeof(*transport));
+    transport->fd = -1;
+
+    // resolve the simulator address
+    char service[8];
+    snprintf(service, sizeof(service), "%u", (unsigned) port);
+
+    struct addrinfo hints = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM};
+    struct addrinfo *list = NULL;
+    if (getaddrinfo(host, service, &hints, &list) != 0) {
+        return HOST_ERR_OPEN;
+    }
+
+    // connect to the first address which accepts us
+    for (struct addrinfo *ai = list; ai != NULL; ai = ai->ai_next) {
+        int fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd < 0) {
+            continue;
+        }
+        if (connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            transport->fd = fd;
+            break;
+        }
+        close(fd);
+    }
+    freeaddrinfo(list);
+
+    if (transport->fd < 0) {
+        return HOST_ERR_OPEN;
+    }
+
+    // the APDU exchange is latency bound; don't let small requests wait for more data
+    int flag = 1;
+    setsockopt(transport->fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+
+    transport->exchange = tcpExchange;
+    transport->close = tcpClose;
+    transport->timeoutMs = timeoutMs;
+    return HOST_OK;
+}
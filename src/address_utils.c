@@ -22,41 +22,16 @@ static const uint8_t HEXDIGITS[] = "0123456789abcdef";
 // deriveAddress implements address derivation for given BIP44 path.
 size_t deriveAddress(bip44_path_t *path, cx_sha3_t *sha3Context, uint8_t *out, size_t outSize) {
     // make sanity check, the buffer may never exceed this number
-    ASSERT(outSize < MAX_BUFFER_SIZE);
-    ASSERT(outSize >= RAW_ADDRESS_SIZE);
+    ENSURE(outSize < MAX_BUFFER_SIZE);
+    ENSURE(outSize >= RAW_ADDRESS_SIZE);
 
-    // prep containers for private key
-    private_key_t privateKey;
+    // derive the public key; address nodes are served from the node cache
+    cx_ecfp_public_key_t publicKey;
     chain_code_t chainCode;
-    size_t addressSize = 0;
-
-    BEGIN_TRY
-    {
-        TRY
-        {
-            // get the private code for the path
-            derivePrivateKey(
-                    path,
-                    &chainCode,
-                    &privateKey
-            );
-
-            // prep container for public key
-            cx_ecfp_public_key_t publicKey;
-
-            // derive the public key from the private one
-            deriveRawPublicKey(&privateKey, &publicKey);
-
-            // get raw address for the public key
-            addressSize = getRawAddress(&publicKey, sha3Context, out, outSize);
-        }
-        FINALLY
-        {
-            // clear the private key storage so we don't leak it after this call
-            explicit_bzero(&privateKey, SIZEOF(privateKey));
-        }
-    }
-    END_TRY;
+    derivePublicKey(path, &publicKey, &chainCode);
+
+    // get raw address for the public key
+    size_t addressSize = getRawAddress(&publicKey, sha3Context, out, outSize);
 
     return addressSize;
 }
@@ -68,7 +43,7 @@ size_t getRawAddress(cx_ecfp_public_key_t *publicKey, cx_sha3_t *sha3Context, ui
     STATIC_ASSERT(ADDRESS_HASH_BUFFER_SIZE >= RAW_ADDRESS_SIZE, "bad address hash buffer size");
 
     // make sanity check, the buffer has to be at least this big
-    ASSERT(outSize >= RAW_ADDRESS_SIZE);
+    ENSURE(outSize >= RAW_ADDRESS_SIZE);
 
     // make a buffer
     uint8_t hashAddress[ADDRESS_HASH_BUFFER_SIZE];
@@ -88,14 +63,14 @@ size_t getRawAddress(cx_ecfp_public_key_t *publicKey, cx_sha3_t *sha3Context, ui
 // addressFormatStr implements formatting of a raw address into a human readable textual form.
 void addressFormatStr(uint8_t *address, size_t addrLen, cx_sha3_t *sha3Context, char *out, size_t outSize) {
     // make sanity check, the buffer may never exceed this number
-    ASSERT(outSize < MAX_BUFFER_SIZE);
+    ENSURE(outSize < MAX_BUFFER_SIZE);
 
     // make sanity check, is the input address buffer of the right size
-    ASSERT(addrLen > 0);
-    ASSERT(addrLen <= RAW_ADDRESS_SIZE);
+    ENSURE(addrLen > 0);
+    ENSURE(addrLen <= RAW_ADDRESS_SIZE);
 
     // make sure the address will fit inside the buffer
-    ASSERT(outSize >= MIN_ADDRESS_STR_BUFFER_SIZE);
+    ENSURE(outSize >= MIN_ADDRESS_STR_BUFFER_SIZE);
 
     // prep checksum buffer
     uint8_t hashChecksum[32];
@@ -28,3 +28,24 @@ void assert(
     }
     #endif
 }
+
+// ensure implements the recoverable fault test.
+// The fault terminates the current instruction with ERR_FAULT status,
+// the main loop wipes the instruction state and returns to idle
+// without resetting the secure element, or the USB transport.
+void ensure(
+        int cond,
+        const char *msgStr
+#ifndef DEVEL
+        MARK_UNUSED
+#endif
+) {
+    // condition is met, nothing to do
+    if (cond) return;
+
+    #ifdef DEVEL
+    PRINTF("Fault: %s\n", msgStr);
+    #endif
+
+    THROW(ERR_FAULT);
+}
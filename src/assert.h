@@ -7,6 +7,9 @@
 // declare the actual function we use for assertion processing
 extern void assert(int cond, const char *msgStr);
 
+// declare the function we use for recoverable fault processing
+extern void ensure(int cond, const char *msgStr);
+
 // max length of an assert we allow
 #define _MAX_ASSERT_LENGTH_ 25
 
@@ -20,4 +23,8 @@ extern void assert(int cond, const char *msgStr);
 
 // the basic ASSERT will work with file line
 #define ASSERT(cond) assert((cond), _ASSERT_MSG_LEN_(_FILE_LINE_, _MAX_ASSERT_LENGTH_))
+
+// the ENSURE is used in parser, formatting, and policy code; a failure terminates
+// the current instruction, but does not reset the device like the ASSERT does
+#define ENSURE(cond) ensure((cond), _ASSERT_MSG_LEN_(_FILE_LINE_, _MAX_ASSERT_LENGTH_))
 #endif //FANTOM_LEDGER_ASSERT_H
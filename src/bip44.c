@@ -150,10 +150,10 @@ bool bip44_containsMoreThanAddress(const bip44_path_t *path) {
 // bip44_pathToStr converts BIP44 path to human readable form for displaying.
 void bip44_pathToStr(const bip44_path_t *path, char *out, size_t outSize) {
     // make sure the buffer is not exceeding sane size (we have only 4kB of memory after all)
-    ASSERT(outSize < MAX_BUFFER_SIZE);
+    ENSURE(outSize < MAX_BUFFER_SIZE);
 
     // we need to have at least space for string terminator
-    ASSERT(outSize > 0);
+    ENSURE(outSize > 0);
 
     char *ptr = out;
     char *end = (out + outSize);
@@ -161,7 +161,7 @@ void bip44_pathToStr(const bip44_path_t *path, char *out, size_t outSize) {
 #define WRITE(fmt, ...) \
     { \
         /* make sure we have enough space left */ \
-        ASSERT(ptr <= end); \
+        ENSURE(ptr <= end); \
         /* make sure the buffer is of the right type */ \
         ASSERT(sizeof(end - ptr) == sizeof(size_t)); \
         /* how much space do we have left */ \
@@ -171,7 +171,7 @@ void bip44_pathToStr(const bip44_path_t *path, char *out, size_t outSize) {
         /* how much did we spend */ \
         size_t res = strlen(ptr); \
         /* make sure we are well below the buffer size */ \
-        ASSERT(res + 1 < availableSize); \
+        ENSURE(res + 1 < availableSize); \
         /* advance buffer position */ \
         ptr += res; \
     }
@@ -184,7 +184,7 @@ void bip44_pathToStr(const bip44_path_t *path, char *out, size_t outSize) {
     // make sure the number of elements in the path does not exceed
     // total available positions. This is sanity check, the parser
     // should have already checked the value.
-    ASSERT(path->length < ARRAY_LEN(path->path));
+    ENSURE(path->length < ARRAY_LEN(path->path));
 
     // parse each individual index in the BIP32 path
     for (size_t i = 0; i < path->length; i++) {
@@ -199,5 +199,5 @@ void bip44_pathToStr(const bip44_path_t *path, char *out, size_t outSize) {
     }
 
     // make sure we did not leaked
-    ASSERT(ptr < end);
+    ENSURE(ptr < end);
 }
\ No newline at end of file
@@ -13,6 +13,13 @@
 #include "derive_key.h"
 #include "utils.h"
 #include "big_endian_io.h"
+#include "node_cache.h"
+
+// SECP256K1_ORDER is the order of the secp256k1 curve; child key tweak must stay below it.
+static const uint8_t SECP256K1_ORDER[32] = {
+        0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE,
+        0xBA, 0xAE, 0xDC, 0xE6, 0xAF, 0x48, 0xA0, 0x3B, 0xBF, 0xD2, 0x5E, 0x8C, 0xD0, 0x36, 0x41, 0x41
+};
 
 // derivePrivateKey implements private key derivation from internal root key.
 void derivePrivateKey(
@@ -79,6 +86,116 @@ void deriveRawPublicKey(
     io_seproxyhal_io_heartbeat();
 }
 
+// deriveFullPublicKey implements public key with chain code derivation
+// for the BIP44 path through the private key of the node.
+static void deriveFullPublicKey(
+        const bip44_path_t *path,
+        cx_ecfp_public_key_t *publicKey,
+        chain_code_t *chainCode
+) {
+    private_key_t privateKey;
+
+    BEGIN_TRY
+    {
+        TRY
+        {
+            // get the private code for the path
+            derivePrivateKey(path, chainCode, &privateKey);
+
+            // derive the public key from the private one
+            deriveRawPublicKey(&privateKey, publicKey);
+        }
+        FINALLY
+        {
+            // clear the private key storage so we don't leak it after this call
+            explicit_bzero(&privateKey, SIZEOF(privateKey));
+        }
+    }
+    END_TRY;
+}
+
+// deriveChildPublicKey implements BIP32 public parent key to public child key derivation (CKDpub).
+// False is returned for the (extremely unlikely) index which does not produce a valid key.
+static bool deriveChildPublicKey(
+        const cx_ecfp_public_key_t *parentKey,
+        const chain_code_t *parentChainCode,
+        uint32_t index,
+        cx_ecfp_public_key_t *publicKey,
+        chain_code_t *chainCode
+) {
+    // public derivation is not possible for hardened index
+    ASSERT(!bip44_isHardened(index));
+
+    // I = HMAC-SHA512(Key = cpar, Data = serP(Kpar) || ser32(i))
+    uint8_t data[COMPRESSED_PUBLIC_KEY_SIZE + 4];
+    extractCompressedPublicKey(parentKey, data, COMPRESSED_PUBLIC_KEY_SIZE);
+    u4be_write(data + COMPRESSED_PUBLIC_KEY_SIZE, index);
+
+    uint8_t digest[64];
+    io_seproxyhal_io_heartbeat();
+    cx_hmac_sha512(parentChainCode->code, CHAIN_CODE_SIZE, data, SIZEOF(data), digest, SIZEOF(digest));
+
+    // the left half is used as a scalar; it must be inside the curve order
+    bool isValid = (memcmp(digest, SECP256K1_ORDER, RAW_PRIVATE_KEY_SIZE) < 0) &&
+                   !cx_math_is_zero(digest, RAW_PRIVATE_KEY_SIZE);
+
+    if (isValid) {
+        private_key_t tweak;
+
+        // Ki = point(IL) + Kpar
+        cx_ecfp_init_private_key(CX_CURVE_256K1, digest, RAW_PRIVATE_KEY_SIZE, &tweak);
+        deriveRawPublicKey(&tweak, publicKey);
+        cx_ecfp_add_point(CX_CURVE_256K1, publicKey->W, publicKey->W, parentKey->W, SIZEOF(publicKey->W));
+        explicit_bzero(&tweak, SIZEOF(tweak));
+
+        // ci = IR
+        memcpy(chainCode->code, digest + RAW_PRIVATE_KEY_SIZE, CHAIN_CODE_SIZE);
+    }
+
+    // clean the tweak
+    explicit_bzero(digest, SIZEOF(digest));
+    return isValid;
+}
+
+// derivePublicKey implements public key with chain code derivation for the BIP44 path.
+// Address level nodes are derived from the chain node public key cached in NVRAM,
+// so the full derivation is done only once per chain node.
+void derivePublicKey(
+        const bip44_path_t *path,
+        cx_ecfp_public_key_t *publicKey,
+        chain_code_t *chainCode
+) {
+    // make sure the advertised path nodes is in pair with the path container size
+    ASSERT(path->length <= ARRAY_LEN(path->path));
+
+    // the parent node of an address
+    bip44_path_t nodePath;
+    memcpy(&nodePath, path, SIZEOF(nodePath));
+    nodePath.length--;
+
+    // can we use the cached chain node here?
+    if (path->length == BIP44_I_ADDRESS + 1 &&
+        !bip44_isHardened(path->path[BIP44_I_ADDRESS]) &&
+        nodeCacheIsCacheable(&nodePath)) {
+        cx_ecfp_public_key_t nodeKey;
+        chain_code_t nodeChainCode;
+
+        // derive and remember the chain node if we don't have it yet
+        if (!nodeCacheLookup(&nodePath, &nodeKey, &nodeChainCode)) {
+            deriveFullPublicKey(&nodePath, &nodeKey, &nodeChainCode);
+            nodeCacheStore(&nodePath, &nodeKey, &nodeChainCode);
+        }
+
+        // derive the address node from the chain node
+        if (deriveChildPublicKey(&nodeKey, &nodeChainCode, path->path[BIP44_I_ADDRESS], publicKey, chainCode)) {
+            return;
+        }
+    }
+
+    // do the full derivation
+    deriveFullPublicKey(path, publicKey, chainCode);
+}
+
 // extractRawPublicKey implements extracting public key into an output buffer.
 void extractRawPublicKey(
         const cx_ecfp_public_key_t *publicKey,
@@ -102,57 +219,145 @@ void extractRawPublicKey(
     }
 }
 
+// extractCompressedPublicKey implements extracting SEC1 compressed public key into an output buffer.
+void extractCompressedPublicKey(
+        const cx_ecfp_public_key_t *publicKey,
+        uint8_t *outBuffer, size_t outSize
+) {
+    // make sure the public key is uncompressed 0x04 | X | Y form
+    ASSERT(SIZEOF(publicKey->W) == 65);
+
+    // make sure the output buffer size corresponds with expected key size
+    ASSERT(outSize == COMPRESSED_PUBLIC_KEY_SIZE);
+
+    // the prefix carries the parity of Y coordinate
+    outBuffer[0] = ((publicKey->W[64] & 1) != 0) ? 0x03 : 0x02;
+
+    // X coordinate is already big endian
+    memcpy(outBuffer + 1, publicKey->W + 1, COMPRESSED_PUBLIC_KEY_SIZE - 1);
+}
+
 // deriveExtendedPublicKey implements public key
 // with chain code derivation for the BIP44 path specified.
 void deriveExtendedPublicKey(
         const bip44_path_t *path,
         extended_public_key_t *out
 ) {
-    private_key_t privateKey;
-    chain_code_t chainCode;
-
     // make sure the output structure is of the right dimension
     // the 1st byte is for public key length, others are for the public key and chain code
     ASSERT(SIZEOF(*out) == 1 + PUBLIC_KEY_SIZE + CHAIN_CODE_SIZE);
 
-    BEGIN_TRY
-    {
-        TRY
-        {
-            // get the private code for the path
-            derivePrivateKey(
-                    path,
-                    &chainCode,
-                    &privateKey
-            );
+    // derive the public key and chain code
+    cx_ecfp_public_key_t publicKey;
+    chain_code_t chainCode;
+    derivePublicKey(path, &publicKey, &chainCode);
 
-            // prep container for public key
-            cx_ecfp_public_key_t publicKey;
+    // make sure the public key size corresponds with our expectation
+    ASSERT(SIZEOF(out->publicKey) == PUBLIC_KEY_SIZE);
 
-            // derive the public key from the private one
-            deriveRawPublicKey(&privateKey, &publicKey);
+    // extract the public key data to the output buffer
+    extractRawPublicKey(&publicKey, out->publicKey, SIZEOF(out->publicKey));
+    out->length = PUBLIC_KEY_SIZE;
 
-            // make sure the public key size corresponds with our expectation
-            ASSERT(SIZEOF(out->publicKey) == PUBLIC_KEY_SIZE);
+    // make sure the chain code container size is what we expect
+    ASSERT(CHAIN_CODE_SIZE == SIZEOF(out->chainCode));
 
-            // extract the public key data to the output buffer
-            extractRawPublicKey(&publicKey, out->publicKey, SIZEOF(out->publicKey));
-            out->length = PUBLIC_KEY_SIZE;
+    // make sure the chain code source data is of the expected size
+    ASSERT(CHAIN_CODE_SIZE == SIZEOF(chainCode.code));
 
-            // make sure the chain code container size is what we expect
-            ASSERT(CHAIN_CODE_SIZE == SIZEOF(out->chainCode));
+    // chain code is placed after the public key
+    memcpy(out->chainCode, chainCode.code, CHAIN_CODE_SIZE);
+}
 
-            // make sure the chain code source data is of the expected size
-            ASSERT(CHAIN_CODE_SIZE == SIZEOF(chainCode.code));
+// deriveCompressedPublicKey implements compressed public key
+// with chain code derivation for the BIP44 path specified.
+static void deriveCompressedPublicKey(
+        const bip44_path_t *path,
+        uint8_t *outBuffer, size_t outSize,
+        chain_code_t *chainCode
+) {
+    // derive the public key and chain code
+    cx_ecfp_public_key_t publicKey;
+    derivePublicKey(path, &publicKey, chainCode);
 
-            // chain code is placed after the public key
-            memcpy(out->chainCode, chainCode.code, CHAIN_CODE_SIZE);
-        }
-        FINALLY
-        {
-            // clear the private key storage so we don't leak it after this call
-            explicit_bzero(&privateKey, SIZEOF(privateKey));
-        }
-    }
-    END_TRY;
-}
\ No newline at end of file
+    // extract the compressed public key to the output buffer
+    extractCompressedPublicKey(&publicKey, outBuffer, outSize);
+}
+
+// deriveKeyFingerprint implements BIP32 key fingerprint calculation for the BIP44 path specified.
+// The fingerprint is the first 4 bytes of HASH160 of the compressed node public key.
+void deriveKeyFingerprint(
+        const bip44_path_t *path,
+        uint8_t *outBuffer, size_t outSize
+) {
+    // make sure the output buffer size corresponds with the fingerprint size
+    ASSERT(outSize == KEY_FINGERPRINT_SIZE);
+
+    // derive the node public key, we don't need the chain code here
+    chain_code_t chainCode;
+    uint8_t publicKey[COMPRESSED_PUBLIC_KEY_SIZE];
+    deriveCompressedPublicKey(path, publicKey, SIZEOF(publicKey), &chainCode);
+
+    // calculate HASH160 = RIPEMD160(SHA256(key))
+    uint8_t digest[32];
+    cx_sha256_t sha256Context;
+    cx_sha256_init(&sha256Context);
+    cx_hash((cx_hash_t * ) & sha256Context, CX_LAST, publicKey, SIZEOF(publicKey), digest, SIZEOF(digest));
+
+    cx_ripemd160_t ripemdContext;
+    cx_ripemd160_init(&ripemdContext);
+    cx_hash((cx_hash_t * ) & ripemdContext, CX_LAST, digest, SIZEOF(digest), digest, SIZEOF(digest));
+
+    memcpy(outBuffer, digest, KEY_FINGERPRINT_SIZE);
+}
+
+// deriveSerializedPublicKeyNode implements BIP32 serialized extended public key
+// derivation (xpub) for the BIP44 path specified with already known parent fingerprint.
+void deriveSerializedPublicKeyNode(
+        const bip44_path_t *path,
+        const uint8_t *parentFingerprint, size_t fingerprintSize,
+        serialized_public_key_t *out
+) {
+    // make sure the output structure is of the right dimension (BIP32 uses 78 bytes)
+    ASSERT(SIZEOF(*out) == 78);
+
+    // make sure the fingerprint is what we expect
+    ASSERT(fingerprintSize == SIZEOF(out->parentFingerprint));
+
+    // the node must be below the Fantom prefix so the parent is a valid node as well
+    VALIDATE(bip44_containsAccount(path), ERR_INVALID_DATA);
+    ASSERT(path->length <= ARRAY_LEN(path->path));
+
+    // the version, depth and the child number are given by the path
+    u4be_write(out->version, XPUB_VERSION);
+    out->depth = (uint8_t) path->length;
+    u4be_write(out->childNumber, path->path[path->length - 1]);
+    memcpy(out->parentFingerprint, parentFingerprint, KEY_FINGERPRINT_SIZE);
+
+    // derive the node itself
+    chain_code_t chainCode;
+    ASSERT(SIZEOF(out->chainCode) == SIZEOF(chainCode.code));
+    deriveCompressedPublicKey(path, out->publicKey, SIZEOF(out->publicKey), &chainCode);
+    memcpy(out->chainCode, chainCode.code, CHAIN_CODE_SIZE);
+}
+
+// deriveSerializedPublicKey implements BIP32 serialized extended public key
+// derivation (xpub) for the BIP44 path specified.
+void deriveSerializedPublicKey(
+        const bip44_path_t *path,
+        serialized_public_key_t *out
+) {
+    // the node must be below the Fantom prefix so the parent is a valid node as well
+    VALIDATE(bip44_containsAccount(path), ERR_INVALID_DATA);
+
+    // derive the parent node fingerprint
+    bip44_path_t parentPath;
+    memcpy(&parentPath, path, SIZEOF(parentPath));
+    parentPath.length--;
+
+    uint8_t parentFingerprint[KEY_FINGERPRINT_SIZE];
+    deriveKeyFingerprint(&parentPath, parentFingerprint, SIZEOF(parentFingerprint));
+
+    // derive the node
+    deriveSerializedPublicKeyNode(path, parentFingerprint, SIZEOF(parentFingerprint), out);
+}
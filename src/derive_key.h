@@ -9,6 +9,11 @@ static const size_t RAW_PRIVATE_KEY_BUFFER =  64;
 static const size_t RAW_PRIVATE_KEY_SIZE =  32;
 static const size_t PUBLIC_KEY_SIZE =  32;
 static const size_t CHAIN_CODE_SIZE =  32;
+static const size_t COMPRESSED_PUBLIC_KEY_SIZE =  33;
+static const size_t KEY_FINGERPRINT_SIZE =  4;
+
+// XPUB_VERSION defines BIP32 version bytes of serialized mainnet public node.
+static const uint32_t XPUB_VERSION = 0x0488B21E;
 
 // private_key_t declares the private key type
 typedef cx_ecfp_private_key_t private_key_t;
@@ -25,6 +30,17 @@ typedef struct {
     uint8_t chainCode[CHAIN_CODE_SIZE];
 } extended_public_key_t;
 
+// serialized_public_key_t declares BIP32 serialized extended public key type (xpub)
+// see BIP32 specification https://github.com/bitcoin/bips/blob/master/bip-0032.mediawiki#serialization-format
+typedef struct {
+    uint8_t version[4];
+    uint8_t depth;
+    uint8_t parentFingerprint[KEY_FINGERPRINT_SIZE];
+    uint8_t childNumber[4];
+    uint8_t chainCode[CHAIN_CODE_SIZE];
+    uint8_t publicKey[COMPRESSED_PUBLIC_KEY_SIZE];
+} serialized_public_key_t;
+
 // derivePrivateKey implements private key derivation from internal root key.
 void derivePrivateKey(
         const bip44_path_t* path,
@@ -38,12 +54,26 @@ void deriveRawPublicKey(
         cx_ecfp_public_key_t* publicKey // output
 );
 
+// derivePublicKey implements public key with chain code derivation for the BIP44 path.
+// Address level nodes are derived from the chain node public key cached in NVRAM.
+void derivePublicKey(
+        const bip44_path_t* path,
+        cx_ecfp_public_key_t* publicKey, // output
+        chain_code_t* chainCode // output
+);
+
 // extractRawPublicKey implements extracting public key into an output buffer.
 void extractRawPublicKey(
         const cx_ecfp_public_key_t* publicKey,
         uint8_t* outBuffer, size_t outSize
 );
 
+// extractCompressedPublicKey implements extracting SEC1 compressed public key into an output buffer.
+void extractCompressedPublicKey(
+        const cx_ecfp_public_key_t* publicKey,
+        uint8_t* outBuffer, size_t outSize
+);
+
 // deriveExtendedPublicKey implements public key
 // with chain code derivation for the BIP44 path specified.
 void deriveExtendedPublicKey(
@@ -51,4 +81,26 @@ void deriveExtendedPublicKey(
         extended_public_key_t* out
 );
 
+// deriveKeyFingerprint implements BIP32 key fingerprint calculation for the BIP44 path specified.
+void deriveKeyFingerprint(
+        const bip44_path_t* path,
+        uint8_t* outBuffer, size_t outSize
+);
+
+// deriveSerializedPublicKeyNode implements BIP32 serialized extended public key
+// derivation (xpub) for the BIP44 path specified with already known parent fingerprint.
+// It allows to derive sibling nodes without deriving their parent again.
+void deriveSerializedPublicKeyNode(
+        const bip44_path_t* path,
+        const uint8_t* parentFingerprint, size_t fingerprintSize,
+        serialized_public_key_t* out
+);
+
+// deriveSerializedPublicKey implements BIP32 serialized extended public key
+// derivation (xpub) for the BIP44 path specified.
+void deriveSerializedPublicKey(
+        const bip44_path_t* path,
+        serialized_public_key_t* out
+);
+
 #endif //FANTOM_LEDGER_DERIVE_KEY_H
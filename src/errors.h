@@ -38,6 +38,11 @@ enum {
     // Device is locked.
     ERR_DEVICE_LOCKED = 0x6E09,
 
+    // Request could not be processed due to a recoverable fault in parser,
+    // formatting, or policy code. The instruction has been terminated
+    // and its state wiped, but the device has not been reset.
+    ERR_FAULT = 0x6E0A,
+
     // Error codes above this value are ok to be passed to host.
     // Any other error will trigger SEPROXYHAL reset.
     _ERR_PASS_TO = 0x6E10,
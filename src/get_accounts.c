@@ -0,0 +1,248 @@
+/**
+ * Implements Account Discovery APDU instruction handler.
+ *
+ * The instruction exports BIP32 serialized public keys of a range of accounts
+ * so the host can scan the accounts for activity after just a single approval.
+ */
+#include "common.h"
+#include "errors.h"
+#include "big_endian_io.h"
+#include "state.h"
+#include "ui_helpers.h"
+#include "policy.h"
+#include "get_accounts.h"
+
+// ctx hold the direct reference to this instruction context.
+static ins_get_accounts_context_t *ctx = &(instructionState.insGetAccountsContext);
+
+// RESPONSE_READY_TAG is used to tag the state context that the first keys can be sent.
+static int16_t RESPONSE_READY_TAG = 9119;
+
+// what are possible steps of the account discovery
+// @see /doc/cmd_get_accounts.md for details.
+enum {
+    P1_NEW_DISCOVERY = 0x00,
+    P1_NEXT_ACCOUNTS = 0x01,
+};
+
+// runGetAccountsUIStep implements next step of UX for the Account Discovery instruction.
+static void runGetAccountsUIStep();
+
+// what steps are being handled
+enum {
+    UI_STEP_WARNING = 100,
+    UI_STEP_DISPLAY_RANGE,
+    UI_STEP_CONFIRM,
+    UI_STEP_RESPOND,
+    UI_STEP_INVALID,
+};
+
+// setAccountPath implements building m/44'/60'/account' path for the given account index.
+static void setAccountPath(bip44_path_t *path, uint32_t account) {
+    path->path[BIP44_I_PURPOSE] = BIP44 | HARDENED_BIP32;
+    path->path[BIP44_I_COIN_TYPE] = FANTOM_COIN_TYPE | HARDENED_BIP32;
+    path->path[BIP44_I_ACCOUNT] = account | HARDENED_BIP32;
+    path->length = BIP44_I_ACCOUNT + 1;
+}
+
+// deriveAccountStep implements deriving the public key of a single account of the range.
+static bool deriveAccountStep(uint32_t i) {
+    // the parent node is the same for all the accounts; batches start on a response boundary
+    setAccountPath(&ctx->path, ctx->firstAccount + i);
+    deriveSerializedPublicKeyNode(
+            &ctx->path,
+            ctx->parentFingerprint, SIZEOF(ctx->parentFingerprint),
+            &ctx->response.keys[i % ACCOUNTS_PER_RESPONSE]
+    );
+    return true;
+}
+
+// sendNextAccounts implements sending the next batch of account public keys to the host.
+static void sendNextAccounts() {
+    // make sure there is something to send
+    ASSERT(!schedulerIsDone(&ctx->work));
+
+    // derive the keys of the next batch; the work resumes where the previous batch stopped
+    uint8_t batch = (uint8_t) schedulerRun(&ctx->work, ACCOUNTS_PER_RESPONSE);
+
+    // send the keys
+    ctx->response.count = batch;
+    ctx->response.remaining = (uint8_t) (ctx->count - ctx->work.next);
+    io_send_buf(SUCCESS, (uint8_t * ) & ctx->response, 2 + batch * SIZEOF(ctx->response.keys[0]));
+
+    // are we done?
+    if (ctx->response.remaining == 0) {
+        ui_idle();
+    } else {
+        ui_displayBusy();
+    }
+}
+
+// handleGetAccountsInit implements the first step of the account discovery.
+static void handleGetAccountsInit(uint8_t p2, uint8_t *wireBuffer, size_t wireSize) {
+    // the discovery can not be restarted in the middle
+    VALIDATE(!ctx->isStarted, ERR_INVALID_STATE);
+
+    // validate the p2 value
+    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+
+    // we expect the first account index and the number of accounts
+    VALIDATE(wireSize == 5, ERR_INVALID_DATA);
+    ctx->firstAccount = u4be_read(wireBuffer);
+    ctx->count = u1be_read(wireBuffer + 4);
+
+    // the account index is hardened here, the range must not reach the hardened space
+    VALIDATE(ctx->count > 0 && ctx->count <= ACCOUNTS_MAX_COUNT, ERR_INVALID_DATA);
+    VALIDATE(ctx->firstAccount < HARDENED_BIP32 - ctx->count, ERR_INVALID_DATA);
+
+    // check security policy for the range of accounts
+    bip44_path_t lastPath;
+    setAccountPath(&ctx->path, ctx->firstAccount);
+    setAccountPath(&lastPath, ctx->firstAccount + ctx->count - 1);
+
+    security_policy_t policy = policyForGetAccounts(&ctx->path, &lastPath);
+    ASSERT_NOT_DENIED(policy);
+
+    // mark the discovery started
+    ctx->isStarted = true;
+    ctx->responseReady = RESPONSE_READY_TAG;
+
+    // the keys are derived as a resumable work item, batch by batch
+    schedulerInit(&ctx->work, deriveAccountStep, ctx->count);
+
+    // where on the UI scenario we start depends on the policy
+    switch (policy) {
+        case POLICY_WARN:
+            ctx->uiStep = UI_STEP_WARNING;
+            break;
+        case POLICY_PROMPT:
+            ctx->uiStep = UI_STEP_DISPLAY_RANGE;
+            break;
+        default:
+            // if no policy was set, terminate the action
+            ASSERT(false);
+    }
+
+    // run the first step
+    runGetAccountsUIStep();
+}
+
+// runGetAccountsUIStep implements next step of UX for the Account Discovery instruction.
+static void runGetAccountsUIStep() {
+    // keep the callback to myself
+    ui_callback_fn_t *this_fn = runGetAccountsUIStep;
+
+    // resume the stage based on previous result
+    switch (ctx->uiStep) {
+        case UI_STEP_WARNING: {
+            // display the warning
+            ui_displayPaginatedText(
+                    "Unusual Request",
+                    "Be careful!",
+                    this_fn
+            );
+
+            // set next step
+            ctx->uiStep = UI_STEP_DISPLAY_RANGE;
+            break;
+        }
+
+        case UI_STEP_DISPLAY_RANGE: {
+            // format the accounts range
+            char rangeStr[30];
+            snprintf(rangeStr, SIZEOF(rangeStr), "#%u to #%u",
+                     (unsigned) ctx->firstAccount,
+                     (unsigned) (ctx->firstAccount + ctx->count - 1));
+
+            // display the range
+            ui_displayPaginatedText(
+                    "Exporting Accounts",
+                    rangeStr,
+                    this_fn
+            );
+
+            // set next step
+            ctx->uiStep = UI_STEP_CONFIRM;
+            break;
+        }
+
+        case UI_STEP_CONFIRM: {
+            // ask user to confirm the keys export
+            ui_displayPrompt(
+                    "Confirm",
+                    "Keys Export?",
+                    this_fn,
+                    ui_respondWithUserReject
+            );
+
+            // set next step
+            ctx->uiStep = UI_STEP_RESPOND;
+            break;
+        }
+
+        case UI_STEP_RESPOND: {
+            // make sure the discovery has been approved
+            ASSERT(ctx->responseReady == RESPONSE_READY_TAG);
+
+            // set invalid step so we never cycle around
+            ctx->uiStep = UI_STEP_INVALID;
+
+            // the accounts share the parent node; we derive its fingerprint just once
+            bip44_path_t parentPath;
+            setAccountPath(&parentPath, 0);
+            parentPath.length = BIP44_I_ACCOUNT;
+            deriveKeyFingerprint(&parentPath, ctx->parentFingerprint, SIZEOF(ctx->parentFingerprint));
+
+            // send the first batch
+            sendNextAccounts();
+            break;
+        }
+
+        default: {
+            // we don't tolerate invalid state
+            ASSERT(false);
+        }
+    }
+}
+
+// handleGetAccountsNext implements continuation step of the account discovery.
+static void handleGetAccountsNext(uint8_t p2, size_t wireSize) {
+    // the discovery must have been approved and there must be accounts left to send
+    VALIDATE(ctx->isStarted && ctx->uiStep == UI_STEP_INVALID, ERR_INVALID_STATE);
+    VALIDATE(!schedulerIsDone(&ctx->work), ERR_INVALID_STATE);
+
+    // validate the p2 value
+    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+
+    // we don't expect to receive any data here
+    VALIDATE(wireSize == 0, ERR_INVALID_DATA);
+
+    // send the next batch
+    sendNextAccounts();
+}
+
+// handleGetAccounts implements APDU instruction handler for Account Discovery instruction.
+void handleGetAccounts(
+        uint8_t p1,
+        uint8_t p2,
+        uint8_t *wireBuffer,
+        size_t wireSize,
+        bool isOnInit
+) {
+    // make sure the state is clean
+    if (isOnInit) {
+        memset(ctx, 0, SIZEOF(*ctx));
+    }
+
+    // decide based on the p1 value
+    switch (p1) {
+        case P1_NEW_DISCOVERY:
+            handleGetAccountsInit(p2, wireBuffer, wireSize);
+            break;
+        case P1_NEXT_ACCOUNTS:
+            handleGetAccountsNext(p2, wireSize);
+            break;
+        default:
+            VALIDATE(false, ERR_INVALID_PARAMETERS);
+    }
+}
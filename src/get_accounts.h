@@ -0,0 +1,38 @@
+#ifndef FANTOM_LEDGER_GET_ACCOUNTS_H
+#define FANTOM_LEDGER_GET_ACCOUNTS_H
+
+#include "common.h"
+#include "handlers.h"
+#include "bip44.h"
+#include "derive_key.h"
+#include "scheduler.h"
+
+// ACCOUNTS_PER_RESPONSE defines how many account public keys fit into a single response APDU.
+// Each serialized public key takes 78 bytes and the APDU data can not exceed 255 bytes.
+#define ACCOUNTS_PER_RESPONSE 3
+
+// ACCOUNTS_MAX_COUNT defines the max number of accounts exported on a single instruction.
+#define ACCOUNTS_MAX_COUNT 20
+
+// handleGetAccounts implements Account Discovery APDU instruction handler.
+handler_fn_t handleGetAccounts;
+
+// ins_get_accounts_context_t declares context
+// for the account discovery APDU instruction.
+typedef struct {
+    int16_t responseReady;
+    bool isStarted;
+    bip44_path_t path;
+    uint32_t firstAccount;
+    uint8_t count;
+    work_item_t work;
+    uint8_t parentFingerprint[KEY_FINGERPRINT_SIZE];
+    struct {
+        uint8_t remaining;
+        uint8_t count;
+        serialized_public_key_t keys[ACCOUNTS_PER_RESPONSE];
+    } response;
+    int uiStep;
+} ins_get_accounts_context_t;
+
+#endif //FANTOM_LEDGER_GET_ACCOUNTS_H
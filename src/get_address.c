@@ -5,16 +5,18 @@
 #include "policy.h"
 #include "ui_helpers.h"
 #include "address_utils.h"
+#include "key_slots.h"
 
 // RESPONSE_READY_TAG is used to tag output buffer when address is ready.
 static uint16_t RESPONSE_READY_TAG = 32123;
 
 // ctx holds the context of the Get Address instruction.
+// Side instruction uses its own context so the interrupted instruction is not disturbed.
 static ins_get_address_context_t *ctx = &(instructionState.insGetAddressContext);
 
 // what are possible scenarios of the address handling
 enum {
-    P1_RETURN_ADDRESS = 0x01,
+    P1_RETURN_ADDRESS = GET_ADDRESS_P1_RETURN_ADDRESS,
     P1_DISPLAY_ADDRESS = 0x02,
 };
 
@@ -39,6 +41,9 @@ void handleGetAddress(
         size_t wireSize,
         bool isOnInit
 ) {
+    // pick the context; side instruction must not touch the joined instruction state
+    ctx = (isSideInstruction ? &(sideInstructionState.insGetAddressContext) : &(instructionState.insGetAddressContext));
+
     // make sure the state is clean
     if (isOnInit) {
         memset(ctx, 0, SIZEOF(*ctx));
@@ -50,11 +55,28 @@ void handleGetAddress(
     // validate the values p1 and p2
     // see the documentation for explanation why we check zero values here
     VALIDATE(p1 == P1_RETURN_ADDRESS || p1 == P1_DISPLAY_ADDRESS, ERR_INVALID_PARAMETERS);
-    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+    VALIDATE(p2 == 0 || p2 == P2_KEY_SLOT, ERR_INVALID_PARAMETERS);
 
     // decide if the address display will be part of the INS flow
     ctx->isShowAddress = (p1 == P1_DISPLAY_ADDRESS);
 
+    // registered key slot has the path validated and the address derived already
+    if (p2 == P2_KEY_SLOT) {
+        const key_slot_t *slot = keySlotFromWire(wireBuffer, wireSize);
+        VALIDATE(slot->hasAddress, ERR_INVALID_DATA);
+
+        // copy the path and the address
+        memcpy(&ctx->path, &slot->path, SIZEOF(ctx->path));
+        memcpy(ctx->address.buffer, slot->address, RAW_ADDRESS_SIZE);
+        ctx->address.size = RAW_ADDRESS_SIZE;
+        ctx->responseReady = RESPONSE_READY_TAG;
+
+        // unusual path has been confirmed by user on the slot registration
+        ctx->uiStep = (ctx->isShowAddress ? UI_STEP_ADDRESS : UI_STEP_RESPOND);
+        runGetAddressUIStep();
+        return;
+    }
+
     // parse BIP44 path from the incoming request
     size_t parsedSize = bip44_parseFromWire(&ctx->path, wireBuffer, wireSize);
 
@@ -67,6 +89,9 @@ void handleGetAddress(
     security_policy_t policy = policyForGetAddress(&ctx->path, ctx->isShowAddress);
     ASSERT_NOT_DENIED(policy);
 
+    // side instruction can not interact with the user
+    VALIDATE(!isSideInstruction || policy == POLICY_ALLOW, ERR_REJECTED_BY_POLICY);
+
     // derive the address and mark as ready
     ctx->address.size = deriveAddress(&ctx->path, &ctx->sha3Context, ctx->address.buffer, SIZEOF(ctx->address.buffer));
     ctx->responseReady = RESPONSE_READY_TAG;
@@ -136,7 +161,7 @@ static void runGetAddressUIStep() {
 
         case UI_STEP_ADDRESS: {
             // make sure the address is well inside the available buffer
-            ASSERT(ctx->address.size < SIZEOF(ctx->address.buffer));
+            ENSURE(ctx->address.size < SIZEOF(ctx->address.buffer));
 
             // create formatted address buffer and format for display
             char addrStr[64];
@@ -173,13 +198,17 @@ static void runGetAddressUIStep() {
             ASSERT(ctx->responseReady == RESPONSE_READY_TAG);
 
             // make sure the address length is well inside the buffer size
-            ASSERT(ctx->address.size <= SIZEOF(ctx->address.buffer));
+            ENSURE(ctx->address.size <= SIZEOF(ctx->address.buffer));
 
             // send the data to remote host and switch idle
             // we don't send the whole address buffer, some space is probably unused
             // we send only the first byte (address length) + the bytes of the active address part
             io_send_buf(SUCCESS, (uint8_t * ) & ctx->address, 1 + ctx->address.size);
-            ui_idle();
+
+            // side instruction leaves the UI to the interrupted instruction
+            if (!isSideInstruction) {
+                ui_idle();
+            }
 
             // set invalid step so we never cycle around
             ctx->uiStep = UI_STEP_INVALID;
@@ -5,6 +5,10 @@
 #include "bip44.h"
 #include "handlers.h"
 
+// GET_ADDRESS_P1_RETURN_ADDRESS defines P1 value of the address returned
+// directly to the host without being displayed to the user.
+#define GET_ADDRESS_P1_RETURN_ADDRESS 0x01
+
 // handleGetAddress implements Get Address APDU instruction handler.
 handler_fn_t handleGetAddress;
 
@@ -0,0 +1,106 @@
+/**
+ * Implements Get Capabilities APDU instruction handler.
+ *
+ * The instruction tells the host which optional protocol paths the application
+ * supports and how large the batches may be, so the host can configure itself
+ * in a single round trip instead of probing the device.
+ */
+#include "common.h"
+#include "handlers.h"
+#include "ui_helpers.h"
+#include "big_endian_io.h"
+#include "state.h"
+#include "settings.h"
+#include "sign_cache.h"
+#include "node_cache.h"
+#include "get_capabilities.h"
+
+// what features the application supports
+// See doc/cmd_capabilities.md for the instruction handling details.
+enum {
+    CAPS_ACCOUNT_DISCOVERY = 0x0001,
+    CAPS_VERIFY_ADDRESSES = 0x0002,
+    // reserved; the address search has been dropped from the Verify Addresses instruction
+    CAPS_FIND_ADDRESS = 0x0004,
+    CAPS_KEY_SLOTS = 0x0008,
+    CAPS_ZERO_RUN_STREAM = 0x0010,
+    CAPS_TX_TEMPLATES = 0x0020,
+    // reserved; typed transaction envelopes are not parsed by the tx stream yet
+    CAPS_TYPED_TX = 0x0040,
+    CAPS_PIPELINED_SIGNING = 0x0080,
+    CAPS_SIGNATURE_RESEND = 0x0100,
+    CAPS_DATA_DIGEST = 0x0200,
+    CAPS_KNOWN_METHODS = 0x0400,
+    CAPS_PERSONAL_MESSAGE = 0x0800,
+    CAPS_TYPED_DATA = 0x1000,
+    CAPS_SIDE_INSTRUCTIONS = 0x2000,
+    CAPS_RECOVERABLE_FAULTS = 0x4000,
+    CAPS_EXPERT_MODE_ON = 0x8000,
+    // reserved; an interrupted transaction stream can not be resumed yet, it has to be sent again
+    CAPS_RESUMABLE_STREAMS = 0x00010000,
+    // the security policy approves these requests on standard paths without user confirmation
+    CAPS_ALLOW_ADDRESS_EXPORT = 0x00020000,
+    CAPS_ALLOW_KEY_SLOT = 0x00040000,
+};
+
+// handleGetCapabilities implements handler function for Get Capabilities APDU instruction.
+// For the handler responsibility and response format please check the documentation.
+void handleGetCapabilities(
+        uint8_t p1,
+        uint8_t p2,
+        uint8_t *wireDataBuffer MARK_UNUSED,
+        size_t wireDataSize,
+        bool isNewCall MARK_UNUSED
+) {
+    // Make sure the request has expected parameters.
+    VALIDATE(p1 == 0, ERR_INVALID_PARAMETERS);
+    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+    VALIDATE(wireDataSize == 0, ERR_INVALID_DATA);
+
+    // the features supported by this build
+    uint32_t features = CAPS_ACCOUNT_DISCOVERY | CAPS_VERIFY_ADDRESSES |
+                        CAPS_KEY_SLOTS | CAPS_ZERO_RUN_STREAM | CAPS_TX_TEMPLATES |
+                        CAPS_PIPELINED_SIGNING | CAPS_SIGNATURE_RESEND | CAPS_DATA_DIGEST |
+                        CAPS_KNOWN_METHODS | CAPS_PERSONAL_MESSAGE | CAPS_TYPED_DATA |
+                        CAPS_SIDE_INSTRUCTIONS | CAPS_RECOVERABLE_FAULTS |
+                        CAPS_ALLOW_ADDRESS_EXPORT | CAPS_ALLOW_KEY_SLOT;
+
+    // the expert mode changes the way transactions are reviewed by the user;
+    // it does not change the security policy, nothing is approved automatically
+    if (settingsIsExpertMode()) {
+        features |= CAPS_EXPERT_MODE_ON;
+    }
+
+    // construct the response structure
+    // it will be used by i/o exchange as a source buffer for response APDU
+    struct {
+        uint8_t features[4];
+        uint8_t accountsPerResponse;
+        uint8_t accountsMax;
+        uint8_t verifyPerRequest;
+        uint8_t chunkSize;
+        uint8_t signTxSlots;
+        uint8_t keySlots;
+        uint8_t signCacheSize;
+        uint8_t nodeCacheSize;
+    } response = {
+            .accountsPerResponse = ACCOUNTS_PER_RESPONSE,
+            .accountsMax = ACCOUNTS_MAX_COUNT,
+            .verifyPerRequest = VERIFY_ADDRESSES_PER_REQUEST,
+            .chunkSize = CAPS_PREFERRED_CHUNK_SIZE,
+            .signTxSlots = SIGN_TX_SLOTS,
+            .keySlots = KEY_SLOTS_COUNT,
+            .signCacheSize = SIGN_CACHE_SIZE,
+            .nodeCacheSize = NODE_CACHE_SIZE,
+    };
+    u4be_write(response.features, features);
+
+    // send the structure to host by i/o exchange helper
+    io_send_buf(SUCCESS, (uint8_t * ) & response, sizeof(response));
+
+    // go back to app idle state, the instruction has been served
+    // side instruction leaves the UI to the interrupted instruction
+    if (!isSideInstruction) {
+        ui_idle();
+    }
+}
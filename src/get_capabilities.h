@@ -0,0 +1,14 @@
+#ifndef FANTOM_LEDGER_GET_CAPABILITIES_H
+#define FANTOM_LEDGER_GET_CAPABILITIES_H
+
+#include "handlers.h"
+#include "common.h"
+
+// CAPS_PREFERRED_CHUNK_SIZE defines the preferred size of data chunks streamed to the device.
+// The streamed data are processed on the fly so the host should fill the APDU up to the max Lc.
+#define CAPS_PREFERRED_CHUNK_SIZE 255
+
+// handleGetCapabilities implements handler for Get Capabilities APDU instruction.
+handler_fn_t handleGetCapabilities;
+
+#endif //FANTOM_LEDGER_GET_CAPABILITIES_H
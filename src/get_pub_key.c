@@ -8,6 +8,7 @@
 #include "ui_helpers.h"
 #include "policy.h"
 #include "get_pub_key.h"
+#include "key_slots.h"
 
 // ctx hold the direct reference to this instruction context.
 static ins_get_ext_pubkey_context_t *ctx = &(instructionState.insGetPubKeyContext);
@@ -15,6 +16,12 @@ static ins_get_ext_pubkey_context_t *ctx = &(instructionState.insGetPubKeyContex
 // RESPONSE_READY_TAG is used to tag the state context that the key is ready.
 static int16_t RESPONSE_READY_TAG = 7455;
 
+// what output formats are supported
+enum {
+    P1_EXTENDED_KEY = 0x00,
+    P1_SERIALIZED_KEY = 0x01,
+};
+
 // runGetPublicKeyUIStep implements next step of UX for the Get Public Key instruction.
 static void runGetPublicKeyUIStep();
 
@@ -45,8 +52,31 @@ void handleGetPublicKey(
 
     // validate the values p1 and p2
     // see the documentation for explanation why we check zero values here
-    VALIDATE(p1 == 0, ERR_INVALID_PARAMETERS);
-    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+    VALIDATE(p1 == P1_EXTENDED_KEY || p1 == P1_SERIALIZED_KEY, ERR_INVALID_PARAMETERS);
+    VALIDATE(p2 == 0 || p2 == P2_KEY_SLOT, ERR_INVALID_PARAMETERS);
+
+    // decide which output format we use
+    ctx->isSerialized = (p1 == P1_SERIALIZED_KEY);
+
+    // registered key slot has the path validated and the public key derived already
+    if (p2 == P2_KEY_SLOT) {
+        const key_slot_t *slot = keySlotFromWire(wireBuffer, wireSize);
+        memcpy(&ctx->path, &slot->path, SIZEOF(ctx->path));
+
+        // the serialized key needs the parent node
+        if (ctx->isSerialized) {
+            deriveSerializedPublicKey(&ctx->path, &ctx->xpub);
+        } else {
+            memcpy(&ctx->pubKey, &slot->pubKey, SIZEOF(ctx->pubKey));
+        }
+        ctx->responseReady = RESPONSE_READY_TAG;
+
+        // unusual path has been confirmed by user on the slot registration,
+        // but the key export is always confirmed
+        ctx->uiStep = UI_STEP_DISPLAY_PATH;
+        runGetPublicKeyUIStep();
+        return;
+    }
 
     // parse BIP44 path from the wire buffer so we can derive keys for it
     size_t parsedSize = bip44_parseFromWire(&ctx->path, wireBuffer, wireSize);
@@ -61,10 +91,17 @@ void handleGetPublicKey(
     ASSERT_NOT_DENIED(policy);
 
     // actually derive the public key
-    deriveExtendedPublicKey(
-            &ctx->path,
-            &ctx->pubKey
-    );
+    if (ctx->isSerialized) {
+        deriveSerializedPublicKey(
+                &ctx->path,
+                &ctx->xpub
+        );
+    } else {
+        deriveExtendedPublicKey(
+                &ctx->path,
+                &ctx->pubKey
+        );
+    }
 
     // mark the response to be ready to deliver
     ctx->responseReady = RESPONSE_READY_TAG;
@@ -145,7 +182,11 @@ static void runGetPublicKeyUIStep() {
             ASSERT(ctx->responseReady == RESPONSE_READY_TAG);
 
             // send the data to remote host and switch idle
-            io_send_buf(SUCCESS, (uint8_t * ) & ctx->pubKey, SIZEOF(ctx->pubKey));
+            if (ctx->isSerialized) {
+                io_send_buf(SUCCESS, (uint8_t * ) & ctx->xpub, SIZEOF(ctx->xpub));
+            } else {
+                io_send_buf(SUCCESS, (uint8_t * ) & ctx->pubKey, SIZEOF(ctx->pubKey));
+            }
             ui_idle();
 
             // set invalid step so we never cycle around
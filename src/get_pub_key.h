@@ -14,6 +14,8 @@ typedef struct {
     int16_t responseReady;
     bip44_path_t path;
     extended_public_key_t pubKey;
+    serialized_public_key_t xpub;
+    bool isSerialized;
     int uiStep;
 } ins_get_ext_pubkey_context_t;
 
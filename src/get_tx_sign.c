@@ -12,6 +12,10 @@
 #include "tx_stream.h"
 #include "bip44.h"
 #include "transaction.h"
+#include "sign_cache.h"
+#include "key_slots.h"
+#include "tx_template.h"
+#include "settings.h"
 
 // ctx keeps local reference to the transaction signature building context
 static ins_sign_tx_context_t *ctx = &(instructionState.insSignTxContext);
@@ -24,13 +28,40 @@ static uint16_t RESPONSE_READY_TAG = 11711;
 enum {
     P1_NEW_TRANSACTION = 0x00,
     P1_STREAM_DATA = 0x01,
+    P1_TEMPLATE_DATA = 0x02,
     P1_GET_SIGNATURE = 0x80,
+    P1_GET_RESULT = 0x81,
+    P1_GET_DATA_DIGEST = 0x82,
 };
 
+// how the transaction data are encoded on the details block
+enum {
+    P2_RAW_DATA = 0x00,
+    P2_ZERO_RUN_DATA = 0x01,
+};
+
+// how the transaction review is run on the final confirmation block
+enum {
+    P2_ATTACHED_REVIEW = 0x00,
+    P2_DEFERRED_REVIEW = 0x01,
+};
+
+// streamSlot returns the transaction slot currently receiving the transaction stream.
+static inline sign_tx_slot_t *streamSlot() {
+    ASSERT(ctx->streamSlot < SIGN_TX_SLOTS);
+    return &ctx->slots[ctx->streamSlot];
+}
+
+// reviewSlot returns the transaction slot currently being reviewed by the user.
+static inline sign_tx_slot_t *reviewSlot() {
+    ASSERT(ctx->reviewSlot < SIGN_TX_SLOTS);
+    return &ctx->slots[ctx->reviewSlot];
+}
+
 // ASSERT_STAGE implements stage validation so the host can not step out off the protocol.
 // It's just a cosmetic definition to make the code readable and express our intention better.
 static inline void ASSERT_STAGE(tx_stage_t expected) {
-    VALIDATE(ctx->stage == expected, ERR_INVALID_STATE);
+    VALIDATE(streamSlot()->stage == expected, ERR_INVALID_STATE);
 }
 
 // runSignTransactionInitUIStep implements next step in UX flow of the tx signing initialization flow (the 1st APDU).
@@ -39,6 +70,12 @@ static void runSignTransactionInitUIStep();
 // runSignTransactionUIStep implements next step in UX flow of the tx signing flow (the final APDU).
 static void runSignTransactionUIStep();
 
+// rejectSignTransaction implements UX callback for transaction rejected by the user.
+static void rejectSignTransaction();
+
+// runNextDeferredReview implements switching the UI to the next transaction waiting for deferred review.
+static void runNextDeferredReview();
+
 // what UX steps we support for starting a new transaction
 enum {
     UI_STEP_INIT_WARNING = 100,
@@ -49,12 +86,16 @@ enum {
 
 // what UX steps we support for finishing the transaction signature
 enum {
-    UI_STEP_TX_SENDER = 200,
+    UI_STEP_TX_WARNING = 200,
+    UI_STEP_TX_DETAILS,
+    UI_STEP_TX_SENDER,
     UI_STEP_TX_RECIPIENT,
     UI_STEP_TX_AMOUNT,
     UI_STEP_TX_FEE,
     UI_STEP_TX_CONTRACT_CALL,
+    UI_STEP_TX_DATA_DIGEST,
     UI_STEP_TX_CONFIRM,
+    UI_STEP_TX_RESEND,
     UI_STEP_TX_RESPOND,
     UI_STEP_TX_INVALID,
 };
@@ -63,42 +104,104 @@ enum {
 // It's the first step in signing the transaction where the source address is calculated
 // and the whole process is confirmed.
 static void handleSignTxInit(uint8_t p2, uint8_t *wireBuffer, size_t wireSize) {
+    // validate the p2 value
+    VALIDATE(p2 == 0 || p2 == P2_KEY_SLOT, ERR_INVALID_PARAMETERS);
+
+    // find a free slot for the new transaction; only one transaction can be streamed
+    // at any time, the others may only wait for the user review, or for the host
+    // to collect their result
+    bool isPipelined = false;
+    uint8_t freeSlot = SIGN_TX_SLOTS;
+    for (uint8_t i = 0; i < SIGN_TX_SLOTS; i++) {
+        switch (ctx->slots[i].stage) {
+            case SIGN_STAGE_NONE:
+                if (freeSlot == SIGN_TX_SLOTS) {
+                    freeSlot = i;
+                }
+                break;
+            case SIGN_STAGE_REVIEW:
+                // the user is reviewing the previous transaction right now
+                isPipelined = true;
+                break;
+            case SIGN_STAGE_DONE:
+            case SIGN_STAGE_REJECTED:
+                // the result waits for the host, but the user is free
+                break;
+            default:
+                // another transaction is being streamed
+                VALIDATE(false, ERR_INVALID_STATE);
+        }
+    }
+
+    // make sure we have the slot
+    VALIDATE(freeSlot < SIGN_TX_SLOTS, ERR_INVALID_STATE);
+    ctx->streamSlot = freeSlot;
+
     // make sure we are on the right stage; nothing should have happened before this step
     ASSERT_STAGE(SIGN_STAGE_NONE);
-
-    // validate the p2 value
-    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+    sign_tx_slot_t *slot = streamSlot();
 
     // current stage is to init a new transaction
-    ctx->stage = SIGN_STAGE_INIT;
+    slot->stage = SIGN_STAGE_INIT;
 
     // clear the response ready tag
-    ctx->responseReady = 0;
+    slot->responseReady = 0;
 
     // initialize the incoming tx data stream
-    txStreamInit(&ctx->stream, &ctx->sha3Context, &ctx->tx);
-
-    // parse BIP44 path from the incoming request
-    size_t parsedSize = bip44_parseFromWire(&ctx->path, wireBuffer, wireSize);
+    txStreamInit(&slot->stream, &ctx->sha3Context, &slot->tx);
+
+    // the data field payload is hashed separately so the user can verify it
+    txStreamEnableDataDigest(&slot->stream, &ctx->dataSha3Context);
+
+    // the leading data are kept so we can decode known contract calls
+    memset(ctx->methodData, 0, SIZEOF(ctx->methodData));
+    txStreamEnableDataCapture(&slot->stream, ctx->methodData, SIZEOF(ctx->methodData));
+
+    security_policy_t policy;
+    if (p2 == P2_KEY_SLOT) {
+        // registered key slot has the path validated already
+        // unusual path has been confirmed by user on the slot registration
+        const key_slot_t *keySlot = keySlotFromWire(wireBuffer, wireSize);
+        memcpy(&slot->path, &keySlot->path, SIZEOF(slot->path));
+
+        // only address level path can sign the transaction
+        VALIDATE(keySlot->hasAddress, ERR_INVALID_DATA);
+        policy = POLICY_PROMPT;
+    } else {
+        // parse BIP44 path from the incoming request
+        size_t parsedSize = bip44_parseFromWire(&slot->path, wireBuffer, wireSize);
+
+        // make sure size of the data we parsed corresponds with the data we received
+        VALIDATE(parsedSize == wireSize, ERR_INVALID_DATA);
+
+        // get the security policy for new transaction from a given address
+        policy = policyForSignTxInit(&slot->path);
+        ASSERT_NOT_DENIED(policy);
+    }
 
-    // make sure size of the data we parsed corresponds with the data we received
-    VALIDATE(parsedSize == wireSize, ERR_INVALID_DATA);
+    // the user is busy reviewing previous transaction so we can not ask here;
+    // the warning, if any, is shown on the transaction review and the final
+    // confirmation of the review covers the start of the transaction as well
+    if (isPipelined) {
+        slot->isInitWarning = (policy == POLICY_WARN);
 
-    // get the security policy for new transaction from a given address
-    security_policy_t policy = policyForSignTxInit(&ctx->path);
-    ASSERT_NOT_DENIED(policy);
+        // respond to host that it's ok to send transaction for signing
+        slot->stage = SIGN_STAGE_COLLECT;
+        io_send_buf(SUCCESS, NULL, 0);
+        return;
+    }
 
     // decide what UI step to take first based on policy
     switch (policy) {
         case POLICY_WARN:
             // warn about unusual address request
-            ctx->uiStep = UI_STEP_INIT_WARNING;
+            slot->uiStep = UI_STEP_INIT_WARNING;
             break;
         case POLICY_PROMPT:
-            ctx->uiStep = UI_STEP_INIT_CONFIRM;
+            slot->uiStep = UI_STEP_INIT_CONFIRM;
             break;
         case POLICY_ALLOW:
-            ctx->uiStep = UI_STEP_INIT_RESPOND;
+            slot->uiStep = UI_STEP_INIT_RESPOND;
             break;
         default:
             // if no policy was set, terminate the action
@@ -113,12 +216,13 @@ static void handleSignTxInit(uint8_t p2, uint8_t *wireBuffer, size_t wireSize) {
 static void runSignTransactionInitUIStep() {
     // make sure we are on the right stage
     ASSERT_STAGE(SIGN_STAGE_INIT);
+    sign_tx_slot_t *slot = streamSlot();
 
     // keep reference to self so we can use it as a callback to resume UI
     ui_callback_fn_t *this_fn = runSignTransactionInitUIStep;
 
     // resume the stage based on previous result
-    switch (ctx->uiStep) {
+    switch (slot->uiStep) {
         case UI_STEP_INIT_WARNING: {
             // display the warning
             ui_displayPaginatedText(
@@ -128,7 +232,7 @@ static void runSignTransactionInitUIStep() {
             );
 
             // set next step
-            ctx->uiStep = UI_STEP_INIT_CONFIRM;
+            slot->uiStep = UI_STEP_INIT_CONFIRM;
             #ifndef FUZZING
             break;
             #endif
@@ -144,7 +248,7 @@ static void runSignTransactionInitUIStep() {
             );
 
             // set next step
-            ctx->uiStep = UI_STEP_INIT_RESPOND;
+            slot->uiStep = UI_STEP_INIT_RESPOND;
             #ifndef FUZZING
             break;
             #endif
@@ -159,10 +263,10 @@ static void runSignTransactionInitUIStep() {
 
             // SIG: switch signing stage to collect tx data here
             // we don't do it until we receive user's approval
-            ctx->stage = SIGN_STAGE_COLLECT;
+            slot->stage = SIGN_STAGE_COLLECT;
 
             // UX: set invalid step so we never cycle around
-            ctx->uiStep = UI_STEP_INIT_INVALID;
+            slot->uiStep = UI_STEP_INIT_INVALID;
             break;
         }
 
@@ -173,21 +277,38 @@ static void runSignTransactionInitUIStep() {
     }
 }
 
+// finishSignTxStream implements closing the transaction stream once all the details are received.
+// The data digest is extracted here since the data SHA3 context is shared with the next transaction.
+static void finishSignTxStream(sign_tx_slot_t *slot) {
+    // extract the data digest value from the data SHA3 context
+    cx_hash((cx_hash_t * ) & ctx->dataSha3Context, CX_LAST, slot->dataHash, 0, slot->dataHash, TX_HASH_LENGTH);
+
+    // we expect the final confirmation block next
+    slot->stage = SIGN_STAGE_FINALIZE;
+}
+
 // handleSignTxCollect implements transaction details stream APDU processing.
 // It's the set of intermediate steps where we collect all the transaction details
 // so we can calculate it's signature.
 static void handleSignTxCollect(uint8_t p2, uint8_t *wireBuffer, size_t wireSize) {
     // validate we are on the right stage here
     ASSERT_STAGE(SIGN_STAGE_COLLECT);
+    sign_tx_slot_t *slot = streamSlot();
 
     // validate the p2 value
-    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+    VALIDATE(p2 == P2_RAW_DATA || p2 == P2_ZERO_RUN_DATA, ERR_INVALID_PARAMETERS);
 
     // validate we received at least some data from remote host
     VALIDATE(wireSize > 0, ERR_INVALID_DATA);
 
     // process the wire buffer with the tx stream
-    tx_stream_status_e status = txStreamProcess(&ctx->stream, wireBuffer, wireSize, 0);
+    // compressed data are expanded on the fly so the stream sees the original RLP
+    tx_stream_status_e status;
+    if (p2 == P2_ZERO_RUN_DATA) {
+        status = txStreamProcessZeroRun(&slot->stream, wireBuffer, wireSize, 0);
+    } else {
+        status = txStreamProcess(&slot->stream, wireBuffer, wireSize, 0);
+    }
     switch (status) {
         case TX_STREAM_PROCESSING:
             // the stream is waiting for additional data
@@ -195,7 +316,7 @@ static void handleSignTxCollect(uint8_t p2, uint8_t *wireBuffer, size_t wireSize
             break;
         case TX_STREAM_FINISHED:
             // the stream finished and we expect the next stage
-            ctx->stage = SIGN_STAGE_FINALIZE;
+            finishSignTxStream(slot);
             break;
         case TX_STREAM_FAULT:
             // the stream failed because the incoming data were incorrect
@@ -207,13 +328,173 @@ static void handleSignTxCollect(uint8_t p2, uint8_t *wireBuffer, size_t wireSize
 
     // respond to the host to continue sending data
     // we send the current stage so client can verify the parsing progress
-    uint8_t res = ctx->stage;
+    uint8_t res = slot->stage;
     io_send_buf(SUCCESS, (uint8_t * ) & res, 1);
 
     // we are still busy loading the data
+    // (the detached review of a previous transaction keeps the screen)
+    ui_displayBusy();
+}
+
+// handleSignTxTemplate implements building the transaction from the template.
+// The host sends only the nonce, recipient and value, the rest comes from the template
+// and the whole transaction goes through the stream at once.
+static void handleSignTxTemplate(uint8_t p2, uint8_t *wireBuffer, size_t wireSize) {
+    // validate we are on the right stage here
+    ASSERT_STAGE(SIGN_STAGE_COLLECT);
+    sign_tx_slot_t *slot = streamSlot();
+
+    // validate the p2 value
+    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+
+    // the transaction can not be mixed with streamed data
+    VALIDATE(slot->stream.currentField == TX_RLP_ENVELOPE && !slot->stream.isProcessingField, ERR_INVALID_STATE);
+
+    // build the transaction; it must be complete after this
+    tx_stream_status_e status = txTemplateProcess(&slot->stream, wireBuffer, wireSize);
+    VALIDATE(status == TX_STREAM_FINISHED, ERR_INVALID_DATA);
+    finishSignTxStream(slot);
+
+    // respond with the current stage the same way the details block does
+    uint8_t res = slot->stage;
+    io_send_buf(SUCCESS, (uint8_t * ) & res, 1);
     ui_displayBusy();
 }
 
+// hasOtherBusySlot implements check for any other transaction slot being used.
+static bool hasOtherBusySlot(uint8_t self) {
+    for (uint8_t i = 0; i < SIGN_TX_SLOTS; i++) {
+        if (i != self && ctx->slots[i].stage != SIGN_STAGE_NONE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// reviewPush implements storing a string into the display arena of the transaction slot.
+// False is returned if the string does not fit the arena.
+static bool reviewPush(sign_tx_slot_t *slot, const char *str, uint16_t *offset) {
+    sign_tx_review_t *review = &slot->review;
+    size_t length = strlen(str) + 1;
+
+    // make sure the string fits, including the terminator
+    if (length > SIZEOF(review->arena) - review->used) {
+        return false;
+    }
+
+    memcpy(review->arena + review->used, str, length);
+    *offset = review->used;
+    review->used += length;
+    return true;
+}
+
+// reviewPushRequired implements storing a string which must always fit the display arena.
+static uint16_t reviewPushRequired(sign_tx_slot_t *slot, const char *str) {
+    uint16_t offset = 0;
+    bool isStored = reviewPush(slot, str, &offset);
+
+    // the arena is sized to fit all the mandatory strings
+    ENSURE(isStored);
+    return offset;
+}
+
+// reviewStr implements access to a string stored in the display arena of the transaction slot.
+static inline const char *reviewStr(sign_tx_slot_t *slot, uint16_t offset) {
+    ENSURE(offset < slot->review.used);
+    return slot->review.arena + offset;
+}
+
+// buildReviewStrings implements formatting of all the transaction review strings at once.
+// We do it here, while the SHA3 context is free to be used, so the review does not
+// interfere with another transaction being streamed in the meantime. The UI steps
+// just point the display to the stored strings so moving between screens is cheap.
+static void buildReviewStrings(sign_tx_slot_t *slot) {
+    // the formatting buffer fits any review string we build
+    char tmp[METHOD_STR_BUFFER_SIZE];
+
+    // the mandatory strings must always fit the arena
+    STATIC_ASSERT(2 * MIN_ADDRESS_STR_BUFFER_SIZE + 2 * SIGN_TX_AMOUNT_STR_SIZE +
+                  4 * TX_DATA_FINGERPRINT_SIZE + 3 + 1 <= SIGN_TX_ARENA_SIZE, "bad display arena size");
+
+    // start with empty arena
+    MEMCLEAR(&slot->review, sign_tx_review_t);
+
+    // make sure the advertised address length is well inside the address buffer size
+    ENSURE(slot->tx.recipient.length <= SIZEOF(slot->tx.recipient.value));
+
+    // format the recipient address
+    if (slot->tx.recipient.length > 0) {
+        addressFormatStr(
+                slot->tx.recipient.value, slot->tx.recipient.length,
+                &ctx->sha3Context,
+                tmp, SIZEOF(tmp));
+    } else {
+        // smart contract targeted transaction
+        strcpy(tmp, "New Contract");
+    }
+    slot->review.recipient = reviewPushRequired(slot, tmp);
+
+    // the sender address is not known for cached signature, we don't show it anyway
+    if (slot->tx.sender.length > 0) {
+        // make sure the advertised sender address length is well inside the address buffer size
+        ENSURE(slot->tx.sender.length <= SIZEOF(slot->tx.sender.value));
+
+        addressFormatStr(
+                slot->tx.sender.value, slot->tx.sender.length,
+                &ctx->sha3Context,
+                tmp, SIZEOF(tmp));
+        slot->review.sender = reviewPushRequired(slot, tmp);
+    }
+
+    // make sure the advertised amount length is well inside the buffer size
+    ENSURE(slot->tx.value.length <= SIZEOF(slot->tx.value.value));
+
+    // format transferred amount
+    txGetFormattedAmount(&slot->tx.value, WEI_TO_FTM_DECIMALS, tmp, SIGN_TX_AMOUNT_STR_SIZE);
+    slot->review.amount = reviewPushRequired(slot, tmp);
+
+    // make sure the advertised gas amount and price length is well inside the buffer size
+    ENSURE(slot->tx.gasPrice.length <= SIZEOF(slot->tx.gasPrice.value));
+    ENSURE(slot->tx.startGas.length <= SIZEOF(slot->tx.startGas.value));
+
+    // format max fee
+    txGetFormattedFee(&slot->tx, WEI_TO_FTM_DECIMALS, tmp, SIGN_TX_AMOUNT_STR_SIZE);
+    slot->review.fee = reviewPushRequired(slot, tmp);
+
+    // format short fingerprint of the data digest
+    if (slot->tx.dataLength > 0) {
+        txGetFormattedFingerprint(slot->dataHash, SIZEOF(slot->dataHash), tmp, SIZEOF(tmp));
+        slot->review.digest = reviewPushRequired(slot, tmp);
+    }
+
+    // find the method in the registry of known methods; the captured call data are shared
+    // with the next transaction so we need to decode the call here as well
+    slot->method = methodRegistryLookup(&slot->tx.recipient, ctx->methodData, slot->tx.dataLength);
+
+    // unknown call, or the arguments can not be shown; we fall back to the contract call alert
+    if (slot->method != NULL &&
+        (!methodRegistryFormat(slot->method, ctx->methodData, &ctx->sha3Context, tmp, SIZEOF(tmp)) ||
+         !reviewPush(slot, tmp, &slot->review.method))) {
+        slot->method = NULL;
+    }
+}
+
+// reviewFirstStep implements choosing the first step of the transaction review.
+// The expert user reviews the condensed transaction details in a single flow.
+static int reviewFirstStep() {
+    return (settingsIsExpertMode() ? UI_STEP_TX_DETAILS : UI_STEP_TX_RECIPIENT);
+}
+
+// startDeferredReview implements starting a detached review of the given transaction slot.
+static void startDeferredReview(uint8_t index) {
+    // switch the review to the slot
+    ctx->reviewSlot = index;
+
+    // the user reviews the transaction while the host keeps talking to us
+    ui_setDetached(true);
+    runSignTransactionUIStep();
+}
+
 // handleSignTxFinalize implements transaction signing finalization step.
 // It's the last step where the host signals the transaction is ready for signature,
 // the device makes checks to confirm the transaction data are valid, calculates the signature,
@@ -222,15 +503,23 @@ static void handleSignTxFinalize(uint8_t p2, uint8_t *wireBuffer MARK_UNUSED, si
     // validate we are on the right stage
     // the stream should have signaled to be done parsing the tx by now
     ASSERT_STAGE(SIGN_STAGE_FINALIZE);
+    sign_tx_slot_t *slot = streamSlot();
 
     // validate the p2 value
-    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+    VALIDATE(p2 == P2_ATTACHED_REVIEW || p2 == P2_DEFERRED_REVIEW, ERR_INVALID_PARAMETERS);
+    slot->isDeferred = (p2 == P2_DEFERRED_REVIEW);
 
     // we don't expect to receive any data here
     VALIDATE(wireSize == 0, ERR_INVALID_DATA);
 
-    // we don't expect any more data to be coming from the host
-    io_state = IO_EXPECT_UI;
+    // attached review blocks the APDU exchange until the user decides
+    // so there can not be any other transaction waiting for the host
+    if (!slot->isDeferred) {
+        VALIDATE(!hasOtherBusySlot(ctx->streamSlot), ERR_INVALID_STATE);
+
+        // we don't expect any more data to be coming from the host
+        io_state = IO_EXPECT_UI;
+    }
 
     // get the security policy for new transaction from a given address
     security_policy_t policy = policyForSignTxFinalize();
@@ -238,158 +527,221 @@ static void handleSignTxFinalize(uint8_t p2, uint8_t *wireBuffer MARK_UNUSED, si
 
     // validate the value CHAIN_ID (transferred as <v> on incoming stream) of the transaction
     // We sign only Fantom chain messages to mitigate possible replay attacks.
-    VALIDATE(txGetV(&ctx->tx) == EXPECTED_CHAIN_ID, ERR_INVALID_DATA);
+    VALIDATE(txGetV(&slot->tx) == EXPECTED_CHAIN_ID, ERR_INVALID_DATA);
 
     // extract the transaction hash value from SHA3 context
-    uint8_t hash[TX_HASH_LENGTH];
-    cx_hash((cx_hash_t * ) & ctx->sha3Context, CX_LAST, hash, 0, hash, TX_HASH_LENGTH);
+    cx_hash((cx_hash_t * ) & ctx->sha3Context, CX_LAST, slot->hash, 0, slot->hash, TX_HASH_LENGTH);
+
+    // host retry of a byte identical transaction we signed recently?
+    // the user already reviewed and approved it, so we just ask to resend the signature
+    if (signCacheLookup(&slot->path, slot->hash, TX_HASH_LENGTH, &slot->signature)) {
+        // mark the signature as ready
+        slot->isCachedSignature = true;
+        slot->responseReady = RESPONSE_READY_TAG;
+
+        // run the resend prompt only
+        slot->uiStep = UI_STEP_TX_RESEND;
+    } else {
+        // get the transaction signature
+        txGetSignature(&slot->path, slot->hash, TX_HASH_LENGTH, &ctx->sha3Context, &slot->tx.sender, &slot->signature);
+
+        // mark the signature as ready
+        slot->responseReady = RESPONSE_READY_TAG;
+
+        // decide what UI step to take first based on policy
+        switch (policy) {
+            case POLICY_PROMPT:
+                slot->uiStep = (slot->isInitWarning ? UI_STEP_TX_WARNING : reviewFirstStep());
+                break;
+            case POLICY_ALLOW:
+                slot->uiStep = UI_STEP_TX_RESPOND;
+                break;
+            default:
+                // if no policy was set, terminate the action
+                ASSERT(false);
+        }
+    }
 
-    // get the transaction signature
-    txGetSignature(&ctx->path, hash, TX_HASH_LENGTH, &ctx->sha3Context, &ctx->tx.sender, &ctx->signature);
+    // prepare all the strings for the review
+    buildReviewStrings(slot);
 
-    // mark the signature as ready
-    ctx->responseReady = RESPONSE_READY_TAG;
+    // the attached review runs right away and responds when the user decides
+    if (!slot->isDeferred) {
+        ctx->reviewSlot = ctx->streamSlot;
+        runSignTransactionUIStep();
+        return;
+    }
 
-    // decide what UI step to take first based on policy
-    switch (policy) {
-        case POLICY_PROMPT:
-            ctx->uiStep = UI_STEP_TX_RECIPIENT;
-            break;
-        case POLICY_ALLOW:
-            ctx->uiStep = UI_STEP_TX_RESPOND;
-            break;
-        default:
-            // if no policy was set, terminate the action
-            ASSERT(false);
+    // the deferred review waits for the user, the host collects the result later
+    slot->stage = SIGN_STAGE_REVIEW;
+
+    // start the review now unless the user is still busy with the previous one
+    if (!ui_isDetached()) {
+        startDeferredReview(ctx->streamSlot);
     }
 
-    // run the first step
-    runSignTransactionUIStep();
+    // tell the host where to collect the result
+    uint8_t res[2] = {slot->stage, ctx->streamSlot};
+    io_send_buf(SUCCESS, res, SIZEOF(res));
 }
 
 // runSignTransactionUIStep implements next step in UX flow of the tx signing finalization flow (the last APDU).
 static void runSignTransactionUIStep() {
     // make sure we are on the right stage
-    ASSERT_STAGE(SIGN_STAGE_FINALIZE);
+    sign_tx_slot_t *slot = reviewSlot();
+    VALIDATE(slot->stage == SIGN_STAGE_FINALIZE || slot->stage == SIGN_STAGE_REVIEW, ERR_INVALID_STATE);
 
     // keep reference to self so we can use it as a callback to resume UI
     ui_callback_fn_t *this_fn = runSignTransactionUIStep;
 
     // resume the stage based on previous result
-    switch (ctx->uiStep) {
+    switch (slot->uiStep) {
 
-        case UI_STEP_TX_RECIPIENT: {
-            // make sure the advertised address length is well inside the address buffer size
-            ASSERT(ctx->tx.recipient.length <= SIZEOF(ctx->tx.recipient.value));
-
-            // create formatted address buffer and format for display
-            char addrStr[64];
-            if (ctx->tx.recipient.length > 0) {
-                addressFormatStr(
-                        ctx->tx.recipient.value, ctx->tx.recipient.length,
-                        &ctx->sha3Context,
-                        addrStr, sizeof(addrStr));
-            } else {
-                // smart contract targeted transaction
-                strcpy(addrStr, "New Contract");
+        case UI_STEP_TX_WARNING: {
+            // display the warning postponed from the transaction start
+            ui_displayPaginatedText(
+                    "Unusual Request",
+                    "Be careful!",
+                    this_fn
+            );
+
+            // set next step
+            slot->uiStep = reviewFirstStep();
+            #ifndef FUZZING
+            break;
+            #endif
+        }
+
+        case UI_STEP_TX_DETAILS: {
+            // the data are described by the known method, or by the data digest
+            const char *dataHeaderStr = NULL;
+            const char *dataStr = NULL;
+            if (slot->method != NULL) {
+                dataHeaderStr = slot->method->name;
+                dataStr = reviewStr(slot, slot->review.method);
+            } else if (slot->tx.dataLength > 0) {
+                dataHeaderStr = (slot->tx.isContractCall ? "Contract Data" : "Data Digest");
+                dataStr = reviewStr(slot, slot->review.digest);
             }
 
+            // display the condensed transaction details with the final approval
+            ui_displayTxDetails(
+                    reviewStr(slot, slot->review.recipient),
+                    reviewStr(slot, slot->review.sender),
+                    reviewStr(slot, slot->review.amount),
+                    reviewStr(slot, slot->review.fee),
+                    dataHeaderStr,
+                    dataStr,
+                    this_fn,
+                    rejectSignTransaction
+            );
+
+            // set next step
+            slot->uiStep = UI_STEP_TX_RESPOND;
+            break;
+        }
+
+        case UI_STEP_TX_RECIPIENT: {
             // display the recipient address
             ui_displayPaginatedText(
                     "Send To",
-                    addrStr,
+                    reviewStr(slot, slot->review.recipient),
                     this_fn
             );
 
             // set next step
-            ctx->uiStep = UI_STEP_TX_SENDER;
+            slot->uiStep = UI_STEP_TX_SENDER;
             #ifndef FUZZING
             break;
             #endif
         }
 
         case UI_STEP_TX_SENDER: {
-            // make sure the advertised sender address length
-            // is well inside the address buffer size and that we do have one
-            ASSERT(ctx->tx.sender.length > 0);
-            ASSERT(ctx->tx.sender.length <= SIZEOF(ctx->tx.sender.value));
-
-            // create formatted address buffer and format for display
-            char addrStr[64];
-            addressFormatStr(
-                    ctx->tx.sender.value, ctx->tx.sender.length,
-                    &ctx->sha3Context,
-                    addrStr, sizeof(addrStr));
+            // make sure we do have the sender address
+            ASSERT(slot->tx.sender.length > 0);
 
             // display the sender (derived from path) address
             ui_displayPaginatedText(
                     "Send From",
-                    addrStr,
+                    reviewStr(slot, slot->review.sender),
                     this_fn
             );
 
             // set next step
-            ctx->uiStep = UI_STEP_TX_AMOUNT;
+            slot->uiStep = UI_STEP_TX_AMOUNT;
             #ifndef FUZZING
             break;
             #endif
         }
 
         case UI_STEP_TX_AMOUNT: {
-            // make sure the advertised amount length is well inside the buffer size
-            ASSERT(ctx->tx.value.length <= SIZEOF(ctx->tx.value.value));
-
-            // create formatted address buffer and format for display
-            char valueStr[40];
-            txGetFormattedAmount(&ctx->tx.value, WEI_TO_FTM_DECIMALS, valueStr, sizeof(valueStr));
-
             // display transferred amount for the transaction
             ui_displayPaginatedText(
                     "Amount (FTM)",
-                    valueStr,
+                    reviewStr(slot, slot->review.amount),
                     this_fn
             );
 
             // set next step
-            ctx->uiStep = UI_STEP_TX_FEE;
+            slot->uiStep = UI_STEP_TX_FEE;
             #ifndef FUZZING
             break;
             #endif
         }
 
         case UI_STEP_TX_FEE: {
-            // make sure the advertised gas amount and price length is well inside the buffer size
-            ASSERT(ctx->tx.gasPrice.length <= SIZEOF(ctx->tx.gasPrice.value));
-            ASSERT(ctx->tx.startGas.length <= SIZEOF(ctx->tx.startGas.value));
-
-            // create formatted address buffer and format for display
-            char valueStr[40];
-            txGetFormattedFee(&ctx->tx, WEI_TO_FTM_DECIMALS, valueStr, sizeof(valueStr));
-
             // display max fee for the transaction
             ui_displayPaginatedText(
                     "Max Fee (FTM)",
-                    valueStr,
+                    reviewStr(slot, slot->review.fee),
                     this_fn
             );
 
-            // set next step (for detected contract call show the info)
-            ctx->uiStep = (ctx->tx.isContractCall ? UI_STEP_TX_CONTRACT_CALL : UI_STEP_TX_CONFIRM);
+            // set next step (for detected contract call show the info, for any data show the digest)
+            if (slot->tx.isContractCall) {
+                slot->uiStep = UI_STEP_TX_CONTRACT_CALL;
+            } else {
+                slot->uiStep = (slot->tx.dataLength > 0 ? UI_STEP_TX_DATA_DIGEST : UI_STEP_TX_CONFIRM);
+            }
             #ifndef FUZZING
             break;
             #endif
         }
 
         case UI_STEP_TX_CONTRACT_CALL: {
-            // display the warning
+            if (slot->method != NULL) {
+                // display the known method and its arguments
+                ui_displayPaginatedText(
+                        slot->method->name,
+                        reviewStr(slot, slot->review.method),
+                        this_fn
+                );
+            } else {
+                // display the warning
+                ui_displayPaginatedText(
+                        "Smart Contract",
+                        "Alert",
+                        this_fn
+                );
+            }
+
+            // set next step; contract call always carries some data
+            slot->uiStep = UI_STEP_TX_DATA_DIGEST;
+            #ifndef FUZZING
+            break;
+            #endif
+        }
+
+        case UI_STEP_TX_DATA_DIGEST: {
+            // display the data fingerprint so the user can compare it with the host
             ui_displayPaginatedText(
-                    "Smart Contract",
-                    "Alert",
+                    "Data Digest",
+                    reviewStr(slot, slot->review.digest),
                     this_fn
             );
 
             // set next step
-            ctx->uiStep = UI_STEP_TX_CONFIRM;
+            slot->uiStep = UI_STEP_TX_CONFIRM;
             #ifndef FUZZING
             break;
             #endif
@@ -401,11 +753,27 @@ static void runSignTransactionUIStep() {
                     "Send",
                     "Transaction?",
                     this_fn,
-                    ui_respondWithUserReject
+                    rejectSignTransaction
+            );
+
+            // set next step
+            slot->uiStep = UI_STEP_TX_RESPOND;
+            #ifndef FUZZING
+            break;
+            #endif
+        }
+
+        case UI_STEP_TX_RESEND: {
+            // ask user to confirm sending the cached signature again
+            ui_displayPrompt(
+                    "Resend",
+                    "Signature?",
+                    this_fn,
+                    rejectSignTransaction
             );
 
             // set next step
-            ctx->uiStep = UI_STEP_TX_RESPOND;
+            slot->uiStep = UI_STEP_TX_RESPOND;
             #ifndef FUZZING
             break;
             #endif
@@ -413,19 +781,31 @@ static void runSignTransactionUIStep() {
 
         case UI_STEP_TX_RESPOND: {
             // sanity check; make sure the signature is ready
-            VALIDATE(ctx->responseReady == RESPONSE_READY_TAG, ERR_INVALID_DATA);
+            VALIDATE(slot->responseReady == RESPONSE_READY_TAG, ERR_INVALID_DATA);
+
+            // remember the approved signature so a host retry of the same
+            // transaction does not need to go through the full review again
+            if (!slot->isCachedSignature) {
+                signCacheStore(&slot->path, slot->hash, TX_HASH_LENGTH, &slot->signature);
+            }
 
             // switch stage to mark we are done here
-            ctx->stage = SIGN_STAGE_DONE;
+            slot->stage = SIGN_STAGE_DONE;
+
+            // set invalid step so we never cycle around
+            slot->uiStep = UI_STEP_TX_INVALID;
+
+            // the deferred signature waits for the host to collect it
+            if (slot->isDeferred) {
+                runNextDeferredReview();
+                break;
+            }
 
             // respond to host that it's ok to send transaction for signing
-            io_send_buf(SUCCESS, (uint8_t * ) & ctx->signature, sizeof(ctx->signature));
+            io_send_buf(SUCCESS, (uint8_t * ) & slot->signature, sizeof(slot->signature));
 
             // switch user to idle; we are done here
             ui_idle();
-
-            // set invalid step so we never cycle around
-            ctx->uiStep = UI_STEP_TX_INVALID;
             break;
         }
 
@@ -436,6 +816,103 @@ static void runSignTransactionUIStep() {
     }
 }
 
+// rejectSignTransaction implements UX callback for transaction rejected by the user.
+static void rejectSignTransaction() {
+    sign_tx_slot_t *slot = reviewSlot();
+
+    // attached review responds to the host right away
+    if (!slot->isDeferred) {
+        ui_respondWithUserReject();
+        return;
+    }
+
+    // the host collects the rejection later; clear the signature now
+    explicit_bzero(&slot->signature, SIZEOF(slot->signature));
+    slot->responseReady = 0;
+    slot->stage = SIGN_STAGE_REJECTED;
+    slot->uiStep = UI_STEP_TX_INVALID;
+
+    // move on to the next transaction
+    runNextDeferredReview();
+}
+
+// runNextDeferredReview implements switching the UI to the next transaction waiting for deferred review.
+static void runNextDeferredReview() {
+    // the previous review is over
+    ui_setDetached(false);
+
+    // any other transaction waiting for the user?
+    for (uint8_t i = 0; i < SIGN_TX_SLOTS; i++) {
+        if (ctx->slots[i].stage == SIGN_STAGE_REVIEW) {
+            startDeferredReview(i);
+            return;
+        }
+    }
+
+    // nothing to review; we wait for the host to collect the results
+    ui_displayBusy();
+}
+
+// handleSignTxResult implements collecting result of a transaction with deferred review.
+// The host polls the slot it received on the final confirmation block until the user decides.
+static void handleSignTxResult(uint8_t p2, uint8_t *wireBuffer MARK_UNUSED, size_t wireSize) {
+    // the p2 value is the slot to be collected
+    VALIDATE(p2 < SIGN_TX_SLOTS, ERR_INVALID_PARAMETERS);
+
+    // we don't expect to receive any data here
+    VALIDATE(wireSize == 0, ERR_INVALID_DATA);
+
+    // only deferred review can be collected this way
+    sign_tx_slot_t *slot = &ctx->slots[p2];
+    VALIDATE(slot->isDeferred, ERR_INVALID_STATE);
+
+    switch (slot->stage) {
+        case SIGN_STAGE_REVIEW: {
+            // the user did not decide yet, tell the host to try again later
+            uint8_t res = slot->stage;
+            io_send_buf(SUCCESS, (uint8_t * ) & res, 1);
+            return;
+        }
+        case SIGN_STAGE_DONE:
+            // sanity check; make sure the signature is ready
+            VALIDATE(slot->responseReady == RESPONSE_READY_TAG, ERR_INVALID_DATA);
+            io_send_buf(SUCCESS, (uint8_t * ) & slot->signature, sizeof(slot->signature));
+            break;
+        case SIGN_STAGE_REJECTED:
+            // we don't throw here, the other slot is still alive
+            io_send_buf(ERR_REJECTED_BY_USER, NULL, 0);
+            break;
+        default:
+            VALIDATE(false, ERR_INVALID_STATE);
+    }
+
+    // the result has been collected, free the slot
+    explicit_bzero(slot, SIZEOF(*slot));
+
+    // no more transactions in progress; we are done here
+    if (!hasOtherBusySlot(p2)) {
+        ui_idle();
+    }
+}
+
+// handleSignTxDataDigest implements sending the data digest of the received transaction to the host.
+// The host can compare the digest with the expected content before the user starts the review.
+static void handleSignTxDataDigest(uint8_t p2, uint8_t *wireBuffer MARK_UNUSED, size_t wireSize) {
+    // the transaction stream must be complete, but not finalized yet
+    ASSERT_STAGE(SIGN_STAGE_FINALIZE);
+    sign_tx_slot_t *slot = streamSlot();
+
+    // validate the p2 value
+    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+
+    // we don't expect to receive any data here
+    VALIDATE(wireSize == 0, ERR_INVALID_DATA);
+
+    // send the full digest, the user sees just the fingerprint of it
+    io_send_buf(SUCCESS, slot->dataHash, SIZEOF(slot->dataHash));
+    ui_displayBusy();
+}
+
 // handleSignTransaction implements transaction signature processing proxy.
 // Each signing request goes here first and this function decides where to relay it next.
 void handleSignTransaction(
@@ -454,9 +931,12 @@ void handleSignTransaction(
     // decide based on the p1 value
     // the protocol stages are strict:
     // 1) <INIT> starts the process
-    // 2) <DATA> collects transaction from one, or more APDU
+    // 2) <DATA> collects transaction from one, or more APDU,
+    //    or <TEMPLATE> builds it from the transaction template
     // 3) <FINALIZE> collects the tx hash, asks user for approval
     //    and send the signature back to host
+    // 4) <RESULT> collects the signature of deferred review
+    // The <DIGEST> may be requested between the 2) and the 3) to get the data digest
     // Current stage is asserted inside the sub-handler as the first thing
     switch (p1) {
         case P1_NEW_TRANSACTION:
@@ -465,10 +945,19 @@ void handleSignTransaction(
         case P1_STREAM_DATA:
             handleSignTxCollect(p2, wireBuffer, wireSize);
             break;
+        case P1_TEMPLATE_DATA:
+            handleSignTxTemplate(p2, wireBuffer, wireSize);
+            break;
         case P1_GET_SIGNATURE:
             handleSignTxFinalize(p2, wireBuffer, wireSize);
             break;
+        case P1_GET_RESULT:
+            handleSignTxResult(p2, wireBuffer, wireSize);
+            break;
+        case P1_GET_DATA_DIGEST:
+            handleSignTxDataDigest(p2, wireBuffer, wireSize);
+            break;
         default:
             VALIDATE(false, ERR_INVALID_PARAMETERS);
     }
-}
\ No newline at end of file
+}
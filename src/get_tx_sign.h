@@ -6,6 +6,8 @@
 #include "transaction.h"
 #include "tx_stream.h"
 #include "bip44.h"
+#include "address_utils.h"
+#include "method_registry.h"
 
 // WEI_TO_FTM_DECIMALS defines how many decimals we need to push
 // to convert between WEI units used for transaction amounts and human readable FTMs
@@ -20,6 +22,16 @@
 // handleSignTransaction implements Sign Transaction APDU instruction handler.
 handler_fn_t handleSignTransaction;
 
+// SIGN_TX_SLOTS defines how many transactions can be processed at the same time.
+// The second slot allows the host to stream the next transaction while the user
+// reviews the previous one in the detached review mode. The Nano S does not have
+// enough RAM for the second slot, the pipelined signing is not available there.
+#if defined(TARGET_NANOS)
+#define SIGN_TX_SLOTS 1
+#else
+#define SIGN_TX_SLOTS 2
+#endif
+
 // tx_stage_t declares stages of the transaction signature building
 typedef enum {
     SIGN_STAGE_NONE = 0,
@@ -27,19 +39,59 @@ typedef enum {
     SIGN_STAGE_COLLECT = 2,
     SIGN_STAGE_FINALIZE = 4,
     SIGN_STAGE_DONE = 8,
+    SIGN_STAGE_REVIEW = 16,
+    SIGN_STAGE_REJECTED = 32,
 } tx_stage_t;
 
-// ins_sign_tx_context_t declares context
-// for transaction signature building APDU instruction
+// SIGN_TX_ARENA_SIZE defines the size of the display arena holding all the review strings
+// of a transaction. The strings are packed one after another so the arena always fits both addresses,
+// the amounts and the data digest; a decoded contract call takes what is left.
+#define SIGN_TX_ARENA_SIZE 256
+
+// SIGN_TX_AMOUNT_STR_SIZE defines the max size of the formatted amount and fee strings.
+#define SIGN_TX_AMOUNT_STR_SIZE 40
+
+// sign_tx_review_t declares review strings of a transaction built once the transaction
+// is received. Each string is referenced by its offset inside the display arena.
+typedef struct {
+    uint16_t used;
+    uint16_t recipient;
+    uint16_t sender;
+    uint16_t amount;
+    uint16_t fee;
+    uint16_t digest;
+    uint16_t method;
+    char arena[SIGN_TX_ARENA_SIZE];
+} sign_tx_review_t;
+
+// sign_tx_slot_t declares a single transaction being processed
+// by the transaction signature building APDU instruction.
 typedef struct {
     int16_t responseReady;
     bip44_path_t path;
     transaction_t tx;
     tx_stream_context_t stream;
-    cx_sha3_t sha3Context;
+    uint8_t hash[TX_HASH_LENGTH];
+    uint8_t dataHash[TX_HASH_LENGTH];
     tx_signature_t signature;
+    bool isCachedSignature;
+    bool isDeferred;
+    bool isInitWarning;
     tx_stage_t stage;
     int uiStep;
+    const known_method_t *method;
+    sign_tx_review_t review;
+} sign_tx_slot_t;
+
+// ins_sign_tx_context_t declares context
+// for transaction signature building APDU instruction
+typedef struct {
+    sign_tx_slot_t slots[SIGN_TX_SLOTS];
+    uint8_t streamSlot;
+    uint8_t reviewSlot;
+    cx_sha3_t sha3Context;
+    cx_sha3_t dataSha3Context;
+    uint8_t methodData[METHOD_DATA_SIZE];
 } ins_sign_tx_context_t;
 
 #endif //FANTOM_LEDGER_GET_TX_SIGN_H
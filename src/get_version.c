@@ -2,6 +2,7 @@
 #include "handlers.h"
 #include "ui_helpers.h"
 #include "get_version.h"
+#include "state.h"
 
 // FLAG_DEVELOPMENT_VERSION defines the flag we use for marking
 // development version of the application.
@@ -57,5 +58,8 @@ void handleGetVersion(
     io_send_buf(SUCCESS, (uint8_t * ) & response, sizeof(response));
 
     // go back to app idle state, the instruction has been served
-    ui_idle();
+    // side instruction leaves the UI to the interrupted instruction
+    if (!isSideInstruction) {
+        ui_idle();
+    }
 }
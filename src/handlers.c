@@ -2,9 +2,16 @@
 #include "handlers.h"
 #include "state.h"
 #include "get_version.h"
+#include "get_capabilities.h"
 #include "get_pub_key.h"
 #include "get_address.h"
+#include "get_accounts.h"
+#include "verify_addresses.h"
+#include "key_slots.h"
 #include "get_tx_sign.h"
+#include "tx_template.h"
+#include "sign_message.h"
+#include "sign_typed_data.h"
 
 // getHandler implements APDU instruction to handler mapping.
 // The APDU protocol uses single byte instruction code (INS)
@@ -16,18 +23,63 @@ handler_fn_t *getHandler(uint8_t ins) {
         case INS_VERSION:
             return handleGetVersion;
 
+        case INS_CAPABILITIES:
+            return handleGetCapabilities;
+
         case INS_GET_KEY:
             return handleGetPublicKey;
 
         case INS_GET_ADDR:
             return handleGetAddress;
 
+        case INS_GET_ACCOUNTS:
+            return handleGetAccounts;
+
+        case INS_VERIFY_ADDRESSES:
+            return handleVerifyAddresses;
+
+        case INS_KEY_SLOTS:
+            return handleKeySlots;
+
         case INS_SIGN_TX:
             return handleSignTransaction;
 
+        case INS_TX_TEMPLATE:
+            return handleTxTemplate;
+
+        case INS_SIGN_MSG:
+            return handleSignMessage;
+
+        case INS_SIGN_TYPED_DATA:
+            return handleSignTypedData;
+
         default:
             // we return NULL for unknown instructions
             // so the main loop can throw ERR_UNKNOWN_INS error
             return NULL;
     }
 }
+
+// isSideInstructionAllowed decides if the incoming instruction can be processed
+// in between steps of the current multi-step instruction without terminating it.
+// Only non-interactive instructions are allowed and only between transaction
+// signing steps so host workers can look up addresses during a long tx stream.
+bool isSideInstructionAllowed(int current, uint8_t ins, uint8_t p1) {
+    // the only instruction we can interrupt is the tx signing
+    if (current != INS_SIGN_TX) {
+        return false;
+    }
+
+    switch (ins) {
+        case INS_VERSION:
+        case INS_CAPABILITIES:
+            return true;
+
+        case INS_GET_ADDR:
+            // the address must not be displayed
+            return p1 == GET_ADDRESS_P1_RETURN_ADDRESS;
+
+        default:
+            return false;
+    }
+}
@@ -19,4 +19,8 @@ typedef void handler_fn_t(
 // in that case the main loop throws ERR_UNKNOWN_INS.
 handler_fn_t *getHandler(uint8_t ins);
 
+// isSideInstructionAllowed decides if the incoming instruction can be processed
+// in between steps of the current multi-step instruction without terminating it.
+bool isSideInstructionAllowed(int current, uint8_t ins, uint8_t p1);
+
 #endif
@@ -4,10 +4,14 @@
 #include "io.h"
 #include "assert.h"
 #include "errors.h"
+#include "sign_cache.h"
 
 // io_state keeps the state of the expected i/o exchange.
 io_state_t io_state;
 
+// io_ticks counts SEPROXYHAL ticker events (100ms each) since the app started.
+uint32_t io_ticks;
+
 // CHECK_RESPONSE_SIZE checks is response is within the size of the buffer
 // to prevent unwanted overflows
 void CHECK_RESPONSE_SIZE(unsigned int tx) {
@@ -90,6 +94,10 @@ unsigned char io_event(unsigned char channel MARK_UNUSED) {
             break;
 
         case SEPROXYHAL_TAG_TICKER_EVENT:
+            // advance the app clock and expire cached signatures
+            io_ticks++;
+            signCacheTick();
+
             UX_TICKER_EVENT(G_io_seproxyhal_spi_buffer, {
                     // the ticker is handled by a macro defined above
                     // Disabled for Nano X due to new SDK ignoring this callback on UX_TICKER_EVENT.
@@ -22,6 +22,9 @@ typedef enum {
 // io_state keeps the state of the expected i/o exchange.
 extern io_state_t io_state;
 
+// io_ticks counts SEPROXYHAL ticker events (100ms each) since the app started.
+extern uint32_t io_ticks;
+
 // CHECK_RESPONSE_SIZE implements buffer size validation to prevent buffer overflow.
 void CHECK_RESPONSE_SIZE(unsigned int tx);
 
@@ -0,0 +1,235 @@
+/**
+ * Implements session scoped key slots.
+ *
+ * The host registers a handful of frequently used paths once. Each path is validated
+ * by the security policy, its public key and address are derived and the path is kept
+ * in a slot for the rest of the session. Get Address, Get Public Key and Sign Transaction
+ * instructions can refer to the slot by a single byte slot ID afterwards.
+ *
+ * The slots live in RAM only; they are gone when the device is locked, or the app exits.
+ */
+#include "common.h"
+#include "errors.h"
+#include "state.h"
+#include "ui_helpers.h"
+#include "policy.h"
+#include "key_slots.h"
+
+// ctx hold the direct reference to this instruction context.
+static ins_key_slots_context_t *ctx = &(instructionState.insKeySlotsContext);
+
+// keySlots holds the registered key slots of the session.
+static key_slot_t keySlots[KEY_SLOTS_COUNT];
+
+// RESPONSE_READY_TAG is used to tag the state context that the slot is ready to be registered.
+static int16_t RESPONSE_READY_TAG = 14641;
+
+// what are possible actions on key slots
+// @see /doc/cmd_key_slots.md for details.
+enum {
+    P1_REGISTER_SLOT = 0x00,
+    P1_RELEASE_SLOT = 0x01,
+};
+
+// runKeySlotsUIStep implements next step of UX for the Key Slots instruction.
+static void runKeySlotsUIStep();
+
+// what steps are being handled
+enum {
+    UI_STEP_WARNING = 100,
+    UI_STEP_DISPLAY_PATH,
+    UI_STEP_CONFIRM,
+    UI_STEP_RESPOND,
+    UI_STEP_INVALID,
+};
+
+// keySlotFromWire implements resolving a key slot referenced by the incoming request.
+const key_slot_t *keySlotFromWire(const uint8_t *wireBuffer, size_t wireSize) {
+    // the request contains just the slot ID
+    VALIDATE(wireSize == 1, ERR_INVALID_DATA);
+    VALIDATE(wireBuffer[0] < KEY_SLOTS_COUNT, ERR_INVALID_DATA);
+
+    // the slot must be registered
+    const key_slot_t *slot = &keySlots[wireBuffer[0]];
+    VALIDATE(slot->isValid, ERR_INVALID_DATA);
+    return slot;
+}
+
+// keySlotsClear implements wiping all the registered key slots.
+void keySlotsClear() {
+    explicit_bzero(keySlots, SIZEOF(keySlots));
+}
+
+// handleKeySlotRegister implements registration of a new key slot.
+static void handleKeySlotRegister(uint8_t p2, uint8_t *wireBuffer, size_t wireSize) {
+    // the p2 value is the slot to be registered
+    VALIDATE(p2 < KEY_SLOTS_COUNT, ERR_INVALID_PARAMETERS);
+    ctx->slotId = p2;
+
+    // parse BIP44 path from the incoming request
+    size_t parsedSize = bip44_parseFromWire(&ctx->slot.path, wireBuffer, wireSize);
+
+    // make sure size of the data we parsed corresponds with the data we received
+    VALIDATE(parsedSize == wireSize, ERR_INVALID_DATA);
+
+    // check security policy for the path
+    security_policy_t policy = policyForRegisterKeySlot(&ctx->slot.path);
+    ASSERT_NOT_DENIED(policy);
+
+    // derive the public key and the address (if the path goes down to address level)
+    cx_ecfp_public_key_t publicKey;
+    chain_code_t chainCode;
+    derivePublicKey(&ctx->slot.path, &publicKey, &chainCode);
+
+    extractRawPublicKey(&publicKey, ctx->slot.pubKey.publicKey, SIZEOF(ctx->slot.pubKey.publicKey));
+    ctx->slot.pubKey.length = PUBLIC_KEY_SIZE;
+    memcpy(ctx->slot.pubKey.chainCode, chainCode.code, CHAIN_CODE_SIZE);
+
+    ctx->slot.hasAddress = bip44_containsAddress(&ctx->slot.path);
+    if (ctx->slot.hasAddress) {
+        getRawAddress(&publicKey, &ctx->sha3Context, ctx->slot.address, SIZEOF(ctx->slot.address));
+    }
+
+    // the slot is ready to be registered
+    ctx->slot.isValid = true;
+    ctx->responseReady = RESPONSE_READY_TAG;
+
+    // decide what UI step to take first based on policy
+    switch (policy) {
+        case POLICY_WARN:
+            ctx->uiStep = UI_STEP_WARNING;
+            break;
+        case POLICY_ALLOW:
+            ctx->uiStep = UI_STEP_RESPOND;
+            break;
+        default:
+            // if no policy was set, terminate the action
+            ASSERT(false);
+    }
+
+    // run the first step
+    runKeySlotsUIStep();
+}
+
+// runKeySlotsUIStep implements next step of UX for the Key Slots instruction.
+// Only unusual paths are presented to the user, the others are registered silently.
+static void runKeySlotsUIStep() {
+    // keep the callback to myself
+    ui_callback_fn_t *this_fn = runKeySlotsUIStep;
+
+    // resume the stage based on previous result
+    switch (ctx->uiStep) {
+        case UI_STEP_WARNING: {
+            // display the warning
+            ui_displayPaginatedText(
+                    "Unusual Request",
+                    "Be careful!",
+                    this_fn
+            );
+
+            // set next step
+            ctx->uiStep = UI_STEP_DISPLAY_PATH;
+            break;
+        }
+
+        case UI_STEP_DISPLAY_PATH: {
+            // prep container for BIP44 path and format it
+            char pathStr[100];
+            bip44_pathToStr(&ctx->slot.path, pathStr, SIZEOF(pathStr));
+
+            // display BIP44 path
+            ui_displayPaginatedText(
+                    "Register Path",
+                    pathStr,
+                    this_fn
+            );
+
+            // set next step
+            ctx->uiStep = UI_STEP_CONFIRM;
+            break;
+        }
+
+        case UI_STEP_CONFIRM: {
+            // ask user to confirm the registration
+            ui_displayPrompt(
+                    "Confirm",
+                    "Registration?",
+                    this_fn,
+                    ui_respondWithUserReject
+            );
+
+            // set next step
+            ctx->uiStep = UI_STEP_RESPOND;
+            break;
+        }
+
+        case UI_STEP_RESPOND: {
+            // make sure the slot is ready
+            ASSERT(ctx->responseReady == RESPONSE_READY_TAG);
+            ASSERT(ctx->slotId < KEY_SLOTS_COUNT);
+
+            // register the slot
+            memcpy(&keySlots[ctx->slotId], &ctx->slot, SIZEOF(ctx->slot));
+
+            // respond with the address so the host can verify the slot content
+            struct {
+                uint8_t size;
+                uint8_t address[RAW_ADDRESS_SIZE];
+            } response;
+            response.size = (ctx->slot.hasAddress ? RAW_ADDRESS_SIZE : 0);
+            memcpy(response.address, ctx->slot.address, RAW_ADDRESS_SIZE);
+            io_send_buf(SUCCESS, (uint8_t * ) & response, 1 + response.size);
+            ui_idle();
+
+            // set invalid step so we never cycle around
+            ctx->uiStep = UI_STEP_INVALID;
+            break;
+        }
+
+        default: {
+            // we don't tolerate invalid state
+            ASSERT(false);
+        }
+    }
+}
+
+// handleKeySlotRelease implements releasing a registered key slot.
+static void handleKeySlotRelease(uint8_t p2, size_t wireSize) {
+    // the p2 value is the slot to be released
+    VALIDATE(p2 < KEY_SLOTS_COUNT, ERR_INVALID_PARAMETERS);
+
+    // we don't expect to receive any data here
+    VALIDATE(wireSize == 0, ERR_INVALID_DATA);
+
+    // wipe the slot
+    explicit_bzero(&keySlots[p2], SIZEOF(keySlots[p2]));
+
+    io_send_buf(SUCCESS, NULL, 0);
+    ui_idle();
+}
+
+// handleKeySlots implements APDU instruction handler for Key Slots instruction.
+void handleKeySlots(
+        uint8_t p1,
+        uint8_t p2,
+        uint8_t *wireBuffer,
+        size_t wireSize,
+        bool isOnInit
+) {
+    // make sure the state is clean
+    if (isOnInit) {
+        memset(ctx, 0, SIZEOF(*ctx));
+    }
+
+    // decide based on the p1 value
+    switch (p1) {
+        case P1_REGISTER_SLOT:
+            handleKeySlotRegister(p2, wireBuffer, wireSize);
+            break;
+        case P1_RELEASE_SLOT:
+            handleKeySlotRelease(p2, wireSize);
+            break;
+        default:
+            VALIDATE(false, ERR_INVALID_PARAMETERS);
+    }
+}
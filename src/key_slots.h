@@ -0,0 +1,47 @@
+#ifndef FANTOM_LEDGER_KEY_SLOTS_H
+#define FANTOM_LEDGER_KEY_SLOTS_H
+
+#include "common.h"
+#include "handlers.h"
+#include "bip44.h"
+#include "derive_key.h"
+#include "address_utils.h"
+
+// KEY_SLOTS_COUNT defines how many paths can be registered for the session.
+// Each slot takes about 130 bytes of RAM so we keep just a handful of them.
+#define KEY_SLOTS_COUNT 4
+
+// P2_KEY_SLOT defines the P2 flag of instructions referring to a registered key slot
+// by a single byte slot ID instead of sending the full BIP44 path.
+#define P2_KEY_SLOT 0x01
+
+// handleKeySlots implements Key Slots APDU instruction handler.
+handler_fn_t handleKeySlots;
+
+// key_slot_t declares a single registered path with pre-derived public data.
+typedef struct {
+    bool isValid;
+    bool hasAddress;
+    bip44_path_t path;
+    extended_public_key_t pubKey;
+    uint8_t address[RAW_ADDRESS_SIZE];
+} key_slot_t;
+
+// ins_key_slots_context_t declares context
+// for the key slots registration APDU instruction.
+typedef struct {
+    int16_t responseReady;
+    uint8_t slotId;
+    key_slot_t slot;
+    cx_sha3_t sha3Context;
+    int uiStep;
+} ins_key_slots_context_t;
+
+// keySlotFromWire implements resolving a key slot referenced by the incoming request.
+// The request data must contain just the slot ID of a registered slot.
+const key_slot_t *keySlotFromWire(const uint8_t *wireBuffer, size_t wireSize);
+
+// keySlotsClear implements wiping all the registered key slots.
+void keySlotsClear();
+
+#endif //FANTOM_LEDGER_KEY_SLOTS_H
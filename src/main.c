@@ -20,6 +20,10 @@
 #include "ux.h"
 #include "menu.h"
 #include "io.h"
+#include "sign_cache.h"
+#include "key_slots.h"
+#include "tx_template.h"
+#include "ui_helpers.h"
 
 // The app is designed for specific Ledger API level.
 STATIC_ASSERT(CX_APILEVEL >= API_LEVEL_MIN || CX_APILEVEL <= API_LEVEL_MAX, "bad api level");
@@ -30,6 +34,9 @@ void ui_idle(void) {
     // no instruction is being processed; the last one called idle
     currentIns = INS_NONE;
 
+    // idle UI is always attached to the APDU exchange
+    ui_setDetached(false);
+
     // we support only Nano S and Nano X devices
 #if defined(TARGET_NANOS) || defined(TARGET_NANOX)
     // reserve a display stack slot if none yet
@@ -38,6 +45,7 @@ void ui_idle(void) {
     }
 
     // initiate the idle flow
+    menuPrepare();
     ux_flow_init(0, ux_idle_flow, NULL);
 #else
     // unknown device?
@@ -65,6 +73,9 @@ static void fantom_main(void) {
         {
             TRY
             {
+                // no side instruction is being processed yet
+                isSideInstruction = false;
+
                 // remember the buffer position
                 // ensure no race in CATCH_OTHER if io_exchange throws an error
                 rx = tx;
@@ -88,7 +99,13 @@ static void fantom_main(void) {
 
                 // make sure the device is ready to handle user input
                 // we don't process instructions on locked device, not even non-interactive
-                VALIDATE(device_is_unlocked(), ERR_DEVICE_LOCKED);
+                // and we forget any signatures, key slots and templates created before the device got locked
+                if (!device_is_unlocked()) {
+                    signCacheClear();
+                    keySlotsClear();
+                    txTemplateClear();
+                    THROW(ERR_DEVICE_LOCKED);
+                }
 
                 // read request header elements so we can validate the header
                 // fields in the current processing context
@@ -130,6 +147,12 @@ static void fantom_main(void) {
                     // remember what instruction we process now; start a new instruction
                     currentIns = header->ins;
                     isNew = true;
+                } else if (isSideInstructionAllowed(currentIns, header->ins, header->p1)) {
+                    // non-interactive instruction is served in between steps
+                    // of the current one; it has its own state so the current one is not disturbed
+                    MEMCLEAR(&sideInstructionState, sideInstructionState);
+                    isSideInstruction = true;
+                    isNew = true;
                 } else {
                     // validate that the incoming instruction is the one we handle now
                     // we reject a new instruction in the middle of processing previous one
@@ -166,12 +189,26 @@ static void fantom_main(void) {
                 // Pass valid error codes to host and reset the state to idle.
                 // See errors.h for specific errors meaning.
                 if (e > _ERR_PASS_FROM && e < _ERR_PASS_TO) {
+                    // recoverable fault leaves nothing behind; a fault of a side instruction
+                    // wipes only its own state so the interrupted instruction can go on
+                    if (e == ERR_FAULT) {
+                        if (isSideInstruction) {
+                            wipeSideInstructionState();
+                        } else {
+                            wipeInstructionState();
+                        }
+                    }
+
                     // pass the error code
                     io_send_buf(e, NULL, 0);
 
                     // io_exchange on the start of the loop will block without sending response
                     flags = IO_ASYNCH_REPLY;
-                    ui_idle();
+
+                    // failed side instruction does not terminate the interrupted one
+                    if (!isSideInstruction) {
+                        ui_idle();
+                    }
                 } else {
                     // unknown error happened; reset the device
                     io_seproxyhal_se_reset();
@@ -192,6 +229,11 @@ static void fantom_main(void) {
 
 // app_exit passes the termination intent to system
 static void app_exit(void) {
+    // don't leave any signatures, registered paths, or templates behind
+    signCacheClear();
+    keySlotsClear();
+    txTemplateClear();
+
     BEGIN_TRY_L(exit)
     {
         TRY_L(exit)
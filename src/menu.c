@@ -1,7 +1,9 @@
+#include <string.h>
 #include <os_io_seproxyhal.h>
 #include "menu.h"
 #include "get_version.h"
 #include "glyphs.h"
+#include "settings.h"
 
 // ITEMS macro is used for pure formatting purpose.
 #define ITEMS(...) { __VA_ARGS__ }
@@ -32,6 +34,24 @@ UX_STEP_NOCB(
         )
 );
 
+// expertModeStr keeps the current expert mode setting text shown on the menu.
+static char expertModeStr[10];
+
+// menuToggleExpertMode implements switching the expert mode on the menu.
+static void menuToggleExpertMode();
+
+// ux_idle_expert is the expert mode setting screen; both buttons toggle the setting.
+// Layout contains two lines, bold text and normal text (bn layout).
+UX_STEP_CB(
+        ux_idle_expert,
+        bn,
+        menuToggleExpertMode(),
+        ITEMS(
+            "Expert mode",
+            expertModeStr
+        )
+);
+
 // UX_STEP_CB is a macro for a simple flow step with a validation callback.
 // ux_idle_quit is the app termination screen.
 // Layout contains an icon and single line of bold text (pb layout).
@@ -50,6 +70,21 @@ UX_FLOW(
         ux_idle_flow,
         &ux_idle_main,
         &ux_idle_version,
+        &ux_idle_expert,
         &ux_idle_quit,
         FLOW_LOOP
 );
+
+// menuPrepare implements refreshing the dynamic texts of the idle menu.
+void menuPrepare() {
+    strcpy(expertModeStr, settingsIsExpertMode() ? "Enabled" : "Disabled");
+}
+
+// menuToggleExpertMode implements switching the expert mode on the menu.
+static void menuToggleExpertMode() {
+    settingsSetExpertMode(!settingsIsExpertMode());
+
+    // refresh the text and stay on the setting screen
+    menuPrepare();
+    ux_flow_init(0, ux_idle_flow, &ux_idle_expert);
+}
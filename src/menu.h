@@ -7,4 +7,8 @@
 // ux_idle_flow declares the UI flow for idle state
 extern const ux_flow_step_t* const ux_idle_flow [];
 
+// menuPrepare implements refreshing the dynamic texts of the idle menu.
+// It must be called before the idle flow is displayed.
+void menuPrepare();
+
 #endif //FANTOM_LEDGER_MENU_H
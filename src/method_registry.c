@@ -0,0 +1,241 @@
+/**
+ * Implements the registry of known contract methods.
+ *
+ * The registry is a const table sorted by the method selector so we can use
+ * binary search to find the method called by a transaction. Each record carries
+ * the display name of the method and the layout of its arguments so the review
+ * can show what the call does instead of a generic contract call alert.
+ *
+ * The selector is the first 4 bytes of Keccak hash of the method signature,
+ * e.g. keccak256("delegate(uint256)") = 0x9fa6dd35... Keep the table sorted
+ * when adding new methods, the lookup depends on it.
+ */
+#include <string.h>
+
+#include "common.h"
+#include "method_registry.h"
+#include "get_tx_sign.h"
+#include "address_utils.h"
+#include "uint256.h"
+
+// SFC_ADDRESS defines the address of the Opera SFC (Special Fee Contract) contract
+// responsible for the network staking.
+static const uint8_t SFC_ADDRESS[TX_MAX_ADDRESS_LENGTH] = {
+        0xfc, 0x00, 0xfa, 0xce, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+// KNOWN_METHODS declares the registry of known methods sorted by the selector.
+static const known_method_t KNOWN_METHODS[] = {
+        // restakeRewards(uint256 toValidatorID)
+        {{0x08, 0xc3, 0x68, 0x74}, METHOD_TARGET_SFC, "SFC: restake",
+                {{METHOD_ARG_VALIDATOR, "validator"}}},
+        // approve(address spender, uint256 amount)
+        {{0x09, 0x5e, 0xa7, 0xb3}, METHOD_TARGET_ANY, "Token: approve",
+                {{METHOD_ARG_ADDRESS, "spender"}, {METHOD_ARG_TOKEN_AMOUNT, "amount"}}},
+        // claimRewards(uint256 toValidatorID)
+        {{0x09, 0x62, 0xef, 0x79}, METHOD_TARGET_SFC, "SFC: claim rewards",
+                {{METHOD_ARG_VALIDATOR, "validator"}}},
+        // unlockStake(uint256 toValidatorID, uint256 amount)
+        {{0x1d, 0x3a, 0xc4, 0x2c}, METHOD_TARGET_SFC, "SFC: unlock stake",
+                {{METHOD_ARG_VALIDATOR, "validator"}, {METHOD_ARG_AMOUNT, "amount"}}},
+        // transferFrom(address from, address to, uint256 amount)
+        {{0x23, 0xb8, 0x72, 0xdd}, METHOD_TARGET_ANY, "Token: transferFrom",
+                {{METHOD_ARG_ADDRESS, "from"}, {METHOD_ARG_ADDRESS, "to"}, {METHOD_ARG_TOKEN_AMOUNT, "amount"}}},
+        // withdraw(uint256 toValidatorID, uint256 wrID)
+        {{0x44, 0x1a, 0x3e, 0x70}, METHOD_TARGET_SFC, "SFC: withdraw",
+                {{METHOD_ARG_VALIDATOR, "validator"}, {METHOD_ARG_NUMBER, "request"}}},
+        // undelegate(uint256 toValidatorID, uint256 wrID, uint256 amount)
+        {{0x4f, 0x86, 0x4d, 0xf4}, METHOD_TARGET_SFC, "SFC: undelegate",
+                {{METHOD_ARG_VALIDATOR, "validator"}, {METHOD_ARG_NUMBER, "request"}, {METHOD_ARG_AMOUNT, "amount"}}},
+        // delegate(uint256 toValidatorID)
+        {{0x9f, 0xa6, 0xdd, 0x35}, METHOD_TARGET_SFC, "SFC: delegate",
+                {{METHOD_ARG_VALIDATOR, "validator"}}},
+        // transfer(address to, uint256 amount)
+        {{0xa9, 0x05, 0x9c, 0xbb}, METHOD_TARGET_ANY, "Token: transfer",
+                {{METHOD_ARG_ADDRESS, "to"}, {METHOD_ARG_TOKEN_AMOUNT, "amount"}}},
+        // relockStake(uint256 toValidatorID, uint256 lockupDuration, uint256 amount)
+        {{0xbd, 0x14, 0xd9, 0x07}, METHOD_TARGET_SFC, "SFC: relock stake",
+                {{METHOD_ARG_VALIDATOR, "validator"}, {METHOD_ARG_DURATION, "lockup"}, {METHOD_ARG_AMOUNT, "amount"}}},
+        // lockStake(uint256 toValidatorID, uint256 lockupDuration, uint256 amount)
+        {{0xde, 0x67, 0xf2, 0x15}, METHOD_TARGET_SFC, "SFC: lock stake",
+                {{METHOD_ARG_VALIDATOR, "validator"}, {METHOD_ARG_DURATION, "lockup"}, {METHOD_ARG_AMOUNT, "amount"}}},
+};
+
+// methodArgsCount implements counting arguments of a known method.
+static uint32_t methodArgsCount(const known_method_t *method) {
+    uint32_t count = 0;
+    while (count < METHOD_MAX_ARGS && method->args[count].type != METHOD_ARG_NONE) {
+        count++;
+    }
+    return count;
+}
+
+// methodIsTargetValid implements check of the transaction recipient against the method target.
+static bool methodIsTargetValid(const known_method_t *method, const tx_address_t *recipient) {
+    switch (method->target) {
+        case METHOD_TARGET_ANY:
+            return recipient->length == TX_MAX_ADDRESS_LENGTH;
+        case METHOD_TARGET_SFC:
+            return recipient->length == TX_MAX_ADDRESS_LENGTH &&
+                   memcmp(recipient->value, SFC_ADDRESS, TX_MAX_ADDRESS_LENGTH) == 0;
+        default:
+            return false;
+    }
+}
+
+// methodAreArgsValid implements check of the ABI encoded arguments against the method layout.
+static bool methodAreArgsValid(const known_method_t *method, const uint8_t *data) {
+    for (uint32_t i = 0; i < methodArgsCount(method); i++) {
+        const uint8_t *arg = data + METHOD_SELECTOR_SIZE + i * METHOD_ARG_SIZE;
+
+        // address is encoded as 20 bytes value left padded with zeros
+        if (method->args[i].type == METHOD_ARG_ADDRESS) {
+            for (uint32_t j = 0; j < METHOD_ARG_SIZE - TX_MAX_ADDRESS_LENGTH; j++) {
+                if (arg[j] != 0) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+// methodRegistryLookup implements search for a known method called by the transaction.
+const known_method_t *methodRegistryLookup(
+        const tx_address_t *recipient,
+        const uint8_t *data,
+        uint32_t dataLength
+) {
+    // we need at least the selector to do anything
+    if (dataLength < METHOD_SELECTOR_SIZE) {
+        return NULL;
+    }
+
+    // binary search the sorted registry
+    size_t low = 0;
+    size_t high = ARRAY_LEN(KNOWN_METHODS);
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        const known_method_t *method = &KNOWN_METHODS[mid];
+
+        int cmp = memcmp(data, method->selector, METHOD_SELECTOR_SIZE);
+        if (cmp < 0) {
+            high = mid;
+        } else if (cmp > 0) {
+            low = mid + 1;
+        } else {
+            // the call must match the method exactly, including the contract
+            // and the arguments layout; anything else is an unknown call
+            if (!methodIsTargetValid(method, recipient)) {
+                return NULL;
+            }
+            if (dataLength != METHOD_SELECTOR_SIZE + methodArgsCount(method) * METHOD_ARG_SIZE) {
+                return NULL;
+            }
+            if (!methodAreArgsValid(method, data)) {
+                return NULL;
+            }
+            return method;
+        }
+    }
+
+    return NULL;
+}
+
+// methodAppendStr implements appending a string to the formatted output buffer.
+static bool methodAppendStr(char *out, size_t outSize, size_t *offset, const char *str) {
+    size_t length = strlen(str);
+
+    // we need to keep the space for the terminator
+    if (*offset + length >= outSize) {
+        return false;
+    }
+
+    memcpy(out + *offset, str, length + 1);
+    *offset += length;
+    return true;
+}
+
+// methodFormatArg implements formatting of a single argument value.
+static bool methodFormatArg(
+        const method_arg_t *arg,
+        const uint8_t *value,
+        cx_sha3_t *sha3Context,
+        char *out,
+        size_t outSize
+) {
+    switch (arg->type) {
+        case METHOD_ARG_ADDRESS:
+            // the address is right aligned in the argument
+            addressFormatStr(
+                    (uint8_t *) value + METHOD_ARG_SIZE - TX_MAX_ADDRESS_LENGTH, TX_MAX_ADDRESS_LENGTH,
+                    sha3Context,
+                    out, outSize);
+            return true;
+        case METHOD_ARG_AMOUNT: {
+            // the amount is in WEI, we show FTM units
+            tx_int256_t amount;
+            memcpy(amount.value, value, METHOD_ARG_SIZE);
+            amount.length = METHOD_ARG_SIZE;
+            txGetFormattedAmount(&amount, WEI_TO_FTM_DECIMALS, out, outSize);
+            return true;
+        }
+        case METHOD_ARG_VALIDATOR:
+        case METHOD_ARG_TOKEN_AMOUNT:
+        case METHOD_ARG_NUMBER:
+        case METHOD_ARG_DURATION: {
+            // plain decimal value; token decimals are not known to us
+            uint256_t number;
+            uint256ConvertBE(&number, value, METHOD_ARG_SIZE);
+            return uint256ToString(&number, 10, out, outSize) > 0;
+        }
+        default:
+            return false;
+    }
+}
+
+// methodRegistryFormat implements formatting of the known method arguments for the review.
+bool methodRegistryFormat(
+        const known_method_t *method,
+        const uint8_t *data,
+        cx_sha3_t *sha3Context,
+        char *out,
+        size_t outSize
+) {
+    // make sanity check, the buffer may never exceed this size
+    ENSURE(outSize < MAX_BUFFER_SIZE);
+    ENSURE(outSize > 0);
+
+    size_t offset = 0;
+    out[0] = 0;
+
+    for (uint32_t i = 0; i < methodArgsCount(method); i++) {
+        const method_arg_t *arg = &method->args[i];
+
+        // format the value first; 78 digits is the longest 256 bits decimal number
+        char valueStr[80];
+        if (!methodFormatArg(arg, data + METHOD_SELECTOR_SIZE + i * METHOD_ARG_SIZE,
+                             sha3Context, valueStr, SIZEOF(valueStr))) {
+            return false;
+        }
+
+        // build the "label value unit" part separated from the previous one
+        if ((i > 0 && !methodAppendStr(out, outSize, &offset, ", ")) ||
+            !methodAppendStr(out, outSize, &offset, arg->label) ||
+            !methodAppendStr(out, outSize, &offset, " ") ||
+            !methodAppendStr(out, outSize, &offset, valueStr)) {
+            return false;
+        }
+
+        // add units where it's not obvious
+        if (arg->type == METHOD_ARG_AMOUNT && !methodAppendStr(out, outSize, &offset, " FTM")) {
+            return false;
+        }
+        if (arg->type == METHOD_ARG_DURATION && !methodAppendStr(out, outSize, &offset, " s")) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,82 @@
+#ifndef FANTOM_LEDGER_METHOD_REGISTRY_H
+#define FANTOM_LEDGER_METHOD_REGISTRY_H
+
+#include "common.h"
+#include "transaction.h"
+
+// METHOD_SELECTOR_SIZE defines size of the contract method selector,
+// it's the first 4 bytes of Keccak hash of the method signature.
+#define METHOD_SELECTOR_SIZE 4
+
+// METHOD_ARG_SIZE defines size of a single ABI encoded method argument.
+#define METHOD_ARG_SIZE 32
+
+// METHOD_MAX_ARGS defines how many arguments a known method can have.
+#define METHOD_MAX_ARGS 3
+
+// METHOD_DATA_SIZE defines how many leading bytes of the transaction data
+// we need to keep to decode any known method call.
+#define METHOD_DATA_SIZE (METHOD_SELECTOR_SIZE + METHOD_MAX_ARGS * METHOD_ARG_SIZE)
+
+// METHOD_NAME_SIZE defines the size of the method display name including terminator.
+#define METHOD_NAME_SIZE 20
+
+// METHOD_ARG_LABEL_SIZE defines the size of the argument display label including terminator.
+#define METHOD_ARG_LABEL_SIZE 10
+
+// METHOD_STR_BUFFER_SIZE defines the size of the formatted method arguments buffer.
+// Arguments which do not fit are not shown in part, the call is reported as unknown.
+#define METHOD_STR_BUFFER_SIZE 160
+
+// method_arg_e declares how a known method argument is decoded and displayed.
+typedef enum {
+    METHOD_ARG_NONE = 0,
+    METHOD_ARG_VALIDATOR,
+    METHOD_ARG_ADDRESS,
+    METHOD_ARG_AMOUNT,
+    METHOD_ARG_TOKEN_AMOUNT,
+    METHOD_ARG_NUMBER,
+    METHOD_ARG_DURATION,
+} method_arg_e;
+
+// method_target_e declares which contracts the known method is recognized on.
+typedef enum {
+    // the method is recognized on any contract
+    METHOD_TARGET_ANY = 0,
+
+    // the method is recognized on the Opera SFC contract only
+    METHOD_TARGET_SFC,
+} method_target_e;
+
+// method_arg_t declares a single known method argument.
+typedef struct {
+    uint8_t type;
+    char label[METHOD_ARG_LABEL_SIZE];
+} method_arg_t;
+
+// known_method_t declares a record of the known method registry.
+typedef struct {
+    uint8_t selector[METHOD_SELECTOR_SIZE];
+    uint8_t target;
+    char name[METHOD_NAME_SIZE];
+    method_arg_t args[METHOD_MAX_ARGS];
+} known_method_t;
+
+// methodRegistryLookup implements search for a known method called by the transaction.
+// The recipient must match the method target and the data length must match the method
+// arguments exactly, otherwise NULL is returned and the call is handled as unknown.
+const known_method_t *methodRegistryLookup(
+        const tx_address_t *recipient,
+        const uint8_t *data,
+        uint32_t dataLength);
+
+// methodRegistryFormat implements formatting of the known method arguments for the review.
+// False is returned if the arguments can not be decoded, or don't fit the output buffer.
+bool methodRegistryFormat(
+        const known_method_t *method,
+        const uint8_t *data,
+        cx_sha3_t *sha3Context,
+        char *out,
+        size_t outSize);
+
+#endif //FANTOM_LEDGER_METHOD_REGISTRY_H
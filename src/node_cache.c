@@ -0,0 +1,115 @@
+/**
+ * Implements the persistent cache of chain level public nodes.
+ *
+ * Address derivation on the device requires a full BIP32 derivation from the seed
+ * for every single address. We keep public keys and chain codes of recently used
+ * m/44'/60'/account'/change nodes in NVRAM so addresses can be derived from
+ * the cached public node by the public child key derivation, even after the app restart.
+ */
+#include <os_io_seproxyhal.h>
+#include <stddef.h>
+
+#include "common.h"
+#include "node_cache.h"
+
+// N_nodeCache_real is the NVRAM storage of the cache; it must be accessed via N_nodeCache.
+const node_cache_storage_t N_nodeCache_real;
+
+// N_nodeCache implements PIC safe access to the NVRAM storage of the cache.
+#define N_nodeCache (*(volatile node_cache_storage_t *) PIC(&N_nodeCache_real))
+
+// nodeCacheNext holds the record to be replaced by the next store.
+// The ring pointer lives in RAM so a cache miss costs a single NVRAM write;
+// the replacement starts over from the first record after the app restart.
+static uint8_t nodeCacheNext;
+
+// SEED_COOKIE_SIZE defines size of the seed cookie we bind the records with.
+#define SEED_COOKIE_SIZE 64
+
+// nodeCacheIsCacheable implements check if the node of given path can be cached.
+bool nodeCacheIsCacheable(const bip44_path_t *nodePath) {
+    return bip44_hasValidFantomPrefix(nodePath) &&
+           nodePath->length == BIP44_I_CHANGE + 1 &&
+           bip44_isHardened(nodePath->path[BIP44_I_ACCOUNT]);
+}
+
+// nodeCacheTag implements calculation of the record integrity tag.
+// The tag is SHA256 of the device seed cookie and the public record data.
+static void nodeCacheTag(const node_cache_entry_t *entry, uint8_t *tag, size_t tagSize) {
+    // make sure the tag size is what we expect
+    ASSERT(tagSize == NODE_CACHE_TAG_SIZE);
+
+    // get the seed cookie; it changes with the seed
+    uint8_t cookie[SEED_COOKIE_SIZE];
+    os_perso_seed_cookie(cookie, SIZEOF(cookie));
+
+    // hash the cookie and everything on the record before the tag
+    cx_sha256_t sha256Context;
+    cx_sha256_init(&sha256Context);
+    cx_hash((cx_hash_t * ) & sha256Context, 0, cookie, SIZEOF(cookie), NULL, 0);
+    cx_hash((cx_hash_t * ) & sha256Context, CX_LAST, (const uint8_t *) entry, offsetof(node_cache_entry_t, tag), tag, tagSize);
+
+    // clean the cookie
+    explicit_bzero(cookie, SIZEOF(cookie));
+}
+
+// nodeCacheLookup implements search for the node public key and chain code in the cache.
+bool nodeCacheLookup(const bip44_path_t *nodePath, cx_ecfp_public_key_t *publicKey, chain_code_t *chainCode) {
+    // make sure we cache this type of node at all
+    if (!nodeCacheIsCacheable(nodePath)) {
+        return false;
+    }
+
+    node_cache_entry_t entry;
+    uint8_t tag[NODE_CACHE_TAG_SIZE];
+
+    // loop the records and try to find the node
+    for (size_t i = 0; i < NODE_CACHE_SIZE; i++) {
+        // copy the record from NVRAM
+        memcpy(&entry, (const void *) &N_nodeCache.entries[i], SIZEOF(entry));
+
+        // is this the node?
+        if (entry.account != nodePath->path[BIP44_I_ACCOUNT] || entry.change != nodePath->path[BIP44_I_CHANGE]) {
+            continue;
+        }
+
+        // verify the record integrity and the seed binding
+        nodeCacheTag(&entry, tag, SIZEOF(tag));
+        if (memcmp(tag, entry.tag, SIZEOF(tag)) != 0) {
+            continue;
+        }
+
+        // load the public key and the chain code
+        cx_ecfp_init_public_key(CX_CURVE_256K1, entry.publicKey, SIZEOF(entry.publicKey), publicKey);
+        memcpy(chainCode->code, entry.chainCode, SIZEOF(chainCode->code));
+        return true;
+    }
+
+    return false;
+}
+
+// nodeCacheStore implements storing the node public key and chain code to the cache.
+void nodeCacheStore(const bip44_path_t *nodePath, const cx_ecfp_public_key_t *publicKey, const chain_code_t *chainCode) {
+    // make sure we cache this type of node at all
+    if (!nodeCacheIsCacheable(nodePath)) {
+        return;
+    }
+
+    // make sure the data fit the record
+    ASSERT(SIZEOF(publicKey->W) == SIZEOF(((node_cache_entry_t *) 0)->publicKey));
+    ASSERT(SIZEOF(chainCode->code) == SIZEOF(((node_cache_entry_t *) 0)->chainCode));
+
+    // build the record in RAM
+    node_cache_entry_t entry;
+    memset(&entry, 0, SIZEOF(entry));
+    entry.account = nodePath->path[BIP44_I_ACCOUNT];
+    entry.change = nodePath->path[BIP44_I_CHANGE];
+    memcpy(entry.publicKey, publicKey->W, SIZEOF(entry.publicKey));
+    memcpy(entry.chainCode, chainCode->code, SIZEOF(entry.chainCode));
+    nodeCacheTag(&entry, entry.tag, SIZEOF(entry.tag));
+
+    // write the record and advance the ring
+    ASSERT(nodeCacheNext < NODE_CACHE_SIZE);
+    nvm_write((void *) &N_nodeCache.entries[nodeCacheNext], &entry, SIZEOF(entry));
+    nodeCacheNext = (uint8_t) ((nodeCacheNext + 1) % NODE_CACHE_SIZE);
+}
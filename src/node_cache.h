@@ -0,0 +1,43 @@
+#ifndef FANTOM_LEDGER_NODE_CACHE_H
+#define FANTOM_LEDGER_NODE_CACHE_H
+
+#include "common.h"
+#include "bip44.h"
+#include "derive_key.h"
+
+// NODE_CACHE_SIZE defines how many chain nodes m/44'/60'/account'/change we keep in NVRAM.
+// Each record costs about 140 bytes of flash; the oldest record is replaced when full.
+#define NODE_CACHE_SIZE 4
+
+// NODE_CACHE_TAG_SIZE defines size of the integrity tag of a cache record.
+#define NODE_CACHE_TAG_SIZE 32
+
+// node_cache_entry_t declares a single record of the public node cache.
+// Only public data are stored, the private key of the node never leaves RAM.
+// The tag binds the record to the device seed so records created with a different
+// seed (e.g. after the device has been restored) are never used.
+typedef struct {
+    uint32_t account;
+    uint32_t change;
+    uint8_t publicKey[65];
+    uint8_t chainCode[32];
+    uint8_t tag[NODE_CACHE_TAG_SIZE];
+} node_cache_entry_t;
+
+// node_cache_storage_t declares the NVRAM layout of the public node cache.
+typedef struct {
+    node_cache_entry_t entries[NODE_CACHE_SIZE];
+} node_cache_storage_t;
+
+// nodeCacheIsCacheable implements check if the node of given path can be cached.
+// We cache only the change level nodes m/44'/60'/account'/change.
+bool nodeCacheIsCacheable(const bip44_path_t *nodePath);
+
+// nodeCacheLookup implements search for the node public key and chain code in the cache.
+// True is returned if a valid record has been found and copied to the output.
+bool nodeCacheLookup(const bip44_path_t *nodePath, cx_ecfp_public_key_t *publicKey, chain_code_t *chainCode);
+
+// nodeCacheStore implements storing the node public key and chain code to the cache.
+void nodeCacheStore(const bip44_path_t *nodePath, const cx_ecfp_public_key_t *publicKey, const chain_code_t *chainCode);
+
+#endif //FANTOM_LEDGER_NODE_CACHE_H
@@ -23,6 +23,62 @@ security_policy_t policyForGetPublicKey(const bip44_path_t *path) {
     PROMPT_IF(true);
 }
 
+// policyForGetAccounts implements policy test for a range of accounts public keys export.
+security_policy_t policyForGetAccounts(const bip44_path_t *firstPath, const bip44_path_t *lastPath) {
+    // deny if the path does not contain valid Fantom prefix
+    DENY_IF(!bip44_hasValidFantomPrefix(firstPath));
+
+    // deny if the path does not contain account index
+    DENY_IF(!bip44_containsAccount(firstPath) || !bip44_containsAccount(lastPath));
+
+    // warn if the range reaches weird account depth
+    WARN_IF(!bip44_hasReasonableAccount(lastPath));
+
+    // display prompt by default
+    PROMPT_IF(true);
+}
+
+// policyForVerifyAddresses implements policy test for bulk address verification.
+security_policy_t policyForVerifyAddresses(const bip44_path_t *path) {
+    // deny if the path does not contain valid Fantom prefix
+    DENY_IF(!bip44_hasValidFantomPrefix(path));
+
+    // deny if the path is not a chain node; addresses are added by the host
+    DENY_IF(!bip44_containsChangeType(path) || bip44_containsAddress(path));
+
+    // warn if the path has weird account depth
+    WARN_IF(!bip44_hasReasonableAccount(path));
+
+    // warn if the path has unknown chain type
+    WARN_IF(!bip44_hasValidChangeType(path));
+
+    // display prompt by default
+    PROMPT_IF(true);
+}
+
+// policyForRegisterKeySlot implements policy test for a path being registered to a key slot.
+// The slot does not export anything on its own, the instructions using the slot
+// keep asking user to confirm the export, or the transaction.
+security_policy_t policyForRegisterKeySlot(const bip44_path_t *path) {
+    // deny if the path does not contain valid Fantom prefix
+    DENY_IF(!bip44_hasValidFantomPrefix(path));
+
+    // deny if the path does not contain account index
+    DENY_IF(!bip44_containsAccount(path));
+
+    // warn if the path has weird account depth
+    WARN_IF(!bip44_hasReasonableAccount(path));
+
+    // warn if the path has weird address depth
+    WARN_IF(bip44_containsAddress(path) && !bip44_hasReasonableAddress(path));
+
+    // warn if the path has more fields than defined by BIP44 standard
+    WARN_IF(bip44_containsMoreThanAddress(path));
+
+    // register silently by default
+    ALLOW_IF(true);
+}
+
 // policyForGetPublicKey implements policy test for address derivation.
 security_policy_t policyForGetAddress(const bip44_path_t *path, const bool isShowAddress) {
     // deny if the path does not contain valid Fantom prefix
@@ -75,6 +131,30 @@ security_policy_t policyForSignTxInit(const bip44_path_t *path) {
     PROMPT_IF(true);
 }
 
+// policyForSignMessage implements policy test for personal message being signed.
+security_policy_t policyForSignMessage(const bip44_path_t *path) {
+    // deny if the path does not contain valid Fantom prefix
+    DENY_IF(!bip44_hasValidFantomPrefix(path));
+
+    // deny if the path does not contain valid chain / change index
+    DENY_IF(!bip44_containsChangeType(path));
+
+    // deny if the path does not contain valid address index
+    DENY_IF(!bip44_containsAddress(path));
+
+    // warn if the path has weird account depth
+    WARN_IF(!bip44_hasReasonableAccount(path));
+
+    // warn if the path has weird address depth
+    WARN_IF(!bip44_hasReasonableAddress(path));
+
+    // warn if the path has more fields than defined by BIP44 standard
+    WARN_IF(bip44_containsMoreThanAddress(path));
+
+    // we always ask user to review the message
+    PROMPT_IF(true);
+}
+
 // policyForSignTxFinalize implements policy test for transaction signature being provided.
 security_policy_t policyForSignTxFinalize() {
     // we ask user if it's ok to sign the transaction
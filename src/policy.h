@@ -34,9 +34,21 @@ security_policy_t policyForGetPublicKey(const bip44_path_t* path);
 // policyForGetPublicKey implements policy test for address derivation.
 security_policy_t policyForGetAddress(const bip44_path_t* path, const bool isShowAddress);
 
+// policyForGetAccounts implements policy test for a range of accounts public keys export.
+security_policy_t policyForGetAccounts(const bip44_path_t* firstPath, const bip44_path_t* lastPath);
+
+// policyForVerifyAddresses implements policy test for bulk address verification.
+security_policy_t policyForVerifyAddresses(const bip44_path_t* path);
+
+// policyForRegisterKeySlot implements policy test for a path being registered to a key slot.
+security_policy_t policyForRegisterKeySlot(const bip44_path_t* path);
+
 // policyForSignTxInit implements policy test for new transaction being signed.
 security_policy_t policyForSignTxInit(const bip44_path_t* path);
 
+// policyForSignMessage implements policy test for personal message being signed.
+security_policy_t policyForSignMessage(const bip44_path_t* path);
+
 // policyForSignTxFinalize implements policy test for transaction signature being provided.
 security_policy_t policyForSignTxFinalize();
 
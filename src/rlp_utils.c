@@ -172,3 +172,31 @@ bool rlpDecodeLength(uint8_t *buffer, uint32_t bufferLength, uint32_t *fieldLeng
     }
     return true;
 }
+
+// rlpEncodeLength implements RLP string, or list header encoder.
+uint32_t rlpEncodeLength(uint32_t length, bool isList, uint8_t *out, uint32_t outSize) {
+    // strings and lists use different offsets
+    uint8_t offset = (isList ? 0xC0 : 0x80);
+
+    // short payload has the length encoded in the header byte
+    if (length <= 55) {
+        ENSURE(outSize >= 1);
+        out[0] = offset + (uint8_t) length;
+        return 1;
+    }
+
+    // how many bytes do we need for the length
+    uint32_t lengthSize = 0;
+    for (uint32_t rest = length; rest > 0; rest >>= 8) {
+        lengthSize++;
+    }
+    ENSURE(outSize >= 1 + lengthSize);
+
+    // long payload has the length of the length in the header byte, the length follows in big endian
+    out[0] = offset + 55 + (uint8_t) lengthSize;
+    for (uint32_t i = lengthSize; i > 0; i--) {
+        out[i] = (uint8_t) (length & 0xFF);
+        length >>= 8;
+    }
+    return 1 + lengthSize;
+}
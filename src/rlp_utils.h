@@ -13,4 +13,8 @@ bool rlpCanDecode(uint8_t *buffer, uint32_t length, bool *isValid);
 // some details about the field itself.
 bool rlpDecodeLength(uint8_t *buffer, uint32_t bufferLength, uint32_t *fieldLength, uint32_t *offset, bool *isList);
 
+// rlpEncodeLength implements RLP string, or list header encoder.
+// The header for the given payload length is written to the output buffer and its size is returned.
+uint32_t rlpEncodeLength(uint32_t length, bool isList, uint8_t *out, uint32_t outSize);
+
 #endif //FANTOM_LEDGER_RLP_UTILS_H
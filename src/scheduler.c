@@ -0,0 +1,66 @@
+/**
+ * Implements cooperative scheduler of long running operations.
+ *
+ * Bulk operations, like deriving and verifying many addresses, are split
+ * into resumable work items. The scheduler runs the work in short slices
+ * and keeps the SEPROXYHAL heartbeat going between them, so the USB, or BLE,
+ * transport does not time out while the device is busy.
+ */
+#include <os_io_seproxyhal.h>
+
+#include "common.h"
+#include "ui_helpers.h"
+#include "scheduler.h"
+
+// schedulerInit implements setting up a work item of the given number of steps.
+void schedulerInit(work_item_t *item, work_step_fn_t *step, uint32_t count) {
+    ASSERT(step != NULL);
+
+    MEMCLEAR(item, work_item_t);
+    item->step = step;
+    item->count = count;
+}
+
+// schedulerIsDone implements check if the work item has been finished.
+bool schedulerIsDone(const work_item_t *item) {
+    return item->isStopped || item->next >= item->count;
+}
+
+// schedulerRunSlice implements running a single slice of the work item.
+static uint32_t schedulerRunSlice(work_item_t *item, uint32_t budget) {
+    uint32_t steps = 0;
+
+    while (steps < budget && steps < SCHEDULER_SLICE_STEPS && !schedulerIsDone(item)) {
+        // advance the position before the step so a failed step is never repeated
+        uint32_t index = item->next++;
+        steps++;
+
+        // the step may finish the work early
+        if (!item->step(index)) {
+            item->isStopped = true;
+        }
+    }
+
+    return steps;
+}
+
+// schedulerRun implements running the work item in bounded slices.
+uint32_t schedulerRun(work_item_t *item, uint32_t budget) {
+    // make sure the item has been set up
+    ASSERT(item->step != NULL);
+
+    uint32_t total = 0;
+    while (total < budget && !schedulerIsDone(item)) {
+        total += schedulerRunSlice(item, budget - total);
+
+        // yield to SEPROXYHAL between slices so the transport stays alive
+        io_seproxyhal_io_heartbeat();
+
+        // let the user know we are still working if there is more to do
+        if (total < budget && !schedulerIsDone(item)) {
+            ui_displayProgress(item->next, item->count);
+        }
+    }
+
+    return total;
+}
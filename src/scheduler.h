@@ -0,0 +1,36 @@
+#ifndef FANTOM_LEDGER_SCHEDULER_H
+#define FANTOM_LEDGER_SCHEDULER_H
+
+#include "common.h"
+
+// SCHEDULER_SLICE_STEPS defines how many steps of a work item run between two heartbeats.
+// A step is expected to cost about a single key derivation.
+#define SCHEDULER_SLICE_STEPS 2
+
+// work_step_fn_t declares a single step of a resumable work item.
+// The step processes the unit of work at the given index and returns false
+// if the work item is finished early, e.g. a searched value has been found.
+typedef bool work_step_fn_t(uint32_t index);
+
+// work_item_t declares a resumable work item. The item is kept in the instruction
+// context so the work can continue on the next APDU where the previous one stopped.
+typedef struct {
+    work_step_fn_t *step;
+    uint32_t next;
+    uint32_t count;
+    bool isStopped;
+} work_item_t;
+
+// schedulerInit implements setting up a work item of the given number of steps.
+void schedulerInit(work_item_t *item, work_step_fn_t *step, uint32_t count);
+
+// schedulerRun implements running the work item in bounded slices until
+// it's done, or the budget of steps is spent. The device heartbeat is kept
+// going between slices and the progress is reported to the user.
+// Returns the number of steps processed.
+uint32_t schedulerRun(work_item_t *item, uint32_t budget);
+
+// schedulerIsDone implements check if the work item has been finished.
+bool schedulerIsDone(const work_item_t *item);
+
+#endif //FANTOM_LEDGER_SCHEDULER_H
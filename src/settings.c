@@ -0,0 +1,27 @@
+/**
+ * Implements the persistent application settings.
+ *
+ * The settings are kept in NVRAM so they survive the application restart.
+ * The settings are changed by the user from the idle menu only.
+ */
+#include <os_io_seproxyhal.h>
+
+#include "common.h"
+#include "settings.h"
+
+// N_settings_real is the NVRAM storage of the settings; it must be accessed via N_settings.
+const app_settings_t N_settings_real;
+
+// N_settings implements PIC safe access to the NVRAM storage of the settings.
+#define N_settings (*(volatile app_settings_t *) PIC(&N_settings_real))
+
+// settingsIsExpertMode implements check if the user enabled the expert mode.
+bool settingsIsExpertMode() {
+    return N_settings.expertMode == SETTINGS_EXPERT_MODE_ON;
+}
+
+// settingsSetExpertMode implements storing the expert mode setting.
+void settingsSetExpertMode(bool isEnabled) {
+    uint8_t value = (isEnabled ? SETTINGS_EXPERT_MODE_ON : 0);
+    nvm_write((void *) &N_settings.expertMode, &value, SIZEOF(value));
+}
@@ -0,0 +1,22 @@
+#ifndef FANTOM_LEDGER_SETTINGS_H
+#define FANTOM_LEDGER_SETTINGS_H
+
+#include "common.h"
+
+// SETTINGS_EXPERT_MODE_ON defines the stored value of enabled expert mode.
+// Any other value, including the blank NVRAM, means the expert mode is off.
+#define SETTINGS_EXPERT_MODE_ON 0xE1
+
+// app_settings_t declares the NVRAM layout of the application settings.
+typedef struct {
+    uint8_t expertMode;
+} app_settings_t;
+
+// settingsIsExpertMode implements check if the user enabled the expert mode.
+// The expert mode replaces the step by step transaction review with a condensed flow.
+bool settingsIsExpertMode();
+
+// settingsSetExpertMode implements storing the expert mode setting.
+void settingsSetExpertMode(bool isEnabled);
+
+#endif //FANTOM_LEDGER_SETTINGS_H
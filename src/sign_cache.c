@@ -0,0 +1,101 @@
+/**
+ * Implements the signature cache used to answer host retries
+ * of a recently signed transaction without the full review.
+ *
+ * Only signatures the user has already approved are stored and the cache
+ * lives in RAM only, so it's gone on application exit. We also drop it
+ * when the device is locked and each record expires after a short time.
+ */
+#include "common.h"
+#include "sign_cache.h"
+#include "io.h"
+
+// signCache holds the ring of recently produced signatures.
+static sign_cache_t signCache;
+
+// signCacheIsExpired implements the test for expired cache record.
+static bool signCacheIsExpired(const sign_cache_entry_t *entry) {
+    // the tick counter is unsigned so the subtraction survives wrap around
+    return (uint32_t) (io_ticks - entry->createdAt) > SIGN_CACHE_TTL_TICKS;
+}
+
+// signCacheIsSamePath implements comparison of two BIP44 paths.
+static bool signCacheIsSamePath(const bip44_path_t *a, const bip44_path_t *b) {
+    // paths of different length can not be the same
+    if (a->length != b->length) {
+        return false;
+    }
+
+    // make sure we stay inside the path container
+    ASSERT(a->length <= ARRAY_LEN(a->path));
+
+    // compare only the used part of the path
+    return memcmp(a->path, b->path, a->length * SIZEOF(a->path[0])) == 0;
+}
+
+// signCacheStore implements storing a user approved signature into the cache ring.
+void signCacheStore(const bip44_path_t *path, const uint8_t *hash, size_t hashLength, const tx_signature_t *signature) {
+    // make sure the hash is what we expect
+    ASSERT(hashLength == TX_HASH_LENGTH);
+
+    // make sure the ring pointer is inside the ring
+    ASSERT(signCache.next < SIGN_CACHE_SIZE);
+
+    // pick the next slot in the ring, the oldest record is replaced
+    sign_cache_entry_t *entry = &signCache.entries[signCache.next];
+    signCache.next = (signCache.next + 1) % SIGN_CACHE_SIZE;
+
+    // copy the record details
+    memcpy(&entry->path, path, SIZEOF(entry->path));
+    memcpy(entry->hash, hash, TX_HASH_LENGTH);
+    memcpy(&entry->signature, signature, SIZEOF(entry->signature));
+
+    // mark the record time and validity
+    entry->createdAt = io_ticks;
+    entry->isValid = true;
+}
+
+// signCacheLookup implements search for a signature of a byte identical transaction.
+bool signCacheLookup(const bip44_path_t *path, const uint8_t *hash, size_t hashLength, tx_signature_t *signature) {
+    // make sure the hash is what we expect
+    ASSERT(hashLength == TX_HASH_LENGTH);
+
+    // loop the ring and try to find the record
+    for (size_t i = 0; i < SIGN_CACHE_SIZE; i++) {
+        sign_cache_entry_t *entry = &signCache.entries[i];
+
+        // skip empty and expired records
+        if (!entry->isValid || signCacheIsExpired(entry)) {
+            continue;
+        }
+
+        // both the path and the transaction hash must match
+        if (signCacheIsSamePath(&entry->path, path) && memcmp(entry->hash, hash, TX_HASH_LENGTH) == 0) {
+            memcpy(signature, &entry->signature, SIZEOF(*signature));
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// signCacheTick implements periodic cache maintenance called from the ticker event.
+void signCacheTick() {
+    // locked device drops all the cached signatures
+    if (!device_is_unlocked()) {
+        signCacheClear();
+        return;
+    }
+
+    // remove expired records so they don't linger in memory
+    for (size_t i = 0; i < SIGN_CACHE_SIZE; i++) {
+        if (signCache.entries[i].isValid && signCacheIsExpired(&signCache.entries[i])) {
+            explicit_bzero(&signCache.entries[i], SIZEOF(signCache.entries[i]));
+        }
+    }
+}
+
+// signCacheClear implements wiping the whole signature cache.
+void signCacheClear() {
+    explicit_bzero(&signCache, SIZEOF(signCache));
+}
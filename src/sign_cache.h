@@ -0,0 +1,50 @@
+#ifndef FANTOM_LEDGER_SIGN_CACHE_H
+#define FANTOM_LEDGER_SIGN_CACHE_H
+
+#include "common.h"
+#include "bip44.h"
+#include "transaction.h"
+
+// SIGN_CACHE_SIZE defines how many recently produced signatures we keep around.
+// We have only 4kB of RAM available so the ring is kept intentionally small;
+// the cache is meant to cover host retries of the last transaction only.
+#define SIGN_CACHE_SIZE 2
+
+// SIGN_CACHE_TTL_TICKS defines how long a cached signature stays valid.
+// The SEPROXYHAL ticker fires every 100ms so this is roughly one minute.
+#define SIGN_CACHE_TTL_TICKS 600
+
+// sign_cache_entry_t declares a single record of the signature cache.
+// We identify the signed transaction by the signing path and the Keccak
+// digest of the whole RLP stream received from the host.
+typedef struct {
+    bool isValid;
+    uint32_t createdAt;
+    bip44_path_t path;
+    uint8_t hash[TX_HASH_LENGTH];
+    tx_signature_t signature;
+} sign_cache_entry_t;
+
+// sign_cache_t declares the ring of recently produced transaction signatures.
+typedef struct {
+    sign_cache_entry_t entries[SIGN_CACHE_SIZE];
+    uint8_t next;
+} sign_cache_t;
+
+// signCacheStore implements storing a user approved signature into the cache ring.
+// The oldest record is overwritten if the ring is full.
+void signCacheStore(const bip44_path_t *path, const uint8_t *hash, size_t hashLength, const tx_signature_t *signature);
+
+// signCacheLookup implements search for a signature of a byte identical transaction
+// signed recently on the same path. The signature is copied to the output and true
+// is returned if a valid record has been found.
+bool signCacheLookup(const bip44_path_t *path, const uint8_t *hash, size_t hashLength, tx_signature_t *signature);
+
+// signCacheTick implements periodic cache maintenance called from the ticker event.
+// Expired records are removed and the whole ring is dropped if the device gets locked.
+void signCacheTick();
+
+// signCacheClear implements wiping the whole signature cache.
+void signCacheClear();
+
+#endif //FANTOM_LEDGER_SIGN_CACHE_H
@@ -0,0 +1,299 @@
+/**
+ * Implements Sign Personal Message APDU instruction handler.
+ *
+ * The message is signed the EIP-191 way (personal_sign), the signed hash is
+ * keccak256("\x19Ethereum Signed Message:\n" + len(message) + message).
+ * The message is streamed from the host in chunks and hashed on the fly so the memory
+ * use does not depend on the message size; we keep just the leading bytes to show them.
+ */
+#include <string.h>
+
+#include "common.h"
+#include "errors.h"
+#include "big_endian_io.h"
+#include "state.h"
+#include "ui_helpers.h"
+#include "policy.h"
+#include "key_slots.h"
+#include "sign_message.h"
+
+// ctx hold the direct reference to this instruction context.
+static ins_sign_msg_context_t *ctx = &(instructionState.insSignMsgContext);
+
+// RESPONSE_READY_TAG is used to tag the state context that the signature is ready.
+static int16_t RESPONSE_READY_TAG = 21877;
+
+// SIGN_MSG_PREFIX defines the EIP-191 prefix of signed personal messages.
+static const char SIGN_MSG_PREFIX[] = "\x19" "Ethereum Signed Message:\n";
+
+// what are possible steps of the message signature
+// @see /doc/cmd_sign_msg.md for details.
+enum {
+    P1_NEW_MESSAGE = 0x00,
+    P1_MESSAGE_DATA = 0x01,
+    P1_GET_SIGNATURE = 0x80,
+};
+
+// runSignMessageUIStep implements next step of UX for the Sign Personal Message instruction.
+static void runSignMessageUIStep();
+
+// what steps are being handled
+enum {
+    UI_STEP_WARNING = 100,
+    UI_STEP_MESSAGE,
+    UI_STEP_SENDER,
+    UI_STEP_CONFIRM,
+    UI_STEP_RESPOND,
+    UI_STEP_INVALID,
+};
+
+// signMessageRespondRemaining implements sending the number of message bytes still expected.
+static void signMessageRespondRemaining() {
+    uint8_t res[4];
+    u4be_write(res, ctx->messageLength - ctx->messageReceived);
+    io_send_buf(SUCCESS, res, SIZEOF(res));
+    ui_displayBusy();
+}
+
+// handleSignMessageInit implements the first step of the message signature.
+static void handleSignMessageInit(uint8_t p2, uint8_t *wireBuffer, size_t wireSize) {
+    // the message can not be restarted in the middle
+    VALIDATE(!ctx->isStarted, ERR_INVALID_STATE);
+
+    // validate the p2 value
+    VALIDATE(p2 == 0 || p2 == P2_KEY_SLOT, ERR_INVALID_PARAMETERS);
+
+    // the message length closes the request
+    VALIDATE(wireSize > 4, ERR_INVALID_DATA);
+    ctx->messageLength = u4be_read(wireBuffer + wireSize - 4);
+    wireSize -= 4;
+
+    security_policy_t policy;
+    if (p2 == P2_KEY_SLOT) {
+        // registered key slot has the path validated already
+        const key_slot_t *keySlot = keySlotFromWire(wireBuffer, wireSize);
+        memcpy(&ctx->path, &keySlot->path, SIZEOF(ctx->path));
+
+        // only address level path can sign the message
+        VALIDATE(keySlot->hasAddress, ERR_INVALID_DATA);
+        policy = POLICY_PROMPT;
+    } else {
+        // parse BIP44 path from the incoming request
+        size_t parsedSize = bip44_parseFromWire(&ctx->path, wireBuffer, wireSize);
+
+        // make sure size of the data we parsed corresponds with the data we received
+        VALIDATE(parsedSize == wireSize, ERR_INVALID_DATA);
+
+        // get the security policy for the message signature
+        policy = policyForSignMessage(&ctx->path);
+        ASSERT_NOT_DENIED(policy);
+    }
+    ctx->isWarning = (policy == POLICY_WARN);
+
+    // prime the hash with the prefix and the decimal message length
+    char lengthStr[11];
+    snprintf(lengthStr, SIZEOF(lengthStr), "%u", (unsigned) ctx->messageLength);
+
+    cx_keccak_init(&ctx->sha3Context, 256);
+    cx_hash((cx_hash_t * ) & ctx->sha3Context, 0,
+            (const uint8_t *) SIGN_MSG_PREFIX, strlen(SIGN_MSG_PREFIX), NULL, 0);
+    cx_hash((cx_hash_t * ) & ctx->sha3Context, 0,
+            (const uint8_t *) lengthStr, strlen(lengthStr), NULL, 0);
+
+    // the message is started, tell the host how much data we expect
+    ctx->isStarted = true;
+    signMessageRespondRemaining();
+}
+
+// handleSignMessageData implements receiving a chunk of the message.
+static void handleSignMessageData(uint8_t p2, uint8_t *wireBuffer, size_t wireSize) {
+    // the message must be started and some data must be missing
+    VALIDATE(ctx->isStarted && ctx->messageReceived < ctx->messageLength, ERR_INVALID_STATE);
+
+    // validate the p2 value
+    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+
+    // the data must fit the advertised length
+    VALIDATE(wireSize > 0, ERR_INVALID_DATA);
+    VALIDATE(wireSize <= ctx->messageLength - ctx->messageReceived, ERR_INVALID_DATA);
+
+    // keep the leading part of the message for the review
+    if (ctx->messageReceived < SIZEOF(ctx->preview)) {
+        size_t toCopy = SIZEOF(ctx->preview) - ctx->messageReceived;
+        if (wireSize < toCopy) {
+            toCopy = wireSize;
+        }
+        memcpy(ctx->preview + ctx->messageReceived, wireBuffer, toCopy);
+    }
+
+    // hash the chunk
+    cx_hash((cx_hash_t * ) & ctx->sha3Context, 0, wireBuffer, wireSize, NULL, 0);
+    ctx->messageReceived += wireSize;
+
+    signMessageRespondRemaining();
+}
+
+// handleSignMessageFinalize implements the final step of the message signature.
+static void handleSignMessageFinalize(uint8_t p2, size_t wireSize) {
+    // the whole message must have been received
+    VALIDATE(ctx->isStarted && ctx->messageReceived == ctx->messageLength, ERR_INVALID_STATE);
+    VALIDATE(ctx->uiStep == 0, ERR_INVALID_STATE);
+
+    // validate the p2 value
+    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+
+    // we don't expect to receive any data here
+    VALIDATE(wireSize == 0, ERR_INVALID_DATA);
+
+    // we don't expect any more data to be coming from the host
+    io_state = IO_EXPECT_UI;
+
+    // extract the message hash and sign it
+    cx_hash((cx_hash_t * ) & ctx->sha3Context, CX_LAST, ctx->hash, 0, ctx->hash, TX_HASH_LENGTH);
+    txGetSignature(&ctx->path, ctx->hash, TX_HASH_LENGTH, &ctx->sha3Context, &ctx->sender, &ctx->signature);
+    ctx->responseReady = RESPONSE_READY_TAG;
+
+    // prepare the signing address for the review
+    ENSURE(ctx->sender.length <= SIZEOF(ctx->sender.value));
+    addressFormatStr(ctx->sender.value, ctx->sender.length, &ctx->sha3Context,
+                     ctx->senderStr, SIZEOF(ctx->senderStr));
+
+    // run the review
+    ctx->uiStep = (ctx->isWarning ? UI_STEP_WARNING : UI_STEP_MESSAGE);
+    runSignMessageUIStep();
+}
+
+// isPrintablePreview implements check if the message preview can be shown as text.
+static bool isPrintablePreview(size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        if (ctx->preview[i] < 0x20 || ctx->preview[i] > 0x7e) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// runSignMessageUIStep implements next step of UX for the Sign Personal Message instruction.
+static void runSignMessageUIStep() {
+    // keep the callback to myself
+    ui_callback_fn_t *this_fn = runSignMessageUIStep;
+
+    // resume the stage based on previous result
+    switch (ctx->uiStep) {
+        case UI_STEP_WARNING: {
+            // display the warning
+            ui_displayPaginatedText(
+                    "Unusual Request",
+                    "Be careful!",
+                    this_fn
+            );
+
+            // set next step
+            ctx->uiStep = UI_STEP_MESSAGE;
+            break;
+        }
+
+        case UI_STEP_MESSAGE: {
+            // how much of the message we can show
+            size_t length = ctx->messageLength;
+            if (length > SIZEOF(ctx->preview)) {
+                length = SIZEOF(ctx->preview);
+            }
+
+            // the printable message is shown as text, anything else as the hash fingerprint
+            char messageStr[SIGN_MSG_PREVIEW_SIZE + 4];
+            if (isPrintablePreview(length)) {
+                memcpy(messageStr, ctx->preview, length);
+                messageStr[length] = 0;
+
+                // mark the message is longer than what we show
+                if (length < ctx->messageLength) {
+                    strcpy(messageStr + length, "...");
+                }
+
+                ui_displayPaginatedText("Message", messageStr, this_fn);
+            } else {
+                txGetFormattedFingerprint(ctx->hash, SIZEOF(ctx->hash), messageStr, SIZEOF(messageStr));
+                ui_displayPaginatedText("Message Hash", messageStr, this_fn);
+            }
+
+            // set next step
+            ctx->uiStep = UI_STEP_SENDER;
+            break;
+        }
+
+        case UI_STEP_SENDER: {
+            // display the signing address
+            ui_displayPaginatedText(
+                    "Sign With",
+                    ctx->senderStr,
+                    this_fn
+            );
+
+            // set next step
+            ctx->uiStep = UI_STEP_CONFIRM;
+            break;
+        }
+
+        case UI_STEP_CONFIRM: {
+            // ask user to confirm the message signature
+            ui_displayPrompt(
+                    "Sign",
+                    "Message?",
+                    this_fn,
+                    ui_respondWithUserReject
+            );
+
+            // set next step
+            ctx->uiStep = UI_STEP_RESPOND;
+            break;
+        }
+
+        case UI_STEP_RESPOND: {
+            // sanity check; make sure the signature is ready
+            VALIDATE(ctx->responseReady == RESPONSE_READY_TAG, ERR_INVALID_DATA);
+
+            // set invalid step so we never cycle around
+            ctx->uiStep = UI_STEP_INVALID;
+
+            // send the signature and switch user to idle; we are done here
+            io_send_buf(SUCCESS, (uint8_t * ) & ctx->signature, SIZEOF(ctx->signature));
+            ui_idle();
+            break;
+        }
+
+        default: {
+            // we don't tolerate invalid state
+            ASSERT(false);
+        }
+    }
+}
+
+// handleSignMessage implements APDU instruction handler for Sign Personal Message instruction.
+void handleSignMessage(
+        uint8_t p1,
+        uint8_t p2,
+        uint8_t *wireBuffer,
+        size_t wireSize,
+        bool isOnInit
+) {
+    // make sure the state is clean
+    if (isOnInit) {
+        memset(ctx, 0, SIZEOF(*ctx));
+    }
+
+    // decide based on the p1 value
+    switch (p1) {
+        case P1_NEW_MESSAGE:
+            handleSignMessageInit(p2, wireBuffer, wireSize);
+            break;
+        case P1_MESSAGE_DATA:
+            handleSignMessageData(p2, wireBuffer, wireSize);
+            break;
+        case P1_GET_SIGNATURE:
+            handleSignMessageFinalize(p2, wireSize);
+            break;
+        default:
+            VALIDATE(false, ERR_INVALID_PARAMETERS);
+    }
+}
@@ -0,0 +1,35 @@
+#ifndef FANTOM_LEDGER_SIGN_MESSAGE_H
+#define FANTOM_LEDGER_SIGN_MESSAGE_H
+
+#include "common.h"
+#include "handlers.h"
+#include "transaction.h"
+#include "bip44.h"
+#include "address_utils.h"
+
+// SIGN_MSG_PREVIEW_SIZE defines how many leading bytes of the message we keep
+// to show them to the user; the rest of the message is only hashed.
+#define SIGN_MSG_PREVIEW_SIZE 64
+
+// handleSignMessage implements Sign Personal Message APDU instruction handler.
+handler_fn_t handleSignMessage;
+
+// ins_sign_msg_context_t declares context
+// for personal message signature APDU instruction.
+typedef struct {
+    int16_t responseReady;
+    bool isStarted;
+    bool isWarning;
+    bip44_path_t path;
+    uint32_t messageLength;
+    uint32_t messageReceived;
+    uint8_t preview[SIGN_MSG_PREVIEW_SIZE];
+    uint8_t hash[TX_HASH_LENGTH];
+    tx_address_t sender;
+    tx_signature_t signature;
+    cx_sha3_t sha3Context;
+    int uiStep;
+    char senderStr[MIN_ADDRESS_STR_BUFFER_SIZE];
+} ins_sign_msg_context_t;
+
+#endif //FANTOM_LEDGER_SIGN_MESSAGE_H
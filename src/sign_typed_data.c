@@ -0,0 +1,336 @@
+/**
+ * Implements Sign Typed Data APDU instruction handler.
+ *
+ * The instruction signs EIP-712 structured data, the signed hash is
+ * keccak256("\x19\x01" ‖ domainSeparator ‖ hashStruct(message)).
+ * The host sends the domain separator and the struct hash calculated from the message.
+ * The ERC-2612 permit is known to us; the host sends the permit fields instead
+ * of the struct hash and we calculate the hash ourselves, so the fields we show
+ * to the user are the fields being signed.
+ */
+#include <string.h>
+
+#include "common.h"
+#include "errors.h"
+#include "state.h"
+#include "ui_helpers.h"
+#include "policy.h"
+#include "key_slots.h"
+#include "uint256.h"
+#include "sign_typed_data.h"
+
+// ctx hold the direct reference to this instruction context.
+static ins_sign_typed_data_context_t *ctx = &(instructionState.insSignTypedDataContext);
+
+// RESPONSE_READY_TAG is used to tag the state context that the signature is ready.
+static int16_t RESPONSE_READY_TAG = 17291;
+
+// TYPED_DATA_PREFIX defines the EIP-191 version byte prefix of the EIP-712 structured data.
+static const uint8_t TYPED_DATA_PREFIX[] = {0x19, 0x01};
+
+// PERMIT_TYPE_HASH defines keccak256 of the ERC-2612 permit type
+// "Permit(address owner,address spender,uint256 value,uint256 nonce,uint256 deadline)".
+static const uint8_t PERMIT_TYPE_HASH[TYPED_DATA_HASH_SIZE] = {
+        0x6e, 0x71, 0xed, 0xae, 0x12, 0xb1, 0xb9, 0x7f, 0x4d, 0x1f, 0x60, 0x37, 0x0f, 0xef, 0x10, 0x10,
+        0x5f, 0xa2, 0xfa, 0xae, 0x01, 0x26, 0x11, 0x4a, 0x16, 0x9c, 0x64, 0x84, 0x5d, 0x61, 0x26, 0xc9,
+};
+
+// what are possible types of the structured data
+// @see /doc/cmd_sign_typed_data.md for details.
+enum {
+    P1_STRUCT_HASH = 0x00,
+    P1_PERMIT = 0x01,
+};
+
+// runSignTypedDataUIStep implements next step of UX for the Sign Typed Data instruction.
+static void runSignTypedDataUIStep();
+
+// what steps are being handled
+enum {
+    UI_STEP_WARNING = 100,
+    UI_STEP_PERMIT_SPENDER,
+    UI_STEP_PERMIT_VALUE,
+    UI_STEP_PERMIT_DEADLINE,
+    UI_STEP_DOMAIN,
+    UI_STEP_MESSAGE,
+    UI_STEP_SENDER,
+    UI_STEP_CONFIRM,
+    UI_STEP_RESPOND,
+    UI_STEP_INVALID,
+};
+
+// typedDataHashAddress implements adding an ABI encoded address into the SHA3 context.
+static void typedDataHashAddress(const uint8_t *address) {
+    // the address is left padded with zeros to 32 bytes
+    uint8_t padding[TYPED_DATA_UINT_SIZE - TX_MAX_ADDRESS_LENGTH];
+    memset(padding, 0, SIZEOF(padding));
+
+    cx_hash((cx_hash_t * ) & ctx->sha3Context, 0, padding, SIZEOF(padding), NULL, 0);
+    cx_hash((cx_hash_t * ) & ctx->sha3Context, 0, address, TX_MAX_ADDRESS_LENGTH, NULL, 0);
+}
+
+// typedDataHashPermit implements calculation of the ERC-2612 permit struct hash.
+static void typedDataHashPermit() {
+    cx_keccak_init(&ctx->sha3Context, 256);
+    cx_hash((cx_hash_t * ) & ctx->sha3Context, 0, PERMIT_TYPE_HASH, SIZEOF(PERMIT_TYPE_HASH), NULL, 0);
+    typedDataHashAddress(ctx->permit.owner);
+    typedDataHashAddress(ctx->permit.spender);
+    cx_hash((cx_hash_t * ) & ctx->sha3Context, 0, ctx->permit.value, SIZEOF(ctx->permit.value), NULL, 0);
+    cx_hash((cx_hash_t * ) & ctx->sha3Context, 0, ctx->permit.nonce, SIZEOF(ctx->permit.nonce), NULL, 0);
+    cx_hash((cx_hash_t * ) & ctx->sha3Context, CX_LAST,
+            ctx->permit.deadline, SIZEOF(ctx->permit.deadline),
+            ctx->structHash, SIZEOF(ctx->structHash));
+}
+
+// typedDataParsePath implements parsing of the signing path, or the key slot, from the request.
+// The returned policy decides if the user is warned about the path.
+static security_policy_t typedDataParsePath(uint8_t p2, const uint8_t *wireBuffer, size_t wireSize) {
+    if (p2 == P2_KEY_SLOT) {
+        // registered key slot has the path validated already
+        const key_slot_t *keySlot = keySlotFromWire(wireBuffer, wireSize);
+        memcpy(&ctx->path, &keySlot->path, SIZEOF(ctx->path));
+
+        // only address level path can sign the data
+        VALIDATE(keySlot->hasAddress, ERR_INVALID_DATA);
+        return POLICY_PROMPT;
+    }
+
+    // parse BIP44 path from the incoming request
+    size_t parsedSize = bip44_parseFromWire(&ctx->path, wireBuffer, wireSize);
+
+    // make sure size of the data we parsed corresponds with the data we received
+    VALIDATE(parsedSize == wireSize, ERR_INVALID_DATA);
+
+    // the same rules apply as for the personal messages
+    security_policy_t policy = policyForSignMessage(&ctx->path);
+    ASSERT_NOT_DENIED(policy);
+    return policy;
+}
+
+// handleSignTypedDataRequest implements parsing of the request and signing the structured data.
+static void handleSignTypedDataRequest(uint8_t p1, uint8_t p2, uint8_t *wireBuffer, size_t wireSize) {
+    // validate the p2 value
+    VALIDATE(p2 == 0 || p2 == P2_KEY_SLOT, ERR_INVALID_PARAMETERS);
+
+    // the fixed size data close the request, the path goes first
+    size_t dataSize = TYPED_DATA_HASH_SIZE +
+                      (p1 == P1_PERMIT ? SIZEOF(ctx->permit) : SIZEOF(ctx->structHash));
+    VALIDATE(wireSize > dataSize, ERR_INVALID_DATA);
+
+    size_t pathSize = wireSize - dataSize;
+    security_policy_t policy = typedDataParsePath(p2, wireBuffer, pathSize);
+    ctx->isWarning = (policy == POLICY_WARN);
+
+    // read the domain separator
+    const uint8_t *data = wireBuffer + pathSize;
+    memcpy(ctx->domainSeparator, data, SIZEOF(ctx->domainSeparator));
+    data += SIZEOF(ctx->domainSeparator);
+
+    // read the struct hash, or calculate it from the known structure
+    ctx->isPermit = (p1 == P1_PERMIT);
+    if (ctx->isPermit) {
+        memcpy(&ctx->permit, data, SIZEOF(ctx->permit));
+        typedDataHashPermit();
+    } else {
+        memcpy(ctx->structHash, data, SIZEOF(ctx->structHash));
+    }
+
+    // we don't expect any more data to be coming from the host
+    io_state = IO_EXPECT_UI;
+
+    // calculate the signed hash
+    cx_keccak_init(&ctx->sha3Context, 256);
+    cx_hash((cx_hash_t * ) & ctx->sha3Context, 0, TYPED_DATA_PREFIX, SIZEOF(TYPED_DATA_PREFIX), NULL, 0);
+    cx_hash((cx_hash_t * ) & ctx->sha3Context, 0, ctx->domainSeparator, SIZEOF(ctx->domainSeparator), NULL, 0);
+    cx_hash((cx_hash_t * ) & ctx->sha3Context, CX_LAST,
+            ctx->structHash, SIZEOF(ctx->structHash),
+            ctx->hash, SIZEOF(ctx->hash));
+
+    // sign the hash
+    txGetSignature(&ctx->path, ctx->hash, TX_HASH_LENGTH, &ctx->sha3Context, &ctx->sender, &ctx->signature);
+    ctx->responseReady = RESPONSE_READY_TAG;
+
+    // prepare the signing address for the review
+    ENSURE(ctx->sender.length <= SIZEOF(ctx->sender.value));
+    addressFormatStr(ctx->sender.value, ctx->sender.length, &ctx->sha3Context,
+                     ctx->senderStr, SIZEOF(ctx->senderStr));
+
+    // the permit must be signed by its owner, otherwise it's useless
+    if (ctx->isPermit) {
+        VALIDATE(ctx->sender.length == TX_MAX_ADDRESS_LENGTH &&
+                 memcmp(ctx->sender.value, ctx->permit.owner, TX_MAX_ADDRESS_LENGTH) == 0, ERR_INVALID_DATA);
+
+        addressFormatStr(ctx->permit.spender, SIZEOF(ctx->permit.spender), &ctx->sha3Context,
+                         ctx->spenderStr, SIZEOF(ctx->spenderStr));
+    }
+
+    // run the review
+    if (ctx->isWarning) {
+        ctx->uiStep = UI_STEP_WARNING;
+    } else {
+        ctx->uiStep = (ctx->isPermit ? UI_STEP_PERMIT_SPENDER : UI_STEP_DOMAIN);
+    }
+    runSignTypedDataUIStep();
+}
+
+// displayUint256 implements displaying a decimal uint256 value.
+static void displayUint256(const char *headerStr, const uint8_t *value, ui_callback_fn_t *callback) {
+    // 78 digits is the longest 256 bits decimal number
+    char valueStr[80];
+    uint256_t number;
+    uint256ConvertBE(&number, value, TYPED_DATA_UINT_SIZE);
+    VALIDATE(uint256ToString(&number, 10, valueStr, SIZEOF(valueStr)) > 0, ERR_INVALID_DATA);
+
+    ui_displayPaginatedText(headerStr, valueStr, callback);
+}
+
+// displayFingerprint implements displaying a short fingerprint of a hash.
+static void displayFingerprint(const char *headerStr, const uint8_t *hash, ui_callback_fn_t *callback) {
+    char hashStr[4 * TX_DATA_FINGERPRINT_SIZE + 3 + 1];
+    txGetFormattedFingerprint(hash, TYPED_DATA_HASH_SIZE, hashStr, SIZEOF(hashStr));
+
+    ui_displayPaginatedText(headerStr, hashStr, callback);
+}
+
+// runSignTypedDataUIStep implements next step of UX for the Sign Typed Data instruction.
+static void runSignTypedDataUIStep() {
+    // keep the callback to myself
+    ui_callback_fn_t *this_fn = runSignTypedDataUIStep;
+
+    // resume the stage based on previous result
+    switch (ctx->uiStep) {
+        case UI_STEP_WARNING: {
+            // display the warning
+            ui_displayPaginatedText(
+                    "Unusual Request",
+                    "Be careful!",
+                    this_fn
+            );
+
+            // set next step
+            ctx->uiStep = (ctx->isPermit ? UI_STEP_PERMIT_SPENDER : UI_STEP_DOMAIN);
+            break;
+        }
+
+        case UI_STEP_PERMIT_SPENDER: {
+            // display the address allowed to spend the tokens
+            ui_displayPaginatedText(
+                    "Permit Spender",
+                    ctx->spenderStr,
+                    this_fn
+            );
+
+            // set next step
+            ctx->uiStep = UI_STEP_PERMIT_VALUE;
+            break;
+        }
+
+        case UI_STEP_PERMIT_VALUE: {
+            // token decimals are not known to us, we show the base units
+            displayUint256("Permit Value", ctx->permit.value, this_fn);
+
+            // set next step
+            ctx->uiStep = UI_STEP_PERMIT_DEADLINE;
+            break;
+        }
+
+        case UI_STEP_PERMIT_DEADLINE: {
+            // the deadline is the unix timestamp
+            displayUint256("Permit Deadline", ctx->permit.deadline, this_fn);
+
+            // set next step
+            ctx->uiStep = UI_STEP_DOMAIN;
+            break;
+        }
+
+        case UI_STEP_DOMAIN: {
+            // the domain identifies the contract the data are signed for
+            displayFingerprint("Domain Hash", ctx->domainSeparator, this_fn);
+
+            // set next step; the permit message has been shown already
+            ctx->uiStep = (ctx->isPermit ? UI_STEP_SENDER : UI_STEP_MESSAGE);
+            break;
+        }
+
+        case UI_STEP_MESSAGE: {
+            // the message content is not known to us, we show the struct hash
+            displayFingerprint("Message Hash", ctx->structHash, this_fn);
+
+            // set next step
+            ctx->uiStep = UI_STEP_SENDER;
+            break;
+        }
+
+        case UI_STEP_SENDER: {
+            // display the signing address
+            ui_displayPaginatedText(
+                    "Sign With",
+                    ctx->senderStr,
+                    this_fn
+            );
+
+            // set next step
+            ctx->uiStep = UI_STEP_CONFIRM;
+            break;
+        }
+
+        case UI_STEP_CONFIRM: {
+            // ask user to confirm the data signature
+            ui_displayPrompt(
+                    "Sign",
+                    "Typed Data?",
+                    this_fn,
+                    ui_respondWithUserReject
+            );
+
+            // set next step
+            ctx->uiStep = UI_STEP_RESPOND;
+            break;
+        }
+
+        case UI_STEP_RESPOND: {
+            // sanity check; make sure the signature is ready
+            VALIDATE(ctx->responseReady == RESPONSE_READY_TAG, ERR_INVALID_DATA);
+
+            // set invalid step so we never cycle around
+            ctx->uiStep = UI_STEP_INVALID;
+
+            // send the signature and switch user to idle; we are done here
+            io_send_buf(SUCCESS, (uint8_t * ) & ctx->signature, SIZEOF(ctx->signature));
+            ui_idle();
+            break;
+        }
+
+        default: {
+            // we don't tolerate invalid state
+            ASSERT(false);
+        }
+    }
+}
+
+// handleSignTypedData implements APDU instruction handler for Sign Typed Data instruction.
+void handleSignTypedData(
+        uint8_t p1,
+        uint8_t p2,
+        uint8_t *wireBuffer,
+        size_t wireSize,
+        bool isOnInit
+) {
+    // make sure the state is clean
+    if (isOnInit) {
+        memset(ctx, 0, SIZEOF(*ctx));
+    }
+
+    // extra reset the response mark
+    ctx->responseReady = 0;
+
+    // decide based on the p1 value
+    switch (p1) {
+        case P1_STRUCT_HASH:
+        case P1_PERMIT:
+            handleSignTypedDataRequest(p1, p2, wireBuffer, wireSize);
+            break;
+        default:
+            VALIDATE(false, ERR_INVALID_PARAMETERS);
+    }
+}
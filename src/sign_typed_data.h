@@ -0,0 +1,47 @@
+#ifndef FANTOM_LEDGER_SIGN_TYPED_DATA_H
+#define FANTOM_LEDGER_SIGN_TYPED_DATA_H
+
+#include "common.h"
+#include "handlers.h"
+#include "transaction.h"
+#include "bip44.h"
+#include "address_utils.h"
+
+// TYPED_DATA_HASH_SIZE defines the size of EIP-712 domain separator and struct hash.
+#define TYPED_DATA_HASH_SIZE 32
+
+// TYPED_DATA_UINT_SIZE defines the size of ABI encoded uint256 value.
+#define TYPED_DATA_UINT_SIZE 32
+
+// handleSignTypedData implements Sign Typed Data APDU instruction handler.
+handler_fn_t handleSignTypedData;
+
+// typed_data_permit_t declares the ERC-2612 permit message fields.
+typedef struct {
+    uint8_t owner[TX_MAX_ADDRESS_LENGTH];
+    uint8_t spender[TX_MAX_ADDRESS_LENGTH];
+    uint8_t value[TYPED_DATA_UINT_SIZE];
+    uint8_t nonce[TYPED_DATA_UINT_SIZE];
+    uint8_t deadline[TYPED_DATA_UINT_SIZE];
+} typed_data_permit_t;
+
+// ins_sign_typed_data_context_t declares context
+// for EIP-712 typed data signature APDU instruction.
+typedef struct {
+    int16_t responseReady;
+    bool isWarning;
+    bool isPermit;
+    bip44_path_t path;
+    uint8_t domainSeparator[TYPED_DATA_HASH_SIZE];
+    uint8_t structHash[TYPED_DATA_HASH_SIZE];
+    typed_data_permit_t permit;
+    uint8_t hash[TX_HASH_LENGTH];
+    tx_address_t sender;
+    tx_signature_t signature;
+    cx_sha3_t sha3Context;
+    int uiStep;
+    char senderStr[MIN_ADDRESS_STR_BUFFER_SIZE];
+    char spenderStr[MIN_ADDRESS_STR_BUFFER_SIZE];
+} ins_sign_typed_data_context_t;
+
+#endif //FANTOM_LEDGER_SIGN_TYPED_DATA_H
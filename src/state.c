@@ -8,4 +8,24 @@ int currentIns;
 // and state.
 // We use joined structure since only one instruction can run
 // at any time.
-instruction_state_t instructionState;
\ No newline at end of file
+instruction_state_t instructionState;
+
+// isSideInstruction holds the flag of a side instruction being processed.
+// The current instruction stays untouched while the side instruction is served.
+bool isSideInstruction;
+
+// sideInstructionState holds the side instruction context and state.
+// We keep it apart from the joined structure so the side instruction
+// does not overwrite the current instruction state.
+side_instruction_state_t sideInstructionState;
+
+// wipeInstructionState implements wiping of the instruction states after a recoverable fault.
+void wipeInstructionState(void) {
+    explicit_bzero(&instructionState, SIZEOF(instructionState));
+    wipeSideInstructionState();
+}
+
+// wipeSideInstructionState implements wiping of the side instruction state after a recoverable fault.
+void wipeSideInstructionState(void) {
+    explicit_bzero(&sideInstructionState, SIZEOF(sideInstructionState));
+}
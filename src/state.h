@@ -3,14 +3,26 @@
 
 #include "get_pub_key.h"
 #include "get_address.h"
+#include "get_accounts.h"
+#include "verify_addresses.h"
+#include "key_slots.h"
 #include "get_tx_sign.h"
+#include "sign_message.h"
+#include "sign_typed_data.h"
 
 // Declares what instructions are recognized and processed by the application.
 #define INS_NONE -1
 #define INS_VERSION 0x01
+#define INS_CAPABILITIES 0x02
 #define INS_GET_KEY 0x10
 #define INS_GET_ADDR 0x11
+#define INS_GET_ACCOUNTS 0x12
+#define INS_VERIFY_ADDRESSES 0x13
+#define INS_KEY_SLOTS 0x14
 #define INS_SIGN_TX 0x20
+#define INS_TX_TEMPLATE 0x21
+#define INS_SIGN_MSG 0x22
+#define INS_SIGN_TYPED_DATA 0x23
 
 // instruction_state_t defines unified APDU instruction state.
 // We use joined instruction state storage since only one instruction
@@ -18,9 +30,21 @@
 typedef union {
     ins_get_ext_pubkey_context_t insGetPubKeyContext;
     ins_get_address_context_t insGetAddressContext;
+    ins_get_accounts_context_t insGetAccountsContext;
+    ins_verify_addresses_context_t insVerifyAddressesContext;
+    ins_key_slots_context_t insKeySlotsContext;
     ins_sign_tx_context_t insSignTxContext;
+    ins_sign_msg_context_t insSignMsgContext;
+    ins_sign_typed_data_context_t insSignTypedDataContext;
 } instruction_state_t;
 
+// side_instruction_state_t defines state of non-interactive instructions
+// allowed to run in between steps of a multi-step instruction.
+// It's kept apart from the joined state so the interrupted instruction is not disturbed.
+typedef struct {
+    ins_get_address_context_t insGetAddressContext;
+} side_instruction_state_t;
+
 // currentIns declares a current instruction registry.
 // Instructions received from APDU are uint8_t, but we have a special INS_NONE value
 // to identify idle/waiting state.
@@ -32,4 +56,20 @@ extern int currentIns;
 // For that reason we use joined structure for all the states in one place.
 extern instruction_state_t instructionState;
 
+// isSideInstruction declares flag of a side instruction being processed.
+// Side instruction runs in between steps of the current instruction and must not
+// change the current instruction, nor the UI.
+extern bool isSideInstruction;
+
+// sideInstructionState declares the side instruction state registry.
+extern side_instruction_state_t sideInstructionState;
+
+// wipeInstructionState implements wiping of the instruction states after a recoverable fault.
+// Any key material derived for the terminated instruction is wiped with the state.
+void wipeInstructionState(void);
+
+// wipeSideInstructionState implements wiping of the side instruction state after a recoverable fault.
+// The interrupted instruction state is left untouched.
+void wipeSideInstructionState(void);
+
 #endif
\ No newline at end of file
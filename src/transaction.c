@@ -19,6 +19,9 @@
 #include "bip44.h"
 #include "uint256.h"
 
+// HEXDIGITS declares a list of hexadecimal digits.
+static const char HEXDIGITS[] = "0123456789abcdef";
+
 // txGetV implements transaction "v" value calculator.
 // The "v" value is used to identify chain on which the transaction should exist.
 uint32_t txGetV(transaction_t *tx) {
@@ -276,7 +279,7 @@ static size_t adjustDecimals(
 // txGetFormattedAmount creates human readable string representation of given int256 amount/value converted to FTM.
 void txGetFormattedAmount(tx_int256_t *value, uint8_t decimals, char *out, size_t outSize) {
     // make sanity check, the buffer may never exceed this size
-    ASSERT(outSize < MAX_BUFFER_SIZE);
+    ENSURE(outSize < MAX_BUFFER_SIZE);
 
     // convert to 256 bit value
     uint256_t tmpValue;
@@ -296,7 +299,7 @@ void txGetFormattedAmount(tx_int256_t *value, uint8_t decimals, char *out, size_
 // txGetFormattedFee calculates the transaction fee and formats it to human readable FTM value.
 void txGetFormattedFee(transaction_t *tx, uint8_t decimals, char *out, size_t outSize) {
     // make sanity check, the buffer may never exceed this size
-    ASSERT(outSize < MAX_BUFFER_SIZE);
+    ENSURE(outSize < MAX_BUFFER_SIZE);
 
     // prep conversion containers
     uint256_t gasPrice;
@@ -318,3 +321,33 @@ void txGetFormattedFee(transaction_t *tx, uint8_t decimals, char *out, size_t ou
     // adjust decimals and copy to output
     adjustDecimals(tmp, length, decimals, out, outSize);
 }
+
+// txGetFormattedFingerprint creates short hex fingerprint of the given data digest.
+void txGetFormattedFingerprint(const uint8_t *digest, size_t digestLength, char *out, size_t outSize) {
+    // make sure the digest is long enough to be shortened
+    ENSURE(digestLength >= 2 * TX_DATA_FINGERPRINT_SIZE);
+
+    // we need 2 letters per byte on both sides, the separator and the terminator
+    ENSURE(outSize >= 4 * TX_DATA_FINGERPRINT_SIZE + 3 + 1);
+
+    size_t offset = 0;
+    for (size_t i = 0; i < 2 * TX_DATA_FINGERPRINT_SIZE; i++) {
+        // pick the leading bytes first, than the trailing ones
+        uint8_t digit = (i < TX_DATA_FINGERPRINT_SIZE)
+                        ? digest[i]
+                        : digest[digestLength - 2 * TX_DATA_FINGERPRINT_SIZE + i];
+
+        // separate the two parts so it's obvious the middle is missing
+        if (i == TX_DATA_FINGERPRINT_SIZE) {
+            out[offset++] = '.';
+            out[offset++] = '.';
+            out[offset++] = '.';
+        }
+
+        out[offset++] = HEXDIGITS[(digit >> 4) & 0x0f];
+        out[offset++] = HEXDIGITS[digit & 0x0f];
+    }
+
+    // terminate the string
+    out[offset] = 0;
+}
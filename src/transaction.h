@@ -9,6 +9,10 @@
 #define TX_MAX_ADDRESS_LENGTH 20
 #define TX_MAX_V_LENGTH 4
 
+// TX_DATA_FINGERPRINT_SIZE defines how many bytes from each end of the data digest
+// we show to the user as the data fingerprint.
+#define TX_DATA_FINGERPRINT_SIZE 4
+
 // tx_int256_t declares transaction value/unit type.
 typedef struct {
     uint8_t value[TX_MAX_INT256_LENGTH];
@@ -42,6 +46,7 @@ typedef struct {
     tx_address_t recipient;
     tx_address_t sender;
     tx_v_t v;
+    uint32_t dataLength;
     bool isContractCall;
 } transaction_t;
 
@@ -65,4 +70,9 @@ void txGetFormattedAmount(tx_int256_t *value, uint8_t decimals, char *out, size_
 // txGetFormattedFee calculates the transaction fee and formats it to human readable FTM value.
 void txGetFormattedFee(transaction_t *tx, uint8_t decimals, char *out, size_t outSize);
 
+// txGetFormattedFingerprint creates short hex fingerprint of the given data digest.
+// Only a few bytes from the beginning and the end of the digest are shown, the host
+// can provide the full digest for comparison with the expected build artifact.
+void txGetFormattedFingerprint(const uint8_t *digest, size_t digestLength, char *out, size_t outSize);
+
 #endif //FANTOM_LEDGER_TRANSACTION_H
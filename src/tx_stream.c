@@ -43,6 +43,29 @@ void txStreamInit(
     stream->isFieldSingleByte = false;
 }
 
+// txStreamEnableDataDigest implements enabling the separate digest of the data field payload.
+void txStreamEnableDataDigest(tx_stream_context_t *stream, cx_sha3_t *dataSha3Context) {
+    // the digest must be enabled before the data field is reached
+    ASSERT(stream->currentField < TX_RLP_DATA);
+
+    // assign SHA3 and init the SHA3 context
+    stream->dataSha3Context = dataSha3Context;
+    cx_keccak_init(stream->dataSha3Context, 256);
+}
+
+// txStreamEnableDataCapture implements enabling the capture of the data field payload.
+void txStreamEnableDataCapture(tx_stream_context_t *stream, uint8_t *buffer, uint32_t bufferSize) {
+    // the capture must be enabled before the data field is reached
+    ASSERT(stream->currentField < TX_RLP_DATA);
+
+    // make a sanity check for the max expected capture length
+    ASSERT(bufferSize < MAX_BUFFER_SIZE);
+
+    // keep the buffer reference
+    stream->dataCapture = buffer;
+    stream->dataCaptureSize = bufferSize;
+}
+
 // txStreamReadByte implements reading singe byte of data from the stream work buffer.
 // We use it to detect length field in the incoming data which precedes all the data
 // fields except self-encoded single byte data elements.
@@ -51,6 +74,7 @@ static uint8_t txStreamReadByte(tx_stream_context_t *stream) {
 
     // make sure we are safely withing a current command length
     VALIDATE(stream->workBufferLength >= 1, ERR_INVALID_DATA);
+    FUZZ_WORK(1);
 
     // read the data from work buffer and advance pointers
     data = *stream->workBuffer;
@@ -75,12 +99,13 @@ static uint8_t txStreamReadByte(tx_stream_context_t *stream) {
 static void txStreamCopyData(tx_stream_context_t *stream, uint8_t *out, size_t length) {
     // validate we are safely inside the current command length
     VALIDATE(stream->workBufferLength >= length, ERR_INVALID_DATA);
+    FUZZ_WORK(1);
 
     // make sure the output buffer is valid before we move the data
     if (out != NULL) {
         // make a sanity check for the max expected transfer length
         // we surely never store more than this amount of data
-        ASSERT(length < MAX_BUFFER_SIZE);
+        ENSURE(length < MAX_BUFFER_SIZE);
 
         // transfer the data
         memcpy(out, stream->workBuffer, length);
@@ -94,6 +119,22 @@ static void txStreamCopyData(tx_stream_context_t *stream, uint8_t *out, size_t l
         cx_hash((cx_hash_t *) stream->sha3Context, 0, stream->workBuffer, length, NULL, 0);
     }
 
+    // the data field payload goes to the data digest as well, if enabled;
+    // single byte data are included here since they pass through the copy too
+    if (stream->dataSha3Context != NULL && stream->isProcessingField && stream->currentField == TX_RLP_DATA) {
+        cx_hash((cx_hash_t *) stream->dataSha3Context, 0, stream->workBuffer, length, NULL, 0);
+    }
+
+    // keep the leading bytes of the data field payload, if enabled
+    if (stream->dataCapture != NULL && stream->isProcessingField && stream->currentField == TX_RLP_DATA &&
+        stream->currentFieldPos < stream->dataCaptureSize) {
+        size_t toCapture = stream->dataCaptureSize - stream->currentFieldPos;
+        if (length < toCapture) {
+            toCapture = length;
+        }
+        memcpy(stream->dataCapture + stream->currentFieldPos, stream->workBuffer, toCapture);
+    }
+
     // advance the work buffer and clear the command length we already processed
     stream->workBuffer += length;
     stream->workBufferLength -= length;
@@ -330,6 +371,9 @@ static tx_stream_status_e txStreamParseFieldProxy(tx_stream_context_t *stream) {
             // if we are on the beginning of the field, try to detect
             // smart contract call by calculating the data length rounding
             if (stream->currentFieldPos == 0) {
+                // keep the data length for the review
+                stream->tx->dataLength = stream->currentFieldLength;
+
                 // The data must contain at least signature and one parameter to qualify.
                 // We do not consider no-param calls to lower the chance for false positives.
                 // A contract call contains 4 bytes of method signature
@@ -343,7 +387,7 @@ static tx_stream_status_e txStreamParseFieldProxy(tx_stream_context_t *stream) {
             break;
         case TX_RLP_V:
             // this could/should contain chain identification
-            txStreamProcessVField(stream, &stream->tx->v, TX_MAX_INT256_LENGTH);
+            txStreamProcessVField(stream, &stream->tx->v, TX_MAX_V_LENGTH);
             break;
         case TX_RLP_R:
             txStreamProcessGeneralField(stream);
@@ -508,4 +552,73 @@ tx_stream_status_e txStreamProcess(
     END_TRY;
 
     return result;
-}
\ No newline at end of file
+}
+
+// txStreamProcessZeroRun implements processing of a zero-run compressed buffer of data
+// into the transaction stream.
+tx_stream_status_e txStreamProcessZeroRun(
+        tx_stream_context_t *stream,
+        const uint8_t *buffer,
+        uint32_t length,
+        uint32_t flags
+) {
+    // the expanded data go to the parser in small pieces
+    uint8_t expanded[TX_ZERO_RUN_BUFFER_SIZE];
+    uint32_t expandedLength = 0;
+    tx_stream_status_e result = TX_STREAM_PROCESSING;
+
+    // the value being expanded and how many times it still needs to be repeated
+    uint8_t runValue = 0;
+    uint32_t runLength = 0;
+
+    // validate we have at least some data to process
+    if (length == 0) {
+        return TX_STREAM_FAULT;
+    }
+
+    uint32_t pos = 0;
+    for (;;) {
+        // pick the next value if the previous one has been expanded
+        if (runLength == 0 && pos < length) {
+            runValue = buffer[pos++];
+            runLength = 1;
+
+            // zero is followed by the run length; it has to be in the same chunk and can not be empty
+            if (runValue == 0) {
+                if (pos >= length || buffer[pos] == 0) {
+                    return TX_STREAM_FAULT;
+                }
+                runLength = buffer[pos++];
+            }
+        }
+
+        // expand as much of the run as the buffer can take
+        uint32_t toFill = SIZEOF(expanded) - expandedLength;
+        if (runLength < toFill) {
+            toFill = runLength;
+        }
+        memset(expanded + expandedLength, runValue, toFill);
+        expandedLength += toFill;
+        runLength -= toFill;
+
+        // push the full buffer, or the rest of the data to the parser
+        bool isLast = (runLength == 0 && pos >= length);
+        if (expandedLength == SIZEOF(expanded) || (isLast && expandedLength > 0)) {
+            // the parser must not have finished before all the data are consumed
+            if (result != TX_STREAM_PROCESSING) {
+                return TX_STREAM_FAULT;
+            }
+
+            result = txStreamProcess(stream, expanded, expandedLength, flags);
+            if (result == TX_STREAM_FAULT) {
+                return result;
+            }
+            expandedLength = 0;
+        }
+
+        // are we done?
+        if (isLast) {
+            return result;
+        }
+    }
+}
@@ -34,12 +34,23 @@ typedef enum {
 #define TX_FLAG_TYPE 0x01
 #define RLP_LENGTH_BUFFER_SIZE 5
 
+// TX_ZERO_RUN_BUFFER_SIZE defines size of the buffer zero-run compressed data are expanded through.
+#define TX_ZERO_RUN_BUFFER_SIZE 32
+
 // tx_stream_context_t declares context of a transaction stream
 typedef struct {
     // SHA3 hash of the transaction needs to keep the state
     // across incoming chunks of data from the host
     cx_sha3_t *sha3Context;
 
+    // optional SHA3 context receiving just the data field payload
+    // so the user can verify the data against the expected content
+    cx_sha3_t *dataSha3Context;
+
+    // optional buffer receiving the leading bytes of the data field payload
+    uint8_t *dataCapture;
+    uint32_t dataCaptureSize;
+
     // currently processed field details
     tx_rlp_field_e currentField;
     uint32_t currentFieldLength;
@@ -80,6 +91,17 @@ void txStreamInit(
         cx_sha3_t *sha3Context,
         transaction_t *tx);
 
+// txStreamEnableDataDigest implements enabling the separate digest of the data field payload.
+// The SHA3 context is initialized here and receives the data field content only, without
+// the RLP length prefix, so the digest matches the plain hash of the deployed bytecode,
+// or the call data.
+void txStreamEnableDataDigest(tx_stream_context_t *ctx, cx_sha3_t *dataSha3Context);
+
+// txStreamEnableDataCapture implements enabling the capture of the data field payload.
+// Only the leading bytes of the data fitting the buffer are kept, the rest is thrown away.
+// The buffer must stay valid until the stream is finished.
+void txStreamEnableDataCapture(tx_stream_context_t *ctx, uint8_t *buffer, uint32_t bufferSize);
+
 // txStreamProcess implements processing of a buffer of data into the transaction stream.
 // Transaction details come from the host in chunks and we process each chunk here
 // keeping track of the internal state so we know where we left of.
@@ -89,4 +111,14 @@ tx_stream_status_e txStreamProcess(
         uint32_t length,
         uint32_t flags);
 
+// txStreamProcessZeroRun implements processing of a zero-run compressed buffer of data
+// into the transaction stream. A zero byte on the input is followed by the number of zero bytes
+// it stands for, all the other bytes are taken as they are. The data are expanded on the fly
+// so the parser and the transaction hash see exactly the original RLP bytes.
+tx_stream_status_e txStreamProcessZeroRun(
+        tx_stream_context_t *ctx,
+        const uint8_t *buffer,
+        uint32_t length,
+        uint32_t flags);
+
 #endif //FANTOM_LEDGER_TX_STREAM_H
@@ -0,0 +1,246 @@
+/**
+ * Implements the transaction template.
+ *
+ * The host uploads the gas price, gas limit, chain ID and the data of a series
+ * of transactions once. Each transaction of the series is then sent with just
+ * the nonce, recipient and value and the device rebuilds the whole RLP
+ * stream from the template. The rebuilt stream goes through the regular
+ * transaction stream parser, so the hash and the review are exactly the same
+ * as if the transaction was streamed by the host.
+ */
+#include "common.h"
+#include "errors.h"
+#include "big_endian_io.h"
+#include "ui_helpers.h"
+#include "rlp_utils.h"
+#include "tx_template.h"
+
+// txTemplate holds the transaction template of the session.
+static tx_template_t txTemplate;
+
+// what are possible steps of the template upload
+// @see /doc/cmd_tx_template.md for details.
+enum {
+    P1_TEMPLATE_HEADER = 0x00,
+    P1_TEMPLATE_DATA = 0x01,
+};
+
+// TX_RECIPIENT_LENGTH defines the only acceptable non-empty recipient length.
+#define TX_RECIPIENT_LENGTH 20
+
+// txTemplateReadField implements reading of a length prefixed field from the wire buffer.
+// The position is advanced past the field, pointer to the field value is returned.
+// Integer fields must be minimal big endian values, zero is sent as an empty value.
+static const uint8_t *txTemplateReadField(
+        const uint8_t *wireBuffer, size_t wireSize,
+        size_t *pos, size_t maxLength, bool isInteger, uint8_t *length
+) {
+    // the length prefix must be there
+    VALIDATE(*pos < wireSize, ERR_INVALID_DATA);
+    *length = wireBuffer[*pos];
+    (*pos)++;
+
+    // the value must fit both the wire buffer and the target
+    VALIDATE(*length <= maxLength, ERR_INVALID_DATA);
+    VALIDATE(*length <= wireSize - *pos, ERR_INVALID_DATA);
+
+    // the RLP encoding of integers does not allow leading zeros
+    const uint8_t *value = wireBuffer + *pos;
+    VALIDATE(!isInteger || *length == 0 || value[0] != 0, ERR_INVALID_DATA);
+
+    *pos += *length;
+    return value;
+}
+
+// txTemplateItemSize implements calculation of RLP encoded size of a string item.
+static uint32_t txTemplateItemSize(const uint8_t *value, uint32_t length) {
+    // single byte below 0x80 is encoded as itself
+    if (length == 1 && value[0] < 0x80) {
+        return 1;
+    }
+
+    uint8_t header[RLP_LENGTH_BUFFER_SIZE];
+    return rlpEncodeLength(length, false, header, SIZEOF(header)) + length;
+}
+
+// txTemplateFeed implements pushing a piece of RLP data into the transaction stream.
+// The stream status is carried across the pieces; only the very last piece can finish the stream.
+static void txTemplateFeed(tx_stream_context_t *stream, uint8_t *buffer, uint32_t length, tx_stream_status_e *status) {
+    // empty pieces are skipped, the stream does not accept them
+    if (length == 0) {
+        return;
+    }
+
+    // the stream must not have finished before all the data are consumed
+    VALIDATE(*status == TX_STREAM_PROCESSING, ERR_INVALID_DATA);
+
+    *status = txStreamProcess(stream, buffer, length, 0);
+    VALIDATE(*status != TX_STREAM_FAULT, ERR_INVALID_DATA);
+}
+
+// txTemplateFeedItem implements pushing a RLP encoded string item into the transaction stream.
+static void txTemplateFeedItem(tx_stream_context_t *stream, uint8_t *value, uint32_t length, tx_stream_status_e *status) {
+    // single byte below 0x80 is encoded as itself
+    if (length == 1 && value[0] < 0x80) {
+        txTemplateFeed(stream, value, 1, status);
+        return;
+    }
+
+    // the header goes first, the value follows
+    uint8_t header[RLP_LENGTH_BUFFER_SIZE];
+    uint32_t headerSize = rlpEncodeLength(length, false, header, SIZEOF(header));
+    txTemplateFeed(stream, header, headerSize, status);
+    txTemplateFeed(stream, value, length, status);
+}
+
+// txTemplateProcess implements feeding a transaction built from the template
+// and the fields received from the host into the transaction stream.
+tx_stream_status_e txTemplateProcess(tx_stream_context_t *stream, const uint8_t *wireBuffer, size_t wireSize) {
+    // the template must be complete
+    VALIDATE(txTemplate.isValid, ERR_INVALID_STATE);
+
+    // read the nonce, recipient and value from the wire
+    // we copy them since the stream works on mutable buffers
+    size_t pos = 0;
+    uint8_t nonceLength, recipientLength, valueLength;
+    uint8_t nonce[TX_MAX_INT256_LENGTH];
+    uint8_t recipient[TX_RECIPIENT_LENGTH];
+    uint8_t value[TX_MAX_INT256_LENGTH];
+
+    const uint8_t *ptr = txTemplateReadField(wireBuffer, wireSize, &pos, SIZEOF(nonce), true, &nonceLength);
+    memcpy(nonce, ptr, nonceLength);
+
+    ptr = txTemplateReadField(wireBuffer, wireSize, &pos, SIZEOF(recipient), false, &recipientLength);
+    memcpy(recipient, ptr, recipientLength);
+
+    ptr = txTemplateReadField(wireBuffer, wireSize, &pos, SIZEOF(value), true, &valueLength);
+    memcpy(value, ptr, valueLength);
+
+    // nothing else is expected; the recipient is either an address, or empty for a new contract
+    VALIDATE(pos == wireSize, ERR_INVALID_DATA);
+    VALIDATE(recipientLength == 0 || recipientLength == TX_RECIPIENT_LENGTH, ERR_INVALID_DATA);
+
+    // calculate the size of the transaction list payload
+    // EIP-155 transaction is [nonce, gasPrice, startGas, to, value, data, chainId, 0, 0]
+    uint32_t payloadSize = txTemplateItemSize(nonce, nonceLength) +
+                           txTemplateItemSize(txTemplate.gasPrice.value, txTemplate.gasPrice.length) +
+                           txTemplateItemSize(txTemplate.startGas.value, txTemplate.startGas.length) +
+                           txTemplateItemSize(recipient, recipientLength) +
+                           txTemplateItemSize(value, valueLength) +
+                           txTemplateItemSize(txTemplate.data, txTemplate.dataLength) +
+                           txTemplateItemSize(txTemplate.chainId.value, txTemplate.chainId.length) +
+                           2;
+
+    // feed the list header and all the items into the stream
+    tx_stream_status_e status = TX_STREAM_PROCESSING;
+    uint8_t header[RLP_LENGTH_BUFFER_SIZE];
+    uint32_t headerSize = rlpEncodeLength(payloadSize, true, header, SIZEOF(header));
+    txTemplateFeed(stream, header, headerSize, &status);
+
+    txTemplateFeedItem(stream, nonce, nonceLength, &status);
+    txTemplateFeedItem(stream, txTemplate.gasPrice.value, txTemplate.gasPrice.length, &status);
+    txTemplateFeedItem(stream, txTemplate.startGas.value, txTemplate.startGas.length, &status);
+    txTemplateFeedItem(stream, recipient, recipientLength, &status);
+    txTemplateFeedItem(stream, value, valueLength, &status);
+    txTemplateFeedItem(stream, txTemplate.data, txTemplate.dataLength, &status);
+    txTemplateFeedItem(stream, txTemplate.chainId.value, txTemplate.chainId.length, &status);
+
+    // empty <r> and <s> values finish the transaction
+    uint8_t empty[2] = {0x80, 0x80};
+    txTemplateFeed(stream, empty, SIZEOF(empty), &status);
+
+    return status;
+}
+
+// txTemplateClear implements wiping the transaction template.
+void txTemplateClear() {
+    explicit_bzero(&txTemplate, SIZEOF(txTemplate));
+}
+
+// txTemplateRespond implements responding with the number of template data bytes still expected.
+static void txTemplateRespond() {
+    uint8_t res[2];
+    u2be_write(res, txTemplate.dataLength - txTemplate.dataReceived);
+    io_send_buf(SUCCESS, res, SIZEOF(res));
+
+    // the template is complete, we are done here
+    if (txTemplate.isValid) {
+        ui_idle();
+    }
+}
+
+// handleTxTemplateHeader implements receiving the template fields and the data length.
+static void handleTxTemplateHeader(uint8_t p2, uint8_t *wireBuffer, size_t wireSize) {
+    // validate the p2 value
+    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+
+    // any previous template is gone
+    txTemplateClear();
+
+    // read the gas price, gas limit and chain ID
+    size_t pos = 0;
+    const uint8_t *ptr;
+
+    ptr = txTemplateReadField(wireBuffer, wireSize, &pos, SIZEOF(txTemplate.gasPrice.value), true, &txTemplate.gasPrice.length);
+    memcpy(txTemplate.gasPrice.value, ptr, txTemplate.gasPrice.length);
+
+    ptr = txTemplateReadField(wireBuffer, wireSize, &pos, SIZEOF(txTemplate.startGas.value), true, &txTemplate.startGas.length);
+    memcpy(txTemplate.startGas.value, ptr, txTemplate.startGas.length);
+
+    ptr = txTemplateReadField(wireBuffer, wireSize, &pos, SIZEOF(txTemplate.chainId.value), true, &txTemplate.chainId.length);
+    memcpy(txTemplate.chainId.value, ptr, txTemplate.chainId.length);
+
+    // the data length closes the header
+    VALIDATE(wireSize - pos == 2, ERR_INVALID_DATA);
+    txTemplate.dataLength = u2be_read(wireBuffer + pos);
+    VALIDATE(txTemplate.dataLength <= TX_TEMPLATE_MAX_DATA, ERR_INVALID_DATA);
+
+    // the template without data is complete right away
+    txTemplate.isValid = (txTemplate.dataLength == 0);
+    txTemplateRespond();
+}
+
+// handleTxTemplateData implements receiving a chunk of the template data.
+static void handleTxTemplateData(uint8_t p2, uint8_t *wireBuffer, size_t wireSize) {
+    // the header must have been received and we expect more data
+    VALIDATE(!txTemplate.isValid && txTemplate.dataLength > 0, ERR_INVALID_STATE);
+
+    // validate the p2 value
+    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+
+    // the data must fit the advertised length
+    VALIDATE(wireSize > 0, ERR_INVALID_DATA);
+    VALIDATE(wireSize <= (size_t) (txTemplate.dataLength - txTemplate.dataReceived), ERR_INVALID_DATA);
+
+    // append the data
+    memcpy(txTemplate.data + txTemplate.dataReceived, wireBuffer, wireSize);
+    txTemplate.dataReceived += wireSize;
+
+    // is the template complete?
+    txTemplate.isValid = (txTemplate.dataReceived == txTemplate.dataLength);
+    txTemplateRespond();
+}
+
+// handleTxTemplate implements APDU instruction handler for Transaction Template instruction.
+void handleTxTemplate(
+        uint8_t p1,
+        uint8_t p2,
+        uint8_t *wireBuffer,
+        size_t wireSize,
+        bool isOnInit
+) {
+    // the template must start with the header
+    VALIDATE(!isOnInit || p1 == P1_TEMPLATE_HEADER, ERR_INVALID_STATE);
+
+    // decide based on the p1 value
+    switch (p1) {
+        case P1_TEMPLATE_HEADER:
+            handleTxTemplateHeader(p2, wireBuffer, wireSize);
+            break;
+        case P1_TEMPLATE_DATA:
+            handleTxTemplateData(p2, wireBuffer, wireSize);
+            break;
+        default:
+            VALIDATE(false, ERR_INVALID_PARAMETERS);
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef FANTOM_LEDGER_TX_TEMPLATE_H
+#define FANTOM_LEDGER_TX_TEMPLATE_H
+
+#include "common.h"
+#include "handlers.h"
+#include "transaction.h"
+#include "tx_stream.h"
+
+// TX_TEMPLATE_MAX_DATA defines the max size of the transaction data kept by the template.
+// The template lives in RAM for the whole session so we keep it small.
+#define TX_TEMPLATE_MAX_DATA 200
+
+// handleTxTemplate implements Transaction Template APDU instruction handler.
+handler_fn_t handleTxTemplate;
+
+// tx_template_t declares the transaction template; the fields shared
+// by a series of transactions which differ only in nonce, recipient and value.
+typedef struct {
+    bool isValid;
+    tx_int256_t gasPrice;
+    tx_int256_t startGas;
+    tx_v_t chainId;
+    uint16_t dataLength;
+    uint16_t dataReceived;
+    uint8_t data[TX_TEMPLATE_MAX_DATA];
+} tx_template_t;
+
+// txTemplateProcess implements feeding a transaction built from the template
+// and the fields received from the host into the transaction stream.
+// The stream sees the same RLP data it would receive if the whole transaction was streamed.
+tx_stream_status_e txTemplateProcess(tx_stream_context_t *stream, const uint8_t *wireBuffer, size_t wireSize);
+
+// txTemplateClear implements wiping the transaction template.
+void txTemplateClear();
+
+#endif //FANTOM_LEDGER_TX_TEMPLATE_H
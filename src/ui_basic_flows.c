@@ -176,3 +176,153 @@ void ui_doDisplayBusy() {
     // start the busy flow
     ux_flow_init(0, ux_busy_flow, NULL);
 }
+
+// ---------------------------------------------
+// Here starts the UX flow for progress screen.
+// ---------------------------------------------
+
+// UX_STEP_NOCB is a macro for simple flow step without any additional callbacks or params.
+// Here we initialize simple layout (pnn layout means icon + two lines of normal text).
+UX_STEP_NOCB(
+    ux_display_progress_step,
+    pnn,
+    ITEMS(
+        &C_icon_loader,
+        "Please wait ...",
+        (char *)&displayState.progress.text
+    )
+);
+
+// UX_FLOW defines flow for a progress screen with no user interaction.
+UX_FLOW(
+    ux_progress_flow,
+    &ux_display_progress_step
+);
+
+// ui_doDisplayProgress implements actual change in UX flow to show the progress screen.
+void ui_doDisplayProgress() {
+    // start the progress flow
+    ux_flow_init(0, ux_progress_flow, NULL);
+}
+
+// ---------------------------------------------
+// Here starts the UX flow for condensed transaction details.
+// ---------------------------------------------
+
+// ui_confirmTxDetails implements UX callback for transaction details approval.
+void ui_confirmTxDetails() {
+    TRY_CATCH_UI({
+        // verify we are on the right state before firing the callback
+        ui_assertTxDetailsGuard();
+
+        // fire the corresponding call to process user's approval
+        ui_tx_details_state_t *ctx = txDetailsState;
+        ui_callbackConfirm(&ctx->callback);
+    });
+}
+
+// ui_rejectTxDetails implements UX callback for transaction details rejection.
+void ui_rejectTxDetails() {
+    TRY_CATCH_UI({
+        // verify we are on the right state before firing the callback
+        ui_assertTxDetailsGuard();
+
+        // fire the corresponding call to process user's rejection
+        ui_tx_details_state_t *ctx = txDetailsState;
+        ui_callbackReject(&ctx->callback);
+    });
+}
+
+// UX_STEP_NOCB is a macro for simple flow step without any additional callbacks or params.
+// Here we initialize simple layout (bn layout means bold header + one line of normal text).
+UX_STEP_NOCB(
+    ux_tx_details_recipient_step,
+    bn,
+    ITEMS(
+        "To",
+        (char *)&displayState.txDetails.recipient
+    )
+);
+
+UX_STEP_NOCB(
+    ux_tx_details_sender_step,
+    bn,
+    ITEMS(
+        "From",
+        (char *)&displayState.txDetails.sender
+    )
+);
+
+// UX_STEP_NOCB is a macro for simple flow step without any additional callbacks or params.
+// Here we initialize paginated layout so long values can be scrolled inside the step.
+UX_STEP_NOCB(
+    ux_tx_details_amount_step,
+    bnnn_paging,
+    ITEMS(
+        "Amount (FTM)",
+        (char *)&displayState.txDetails.amount
+    )
+);
+
+UX_STEP_NOCB(
+    ux_tx_details_data_step,
+    bnnn_paging,
+    ITEMS(
+        (char *)&displayState.txDetails.dataHeader,
+        (char *)&displayState.txDetails.dataText
+    )
+);
+
+// UX_STEP_CB is a macro for a simple flow step with a validation callback.
+// Both buttons on this step approve the whole transaction.
+UX_STEP_CB(
+    ux_tx_details_confirm_step,
+    pbb,
+    ui_confirmTxDetails(),
+    ITEMS(
+        &C_icon_validate_14,
+        "Approve",
+        "Transaction"
+    )
+);
+
+UX_STEP_CB(
+    ux_tx_details_reject_step,
+    pb,
+    ui_rejectTxDetails(),
+    ITEMS(
+        &C_icon_crossmark,
+        "Reject"
+    )
+);
+
+// UX_FLOW defines flow for condensed transaction details without data.
+UX_FLOW(
+    ux_tx_details_flow,
+    &ux_tx_details_recipient_step,
+    &ux_tx_details_sender_step,
+    &ux_tx_details_amount_step,
+    &ux_tx_details_confirm_step,
+    &ux_tx_details_reject_step
+);
+
+// UX_FLOW defines flow for condensed transaction details with data.
+UX_FLOW(
+    ux_tx_details_data_flow,
+    &ux_tx_details_recipient_step,
+    &ux_tx_details_sender_step,
+    &ux_tx_details_amount_step,
+    &ux_tx_details_data_step,
+    &ux_tx_details_confirm_step,
+    &ux_tx_details_reject_step
+);
+
+// ui_doDisplayTxDetails implements actual change in UX flow to show the configured transaction details.
+void ui_doDisplayTxDetails() {
+    // the data step is shown only if there are any data details
+    if (displayState.txDetails.dataHeader[0] != 0) {
+        ux_flow_init(0, ux_tx_details_data_flow, NULL);
+    } else {
+        ux_flow_init(0, ux_tx_details_flow, NULL);
+    }
+}
@@ -5,11 +5,16 @@
 #include "io.h"
 #include "utils.h"
 #include "address_utils.h"
+#include "errors.h"
+#include "state.h"
 
 // displayState defines the common display state container shared between paginated text and prompt states.
 // We use this trick since only one of the two may happen at any time.
 ui_display_state_t displayState;
 
+// isUIDetached keeps the attached/detached mode of the UI, see ui_setDetached.
+static bool isUIDetached = false;
+
 // G_ux is a magic global variable implicitly referenced by the UX_ macros.
 // Apps should never need to reference it directly.
 ux_state_t G_ux;
@@ -33,7 +38,7 @@ void ui_assertPromptGuard() {
 // ui_assertTxDetailsGuard implements verification of the shared state
 // so we know the state is set for transaction details.
 void ui_assertTxDetailsGuard() {
-    ASSERT(promptState->guard == UI_STATE_GUARD_TX_DETAIL);
+    ASSERT(txDetailsState->guard == UI_STATE_GUARD_TX_DETAIL);
 }
 
 // uiCallbackConfirm implements action callback for confirmed prompt.
@@ -84,6 +89,32 @@ void ui_callbackReject(ui_callback_t *cb) {
     }
 }
 
+// ui_setDetached switches the UI between attached and detached mode.
+void ui_setDetached(bool isDetached) {
+    isUIDetached = isDetached;
+}
+
+// ui_isDetached returns true if the UI runs detached from the APDU exchange.
+bool ui_isDetached() {
+    return isUIDetached;
+}
+
+// ui_faultHandler implements recoverable fault handling on UI interactions.
+void ui_faultHandler() {
+    // nothing of the terminated instruction is left behind
+    wipeInstructionState();
+
+    // the attached UI holds the APDU exchange and the host waits for the response;
+    // the detached one has no APDU pending, the host learns about the fault
+    // when it tries to continue the terminated instruction
+    if (!isUIDetached) {
+        io_send_buf(ERR_FAULT, NULL, 0);
+    }
+
+    // go back to idle; this also resets the instruction being processed
+    ui_idle();
+}
+
 // ui_CallbackInit implements callback structure initialization.
 static void ui_CallbackInit(ui_callback_t *cb, ui_callback_fn_t *confirm, ui_callback_fn_t *reject) {
     cb->state = CALLBACK_NOT_RUN;
@@ -105,8 +136,8 @@ void ui_displayPrompt(
     size_t text_len = strlen(bodyStr);
 
     // prevent overflow; we need one extra byte for string terminator
-    ASSERT(header_len < SIZEOF(promptState->header));
-    ASSERT(text_len < SIZEOF(promptState->text));
+    ENSURE(header_len < SIZEOF(promptState->header));
+    ENSURE(text_len < SIZEOF(promptState->text));
 
     // clear all memory; use safe macro from utils.h
     MEMCLEAR(&displayState, displayState);
@@ -123,10 +154,13 @@ void ui_displayPrompt(
     ctx->guard = UI_STATE_GUARD_PROMPT;
 
     // validate the i/o state we are in and set it to waiting for user interaction
-    ASSERT(io_state == IO_EXPECT_NONE || io_state == IO_EXPECT_UI);
-    #ifndef FUZZING
-    io_state = IO_EXPECT_UI;
-    #endif
+    // detached UI runs alongside the APDU exchange so it does not touch the i/o state
+    if (!isUIDetached) {
+        ASSERT(io_state == IO_EXPECT_NONE || io_state == IO_EXPECT_UI);
+        #ifndef FUZZING
+        io_state = IO_EXPECT_UI;
+        #endif
+    }
     
     // change the UX flow to the configured prompt screen
     ui_doDisplayPrompt();
@@ -145,8 +179,8 @@ void ui_displayPaginatedText(
     size_t body_len = strlen(bodyStr);
 
     // prevent overflow; extra space is for string terminator
-    ASSERT(header_len < SIZEOF(paginatedTextState->header));
-    ASSERT(body_len < SIZEOF(paginatedTextState->text));
+    ENSURE(header_len < SIZEOF(paginatedTextState->header));
+    ENSURE(body_len < SIZEOF(paginatedTextState->text));
 
     // clear the state memory; use safe macro from utils.h
     MEMCLEAR(&displayState, displayState);
@@ -164,18 +198,104 @@ void ui_displayPaginatedText(
     ctx->guard = UI_STATE_GUARD_PAGINATED_TEXT;
 
     // validate the i/o state we are in and set it to waiting for user interaction
-    ASSERT(io_state == IO_EXPECT_NONE || io_state == IO_EXPECT_UI);
-    #ifndef FUZZING
-    io_state = IO_EXPECT_UI;
-    #endif
+    // detached UI runs alongside the APDU exchange so it does not touch the i/o state
+    if (!isUIDetached) {
+        ASSERT(io_state == IO_EXPECT_NONE || io_state == IO_EXPECT_UI);
+        #ifndef FUZZING
+        io_state = IO_EXPECT_UI;
+        #endif
+    }
 
     // change the UX flow to configured paginated text
     ui_doDisplayPaginatedText();
 }
 
+// ui_copyText implements copying a text into the display state buffer.
+static void ui_copyText(char *out, size_t outSize, const char *str) {
+    size_t length = strlen(str);
+
+    // prevent overflow; we need one extra byte for string terminator
+    ENSURE(length < outSize);
+    memcpy(out, str, length + 1);
+}
+
+// ui_copyShortAddress implements copying an abbreviated address into the display state buffer.
+// The address keeps the checksum letters of both ends; any other text is copied as is.
+static void ui_copyShortAddress(char *out, size_t outSize, const char *str) {
+    size_t length = strlen(str);
+
+    // texts like "New Contract" are not abbreviated
+    if (length != MIN_ADDRESS_STR_BUFFER_SIZE - 1 || str[0] != '0' || str[1] != 'x') {
+        ui_copyText(out, outSize, str);
+        return;
+    }
+
+    // we need the prefix, both ends, the separator and the terminator
+    ENSURE(outSize >= 2 + 2 * UI_SHORT_ADDRESS_CHARS + 3 + 1);
+
+    memcpy(out, str, 2 + UI_SHORT_ADDRESS_CHARS);
+    memcpy(out + 2 + UI_SHORT_ADDRESS_CHARS, "...", 3);
+    memcpy(out + 2 + UI_SHORT_ADDRESS_CHARS + 3, str + length - UI_SHORT_ADDRESS_CHARS, UI_SHORT_ADDRESS_CHARS);
+    out[2 + 2 * UI_SHORT_ADDRESS_CHARS + 3] = 0;
+}
+
+// ui_displayTxDetails displays transaction details to end user asking to confirm
+// the transaction before being handled in any way (usually signed).
+void ui_displayTxDetails(
+        const char *recipientStr,
+        const char *senderStr,
+        const char *amountStr,
+        const char *feeStr,
+        const char *dataHeaderStr,
+        const char *dataStr,
+        ui_callback_fn_t *confirm,
+        ui_callback_fn_t *reject
+) {
+    // clear all memory; use safe macro from utils.h
+    MEMCLEAR(&displayState, displayState);
+    ui_tx_details_state_t *ctx = txDetailsState;
+
+    // copy the abbreviated addresses
+    ui_copyShortAddress(ctx->recipient, SIZEOF(ctx->recipient), recipientStr);
+    ui_copyShortAddress(ctx->sender, SIZEOF(ctx->sender), senderStr);
+
+    // the amount and the fee share the screen
+    ENSURE(strlen(amountStr) + strlen(feeStr) + 6 < SIZEOF(ctx->amount));
+    snprintf(ctx->amount, SIZEOF(ctx->amount), "%s, fee %s", amountStr, feeStr);
+
+    // copy the data details if any
+    if (dataHeaderStr != NULL) {
+        ui_copyText(ctx->dataHeader, SIZEOF(ctx->dataHeader), dataHeaderStr);
+        ui_copyText(ctx->dataText, SIZEOF(ctx->dataText), dataStr);
+    }
+
+    // initialize the callback structure
+    ui_CallbackInit(&ctx->callback, confirm, reject);
+
+    // set the guard to mark the shared state as being used by the transaction details now
+    ctx->guard = UI_STATE_GUARD_TX_DETAIL;
+
+    // validate the i/o state we are in and set it to waiting for user interaction
+    // detached UI runs alongside the APDU exchange so it does not touch the i/o state
+    if (!isUIDetached) {
+        ASSERT(io_state == IO_EXPECT_NONE || io_state == IO_EXPECT_UI);
+        #ifndef FUZZING
+        io_state = IO_EXPECT_UI;
+        #endif
+    }
+
+    // change the UX flow to the configured transaction details
+    ui_doDisplayTxDetails();
+}
+
 // ui_displayBusy displays busy screen notifying end user that the device
 // is in the middle of processing stuff.
 void ui_displayBusy() {
+    // the screen belongs to the detached UI waiting for the user
+    if (isUIDetached) {
+        return;
+    }
+
     // clear all memory; use safe macro from utils.h
     MEMCLEAR(&displayState, displayState);
 
@@ -186,6 +306,36 @@ void ui_displayBusy() {
     ui_doDisplayBusy();
 }
 
+// ui_displayProgress displays progress of a long operation the device is in the middle of.
+void ui_displayProgress(uint32_t done, uint32_t total) {
+    // the screen belongs to the detached UI waiting for the user
+    if (isUIDetached) {
+        return;
+    }
+
+    // format the progress
+    char text[SIZEOF(progressState->text)];
+    snprintf(text, SIZEOF(text), "%u of %u", (unsigned) done, (unsigned) total);
+
+    // don't redraw the screen if nothing changed
+    if (progressState->guard == UI_STATE_GUARD_PROGRESS && strcmp(text, progressState->text) == 0) {
+        return;
+    }
+
+    // clear all memory; use safe macro from utils.h
+    MEMCLEAR(&displayState, displayState);
+
+    // validate the i/o state we are in; the progress is shown while processing an APDU
+    ASSERT(io_state == IO_EXPECT_NONE || io_state == IO_EXPECT_IO);
+
+    // set the progress text
+    progressState->guard = UI_STATE_GUARD_PROGRESS;
+    strcpy(progressState->text, text);
+
+    // change the UX flow to the progress screen
+    ui_doDisplayProgress();
+}
+
 // ui_respondWithUserReject implements sending rejection response
 // to host and resetting current instruction from being processed
 // any further.
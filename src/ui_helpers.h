@@ -51,17 +51,53 @@ typedef struct {
     ui_callback_t callback;
 } ui_prompt_state_t;
 
+// UI_SHORT_ADDRESS_CHARS defines how many address characters we show on both ends
+// of an abbreviated address in the condensed transaction details.
+#define UI_SHORT_ADDRESS_CHARS 6
+
+// ui_tx_details_state_t declares a state of condensed transaction details
+// displayed to the expert user in a single multi-step flow. The user reviews
+// all the screens in one pass and approves, or rejects, the transaction at the end.
+typedef struct {
+    uint16_t guard;
+    char recipient[2 + 2 * UI_SHORT_ADDRESS_CHARS + 3 + 1];
+    char sender[2 + 2 * UI_SHORT_ADDRESS_CHARS + 3 + 1];
+    char amount[90];
+    char dataHeader[20];
+    char dataText[160];
+    ui_callback_t callback;
+} ui_tx_details_state_t;
+
+// ui_progress_state_t declares a state of progress screen shown while the device
+// runs a long operation. There is no user interaction, the screen just shows
+// how far the operation got so the user knows the device did not freeze.
+typedef struct {
+    uint16_t guard;
+    char text[MAX_SIMPLE_TEXT_LENGTH + 1];
+} ui_progress_state_t;
+
 // ui_display_state_t merges both types of "display text & wait for decision" state together
 // in a single union. We never need both so we re-use the structure to save some space.
 // Notice the guard is on the beginning of both structures and so will always align the same way.
 typedef union {
     ui_paginated_text_state_t paginatedText;
     ui_prompt_state_t prompt;
+    ui_tx_details_state_t txDetails;
+    ui_progress_state_t progress;
 } ui_display_state_t;
 
 // ui_idle implements transaction to idle state
 void ui_idle(void);
 
+// ui_setDetached switches the UI between attached and detached mode.
+// Attached UI (the default) blocks APDU exchange while waiting for the user.
+// Detached UI waits for the user in the background while the host keeps
+// exchanging APDU messages with the app; the result is collected later.
+void ui_setDetached(bool isDetached);
+
+// ui_isDetached returns true if the UI runs detached from the APDU exchange.
+bool ui_isDetached();
+
 // ui_displayPaginatedText displays paginated text and waits for basic user
 // interaction; we don't need user to decide a course of action
 // so there is just one callback signaling that user did finish reading the text.
@@ -82,7 +118,15 @@ void ui_displayPrompt(
 
 // ui_displayTxDetails displays transaction details to end user asking to confirm
 // the transaction before being handled in any way (usually signed).
+// The addresses are abbreviated and the amount and fee share a single screen.
+// The data screen is skipped if the data header is NULL.
 void ui_displayTxDetails(
+        const char *recipientStr,
+        const char *senderStr,
+        const char *amountStr,
+        const char *feeStr,
+        const char *dataHeaderStr,
+        const char *dataStr,
         ui_callback_fn_t *confirm,
         ui_callback_fn_t *reject);
 
@@ -90,6 +134,10 @@ void ui_displayTxDetails(
 // is in the middle of processing stuff.
 void ui_displayBusy();
 
+// ui_displayProgress displays progress of a long operation the device
+// is in the middle of; the screen is redrawn only if the progress changed.
+void ui_displayProgress(uint32_t done, uint32_t total);
+
 // ui_doDisplayPrompt implements actual change in UX flow to show the configured prompt.
 void ui_doDisplayPrompt();
 
@@ -99,6 +147,12 @@ void ui_doDisplayPaginatedText();
 // ui_doDisplayBusy implements actual change in UX flow to show the busy screen.
 void ui_doDisplayBusy();
 
+// ui_doDisplayProgress implements actual change in UX flow to show the progress screen.
+void ui_doDisplayProgress();
+
+// ui_doDisplayTxDetails implements actual change in UX flow to show the configured transaction details.
+void ui_doDisplayTxDetails();
+
 // ui_callbackConfirm implements action callback for confirmed prompt.
 void ui_callbackConfirm(ui_callback_t *cb);
 
@@ -113,6 +167,10 @@ void ui_assertPaginatedTextGuard();
 // so we know the state is set for prompt.
 void ui_assertPromptGuard();
 
+// ui_assertTxDetailsGuard implements verification of the shared state
+// so we know the state is set for transaction details.
+void ui_assertTxDetailsGuard();
+
 // ui_respondWithUserReject implements sending rejection response
 // to host and resetting current instruction from being processed
 // any further.
@@ -125,12 +183,15 @@ extern ui_display_state_t displayState;
 // keep references to internal type specific states inside the shared state.
 static ui_paginated_text_state_t *paginatedTextState = &(displayState.paginatedText);
 static ui_prompt_state_t *promptState = &(displayState.prompt);
+static ui_tx_details_state_t *txDetailsState = &(displayState.txDetails);
+static ui_progress_state_t *progressState = &(displayState.progress);
 
 // what guards we use for the shared state
 enum {
     UI_STATE_GUARD_PAGINATED_TEXT = 0xF0F0,
     UI_STATE_GUARD_PROMPT = 0x0F0F,
     UI_STATE_GUARD_TX_DETAIL = 0xF1F1,
+    UI_STATE_GUARD_PROGRESS = 0xF2F2,
 };
 
 // ui_crash_handler implements critical UI failure handling.
@@ -142,8 +203,14 @@ static inline void ui_crash_handler() {
     #endif
 }
 
+// ui_faultHandler implements recoverable fault handling on UI interactions.
+// The instruction state is wiped, the attached UI responds with the fault status
+// to the APDU it holds, and the app returns to idle.
+void ui_faultHandler();
+
 // TRY_CATCH_UI implements convenience macro for capturing exceptions on UI
-// interactions.
+// interactions. Recoverable faults are handled by ui_faultHandler, the rest
+// by ui_crash_handler.
 #define TRY_CATCH_UI(ui_call) \
     BEGIN_TRY { \
         TRY { \
@@ -153,6 +220,10 @@ static inline void ui_crash_handler() {
         { \
             THROW(EXCEPTION_IO_RESET); \
         } \
+        CATCH(ERR_FAULT) \
+        { \
+            ui_faultHandler(); \
+        } \
         CATCH_OTHER(e) \
         { \
             ui_crash_handler(); \
@@ -106,8 +106,9 @@ void shiftRight128(uint128_t *number, uint32_t value, uint128_t *target) {
     if (value >= 128) {
         clear128(target);
     } else if (value == 64) {
-        UPPER_P(target) = 0;
+        // the target may be the number itself
         LOWER_P(target) = UPPER_P(number);
+        UPPER_P(target) = 0;
     } else if (value == 0) {
         copy128(target, number);
     } else if (value < 64) {
@@ -413,7 +414,7 @@ void mul256(uint256_t *number1, uint256_t *number2, uint256_t *target) {
     clear256(&target1);
     shiftLeft128(&first64, 64, &UPPER(target1));
     clear256(&target2);
-    UPPER(UPPER(target2)) = UPPER(third64);
+    LOWER(UPPER(target2)) = UPPER(third64);
     shiftLeft128(&third64, 64, &LOWER(target2));
     add256(&target1, &target2, target);
     clear256(&target1);
@@ -446,6 +447,7 @@ void divMod128(uint128_t *l, uint128_t *r, uint128_t *retDiv,
             shiftRight128(&adder, 1, &adder);
         }
         while (gte128(&resMod, r)) {
+            FUZZ_WORK(1);
             if (gte128(&resMod, &copyD)) {
                 minus128(&resMod, &copyD, &resMod);
                 or128(&resDiv, &adder, &resDiv);
@@ -479,6 +481,7 @@ void divMod256(uint256_t *l, uint256_t *r, uint256_t *retDiv, uint256_t *retMod)
             shiftRight256(&adder, 1, &adder);
         }
         while (gte256(&resMod, r)) {
+            FUZZ_WORK(1);
             if (gte256(&resMod, &copyD)) {
                 minus256(&resMod, &copyD, &resMod);
                 or256(&resDiv, &adder, &resDiv);
@@ -505,7 +508,7 @@ void stringReverse(char *str, size_t length) {
 // uint256ConvertBE implements conversion from array of 8 bit values to uint256.
 void uint256ConvertBE(uint256_t *out, const uint8_t *data, size_t length) {
     // make sure the data is within reasonable length
-    VALIDATE(length <= 32, ERR_ASSERT);
+    ENSURE(length <= 32);
 
     // we parsed the data from incoming RLP stream
     // and data length may be smaller than the full 256 bit size
@@ -526,7 +529,7 @@ size_t uint256ToString(uint256_t *number, uint32_t baseParam, char *out, size_t
     uint256_t base;
 
     // validate the base is reasonable
-    VALIDATE((baseParam >= 2) && (baseParam <= 16), ERR_ASSERT);
+    ENSURE((baseParam >= 2) && (baseParam <= 16));
 
     // init state
     copy256(&rDiv, number);
@@ -537,8 +540,8 @@ size_t uint256ToString(uint256_t *number, uint32_t baseParam, char *out, size_t
     size_t offset = 0;
 
     do {
-        // we run out of space
-        if (offset > (outLength - 1)) {
+        // we run out of space; the terminator needs a byte as well
+        if (offset + 1 >= outLength) {
             return 0;
         }
 
@@ -571,7 +574,7 @@ uint64_t readUint64BE(const uint8_t *buffer) {
 // readUint128BE implements reading big endian 128 bit value from the given buffer.
 void readUint128BE(uint128_t *target, const uint8_t *buffer, size_t length) {
     // make sure the buffer size is what we expect
-    VALIDATE(length >= 16, ERR_ASSERT);
+    ENSURE(length >= 16);
 
     // read lower and upper part of the value
     UPPER_P(target) = readUint64BE(buffer);
@@ -581,7 +584,7 @@ void readUint128BE(uint128_t *target, const uint8_t *buffer, size_t length) {
 // readUint256BE implements reading big endian 256 bit value from the given buffer
 void readUint256BE(uint256_t *target, const uint8_t *buffer, size_t length) {
     // make sure the buffer size is what we expect
-    VALIDATE(length >= 32, ERR_ASSERT);
+    ENSURE(length >= 32);
 
     // read upper and lower part of the 256 bits
     readUint128BE(&UPPER_P(target), buffer, 16);
@@ -42,6 +42,15 @@
 // start using such variable. deprecated deals with that.
 #define MARK_UNUSED __attribute__ ((unused, deprecated))
 
+// FUZZ_WORK counts work units of the hot helpers in the latency fuzzing build;
+// it compiles to nothing in the app. See fuzzing/latency.h.
+#ifdef FUZZ_LATENCY
+extern void fuzzWork(uint32_t units);
+#define FUZZ_WORK(units) fuzzWork(units)
+#else
+#define FUZZ_WORK(units) do {} while(0)
+#endif
+
 // Any buffer claiming to be longer than this is a bug
 // We have only 4KB of memory available
 #define MAX_BUFFER_SIZE 1024
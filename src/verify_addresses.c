@@ -0,0 +1,260 @@
+/**
+ * Implements Verify Addresses APDU instruction handler.
+ *
+ * The instruction confirms that addresses derived by the host under a chain node
+ * m/44'/60'/account'/change really belong to the device. The user approves
+ * the chain node once, the host then sends batches of address index and expected
+ * address pairs and receives a bitmap of matching addresses for each batch.
+ */
+#include "common.h"
+#include "errors.h"
+#include "big_endian_io.h"
+#include "state.h"
+#include "ui_helpers.h"
+#include "policy.h"
+#include "address_utils.h"
+#include "verify_addresses.h"
+
+// ctx hold the direct reference to this instruction context.
+static ins_verify_addresses_context_t *ctx = &(instructionState.insVerifyAddressesContext);
+
+// RESPONSE_READY_TAG is used to tag the state context that the verification has been approved.
+static int16_t RESPONSE_READY_TAG = 21431;
+
+// what are possible steps of the verification
+// @see /doc/cmd_verify_addresses.md for details.
+enum {
+    P1_NEW_VERIFICATION = 0x00,
+    P1_VERIFY_BATCH = 0x01,
+    P1_FINISH = 0x80,
+};
+
+// ADDRESS_PAIR_SIZE defines the size of the address index and address pair on the wire.
+#define ADDRESS_PAIR_SIZE (4 + RAW_ADDRESS_SIZE)
+
+// runVerifyAddressesUIStep implements next step of UX for the Verify Addresses instruction.
+static void runVerifyAddressesUIStep();
+
+// what steps are being handled
+enum {
+    UI_STEP_WARNING = 100,
+    UI_STEP_DISPLAY_PATH,
+    UI_STEP_CONFIRM,
+    UI_STEP_RESPOND,
+    UI_STEP_INVALID,
+};
+
+// handleVerifyAddressesInit implements the first step of the verification.
+static void handleVerifyAddressesInit(uint8_t p2, uint8_t *wireBuffer, size_t wireSize) {
+    // the verification can not be restarted in the middle
+    VALIDATE(!ctx->isStarted, ERR_INVALID_STATE);
+
+    // validate the p2 value
+    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+
+    // parse the chain node path from the wire buffer
+    size_t parsedSize = bip44_parseFromWire(&ctx->path, wireBuffer, wireSize);
+
+    // make sure size of the data we parsed corresponds with the data we received
+    VALIDATE(parsedSize == wireSize, ERR_INVALID_DATA);
+
+    // check security policy for the chain node
+    security_policy_t policy = policyForVerifyAddresses(&ctx->path);
+    ASSERT_NOT_DENIED(policy);
+
+    // mark the verification started
+    ctx->isStarted = true;
+
+    // where on the UI scenario we start depends on the policy
+    switch (policy) {
+        case POLICY_WARN:
+            ctx->uiStep = UI_STEP_WARNING;
+            break;
+        case POLICY_PROMPT:
+            ctx->uiStep = UI_STEP_DISPLAY_PATH;
+            break;
+        default:
+            // if no policy was set, terminate the action
+            ASSERT(false);
+    }
+
+    // run the first step
+    runVerifyAddressesUIStep();
+}
+
+// runVerifyAddressesUIStep implements next step of UX for the Verify Addresses instruction.
+static void runVerifyAddressesUIStep() {
+    // keep the callback to myself
+    ui_callback_fn_t *this_fn = runVerifyAddressesUIStep;
+
+    // resume the stage based on previous result
+    switch (ctx->uiStep) {
+        case UI_STEP_WARNING: {
+            // display the warning
+            ui_displayPaginatedText(
+                    "Unusual Request",
+                    "Be careful!",
+                    this_fn
+            );
+
+            // set next step
+            ctx->uiStep = UI_STEP_DISPLAY_PATH;
+            break;
+        }
+
+        case UI_STEP_DISPLAY_PATH: {
+            // prep container for BIP44 path and format it
+            char pathStr[100];
+            bip44_pathToStr(&ctx->path, pathStr, SIZEOF(pathStr));
+
+            // display BIP44 path
+            ui_displayPaginatedText(
+                    "Verify Addresses",
+                    pathStr,
+                    this_fn
+            );
+
+            // set next step
+            ctx->uiStep = UI_STEP_CONFIRM;
+            break;
+        }
+
+        case UI_STEP_CONFIRM: {
+            // ask user to confirm the verification
+            ui_displayPrompt(
+                    "Confirm",
+                    "Verification?",
+                    this_fn,
+                    ui_respondWithUserReject
+            );
+
+            // set next step
+            ctx->uiStep = UI_STEP_RESPOND;
+            break;
+        }
+
+        case UI_STEP_RESPOND: {
+            // mark the verification approved
+            ctx->responseReady = RESPONSE_READY_TAG;
+
+            // respond to host that it's ok to send addresses
+            io_send_buf(SUCCESS, NULL, 0);
+            ui_displayBusy();
+
+            // set invalid step so we never cycle around
+            ctx->uiStep = UI_STEP_INVALID;
+            break;
+        }
+
+        default: {
+            // we don't tolerate invalid state
+            ASSERT(false);
+        }
+    }
+}
+
+// setAddressPath implements building the address path under the verified chain node.
+static void setAddressPath(uint32_t index) {
+    memcpy(&ctx->addressPath, &ctx->path, SIZEOF(ctx->addressPath));
+    ctx->addressPath.length = BIP44_I_ADDRESS + 1;
+    ctx->addressPath.path[BIP44_I_ADDRESS] = index;
+}
+
+// verifyPairStep implements verification of a single address pair of the batch.
+static bool verifyPairStep(uint32_t i) {
+    const uint8_t *pair = ctx->batch + i * ADDRESS_PAIR_SIZE;
+
+    // we don't verify hardened addresses; they can not be derived by the host anyway
+    uint32_t index = u4be_read(pair);
+    VALIDATE(!bip44_isHardened(index), ERR_INVALID_DATA);
+
+    // derive the address
+    setAddressPath(index);
+    deriveAddress(&ctx->addressPath, &ctx->sha3Context, ctx->address, SIZEOF(ctx->address));
+
+    // mark the match
+    if (memcmp(ctx->address, pair + 4, RAW_ADDRESS_SIZE) == 0) {
+        ctx->response.bitmap[i / 8] |= (uint8_t) (1 << (i % 8));
+    }
+    return true;
+}
+
+// handleVerifyAddressesBatch implements verification of a batch of addresses.
+static void handleVerifyAddressesBatch(uint8_t p2, uint8_t *wireBuffer, size_t wireSize) {
+    // the verification must have been approved
+    VALIDATE(ctx->isStarted && ctx->responseReady == RESPONSE_READY_TAG, ERR_INVALID_STATE);
+
+    // validate the p2 value
+    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+
+    // we expect whole address pairs
+    VALIDATE(wireSize > 0 && wireSize % ADDRESS_PAIR_SIZE == 0, ERR_INVALID_DATA);
+    uint8_t count = (uint8_t) (wireSize / ADDRESS_PAIR_SIZE);
+    VALIDATE(count <= VERIFY_ADDRESSES_PER_REQUEST, ERR_INVALID_DATA);
+
+    // the bitmap of matching addresses; bit 0 of the first byte is the first address
+    MEMCLEAR(&ctx->response, ctx->response);
+    ctx->response.count = count;
+
+    // verify the pairs; the pairs are used only while the request is being processed
+    ctx->batch = wireBuffer;
+    schedulerInit(&ctx->work, verifyPairStep, count);
+    schedulerRun(&ctx->work, count);
+    ctx->batch = NULL;
+
+    // keep the track of verified addresses
+    ctx->verified += count;
+
+    // send the result
+    io_send_buf(SUCCESS, (uint8_t * ) & ctx->response, SIZEOF(ctx->response));
+    ui_displayBusy();
+}
+
+// handleVerifyAddressesFinish implements the last step of the verification.
+static void handleVerifyAddressesFinish(uint8_t p2, size_t wireSize) {
+    // the verification must have been approved
+    VALIDATE(ctx->isStarted && ctx->responseReady == RESPONSE_READY_TAG, ERR_INVALID_STATE);
+
+    // validate the p2 value
+    VALIDATE(p2 == 0, ERR_INVALID_PARAMETERS);
+
+    // we don't expect to receive any data here
+    VALIDATE(wireSize == 0, ERR_INVALID_DATA);
+
+    // respond with the number of addresses verified in the session
+    uint8_t res[4];
+    u4be_write(res, ctx->verified);
+    io_send_buf(SUCCESS, res, SIZEOF(res));
+
+    // we are done here
+    ui_idle();
+}
+
+// handleVerifyAddresses implements APDU instruction handler for Verify Addresses instruction.
+void handleVerifyAddresses(
+        uint8_t p1,
+        uint8_t p2,
+        uint8_t *wireBuffer,
+        size_t wireSize,
+        bool isOnInit
+) {
+    // make sure the state is clean
+    if (isOnInit) {
+        memset(ctx, 0, SIZEOF(*ctx));
+    }
+
+    // decide based on the p1 value
+    switch (p1) {
+        case P1_NEW_VERIFICATION:
+            handleVerifyAddressesInit(p2, wireBuffer, wireSize);
+            break;
+        case P1_VERIFY_BATCH:
+            handleVerifyAddressesBatch(p2, wireBuffer, wireSize);
+            break;
+        case P1_FINISH:
+            handleVerifyAddressesFinish(p2, wireSize);
+            break;
+        default:
+            VALIDATE(false, ERR_INVALID_PARAMETERS);
+    }
+}
@@ -0,0 +1,36 @@
+#ifndef FANTOM_LEDGER_VERIFY_ADDRESSES_H
+#define FANTOM_LEDGER_VERIFY_ADDRESSES_H
+
+#include "common.h"
+#include "handlers.h"
+#include "bip44.h"
+#include "address_utils.h"
+#include "scheduler.h"
+
+// VERIFY_ADDRESSES_PER_REQUEST defines how many address pairs fit into a single request APDU.
+// Each pair takes 24 bytes (4 bytes address index and 20 bytes address), APDU data are limited to 255 bytes.
+#define VERIFY_ADDRESSES_PER_REQUEST 10
+
+// handleVerifyAddresses implements Verify Addresses APDU instruction handler.
+handler_fn_t handleVerifyAddresses;
+
+// ins_verify_addresses_context_t declares context
+// for the bulk address verification APDU instruction.
+typedef struct {
+    int16_t responseReady;
+    bool isStarted;
+    bip44_path_t path;
+    cx_sha3_t sha3Context;
+    uint32_t verified;
+    bip44_path_t addressPath;
+    work_item_t work;
+    const uint8_t *batch;
+    uint8_t address[RAW_ADDRESS_SIZE];
+    struct {
+        uint8_t count;
+        uint8_t bitmap[(VERIFY_ADDRESSES_PER_REQUEST + 7) / 8];
+    } response;
+    int uiStep;
+} ins_verify_addresses_context_t;
+
+#endif //FANTOM_LEDGER_VERIFY_ADDRESSES_H
@@ -0,0 +1,48 @@
+#!/usr/bin/env python
+from __future__ import print_function
+
+from ledgerblue.comm import getDongle
+from ledgerblue.commException import CommException
+import argparse
+import struct
+import binascii
+
+# inform what we do
+print("~~ Fantom Nano Ledger Test ~~")
+print("Requesting account discovery: INS 0x12")
+
+# what range of accounts we will request
+parser = argparse.ArgumentParser()
+parser.add_argument('--first', help="first account index", type=int, default=0)
+parser.add_argument('--count', help="number of accounts, up to 20", type=int, default=5)
+args = parser.parse_args()
+
+# Create APDU message.
+# --------------------
+# CLA 0xE0
+# INS 0x12  ACCOUNT DISCOVERY
+# P1 0x00   START DISCOVERY
+# P2 0x00   NO DATA
+# Lc 0x05   FIRST ACCOUNT AND COUNT
+# --------------------
+apdu = bytearray.fromhex("e012000005") + struct.pack(">IB", args.first, args.count)
+
+# send the APDU message to Ledger; user confirms the export on the device
+dongle = getDongle(True)
+result = dongle.exchange(bytes(apdu))
+
+# the response format is <1 byte remaining><1 byte count><78 bytes key>...
+account = args.first
+while True:
+    remaining = result[0]
+    count = result[1]
+    for i in range(count):
+        key = result[2 + 78 * i: 2 + 78 * (i + 1)]
+        print("Account", account, "xpub", binascii.hexlify(key).decode())
+        account += 1
+
+    if remaining == 0:
+        break
+
+    # CLA 0xE0, INS 0x12, P1 0x01 NEXT ACCOUNTS, P2 0x00, Lc 0x00
+    result = dongle.exchange(bytes(bytearray.fromhex("e012010000")))
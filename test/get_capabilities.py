@@ -0,0 +1,31 @@
+#!/usr/bin/env python
+#
+# This will test Get Capabilities instruction on Fantom Ledger App
+#
+from ledgerblue.comm import getDongle
+import binascii
+
+# inform what we do
+print("~~ Fantom None Ledger Test ~~")
+print("Requesting application capabilities: INS 0x02")
+
+# Create APDU message.
+# CLA 0xE0
+# INS 0x02  GET CAPABILITIES
+# P1 0x00   NO DATA
+# P2 0x00   NO DATA
+# No confirmation
+apduMessage = "E002000000"
+apdu = bytearray.fromhex(apduMessage)
+
+# do the request
+dongle = getDongle(True)
+result = dongle.exchange(apdu)
+
+# print the result
+print("Features: 0x" + binascii.hexlify(result[0:4]).decode())
+print("Accounts per response: " + str(result[4]) + ", max " + str(result[5]))
+print("Addresses per verify batch: " + str(result[6]))
+print("Preferred chunk size: " + str(result[7]))
+print("Tx slots: " + str(result[8]) + ", key slots: " + str(result[9]))
+print("Signature cache: " + str(result[10]) + ", node cache: " + str(result[11]))
@@ -0,0 +1,67 @@
+#!/usr/bin/env python
+from __future__ import print_function
+
+from ledgerblue.comm import getDongle
+from ledgerblue.commException import CommException
+import argparse
+import struct
+import binascii
+
+def parse_bip32_path(path):
+    if len(path) == 0:
+        return b""
+    result = b""
+    elements = path.split('/')
+    for pathElement in elements:
+        element = pathElement.split('\'')
+        if len(element) == 1:
+            result = result + struct.pack(">I", int(element[0]))
+        else:
+            result = result + struct.pack(">I", 0x80000000 | int(element[0]))
+    return result
+
+
+# inform what we do
+print("~~ Fantom Nano Ledger Test ~~")
+print("Registering a key slot: INS 0x14")
+
+# what BIP44 path we will register and in which slot
+parser = argparse.ArgumentParser()
+parser.add_argument('--path', help="BIP 32 path to register")
+parser.add_argument('--slot', help="slot ID, 0 to 3", type=int, default=0)
+args = parser.parse_args()
+
+if args.path == None:
+    args.path = "44'/60'/0'/0/0"
+
+# parse the path and show it
+bipPath = parse_bip32_path(args.path)
+
+# Create APDU message.
+# --------------------
+# CLA 0xE0
+# INS 0x14  KEY SLOTS
+# P1 0x00   REGISTER SLOT
+# P2 <var>  SLOT ID
+# Lc <var>  PATH LENGTH
+# --------------------
+apdu = bytearray.fromhex("e01400") + chr(args.slot).encode() + chr(len(bipPath) + 1).encode() + \
+       chr(len(bipPath) // 4).encode() + bipPath
+
+# send the APDU message to Ledger
+dongle = getDongle(True)
+result = dongle.exchange(bytes(apdu))
+
+# the response format is <1 byte length><bytes address>
+address = result[1: 1 + result[0]]
+print("Slot", args.slot, "address", binascii.hexlify(address).decode())
+
+# get the address through the slot; P1 0x01 RETURN ADDRESS, P2 0x01 KEY SLOT, Lc 0x01 SLOT ID
+apdu = bytearray.fromhex("e0110101") + chr(1).encode() + chr(args.slot).encode()
+result = dongle.exchange(bytes(apdu))
+print("Address by slot", binascii.hexlify(result[1: 1 + result[0]]).decode())
+
+# CLA 0xE0, INS 0x14, P1 0x01 RELEASE SLOT, P2 <var> SLOT ID, Lc 0x00
+apdu = bytearray.fromhex("e01401") + chr(args.slot).encode() + chr(0).encode()
+dongle.exchange(bytes(apdu))
+print("Slot", args.slot, "released")
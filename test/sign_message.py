@@ -0,0 +1,66 @@
+#!/usr/bin/env python
+from __future__ import print_function
+
+from ledgerblue.comm import getDongle
+from ledgerblue.commException import CommException
+import argparse
+import struct
+import binascii
+
+def parse_bip32_path(path):
+    if len(path) == 0:
+        return b""
+    result = b""
+    elements = path.split('/')
+    for pathElement in elements:
+        element = pathElement.split('\'')
+        if len(element) == 1:
+            result = result + struct.pack(">I", int(element[0]))
+        else:
+            result = result + struct.pack(">I", 0x80000000 | int(element[0]))
+    return result
+
+
+# inform what we do
+print("~~ Fantom Nano Ledger Test ~~")
+print("Signing personal message: INS 0x22")
+
+# what BIP44 path and message we will sign
+parser = argparse.ArgumentParser()
+parser.add_argument('--path', help="BIP 32 path of the signing key")
+parser.add_argument('--message', help="message text to sign", default="Hello Fantom!")
+args = parser.parse_args()
+
+if args.path == None:
+    args.path = "44'/60'/0'/0/0"
+
+bipPath = parse_bip32_path(args.path)
+message = args.message.encode()
+
+# Create APDU message.
+# --------------------
+# CLA 0xE0
+# INS 0x22  SIGN PERSONAL MESSAGE
+# P1 0x00   INIT MESSAGE
+# P2 0x00   NO DATA
+# Lc <var>  PATH LENGTH AND MESSAGE LENGTH
+# --------------------
+payload = chr(len(bipPath) // 4).encode() + bipPath + struct.pack(">I", len(message))
+apdu = bytearray.fromhex("e0220000") + chr(len(payload)).encode() + payload
+
+# send the APDU message to Ledger
+dongle = getDongle(True)
+result = dongle.exchange(bytes(apdu))
+
+# send the message in blocks; P1 0x01 MESSAGE DATA
+for offset in range(0, len(message), 200):
+    chunk = message[offset: offset + 200]
+    apdu = bytearray.fromhex("e0220100") + chr(len(chunk)).encode() + chunk
+    result = dongle.exchange(bytes(apdu))
+print("Remaining message length:", struct.unpack(">I", bytes(result[0:4]))[0])
+
+# CLA 0xE0, INS 0x22, P1 0x80 GET SIGNATURE, P2 0x00, Lc 0x00; user confirms on the device
+result = dongle.exchange(bytes(bytearray.fromhex("e022800000")))
+print("Signature v", result[0])
+print("Signature r", binascii.hexlify(result[1:33]).decode())
+print("Signature s", binascii.hexlify(result[33:65]).decode())
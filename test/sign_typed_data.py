@@ -0,0 +1,76 @@
+#!/usr/bin/env python
+from __future__ import print_function
+
+from ledgerblue.comm import getDongle
+from ledgerblue.commException import CommException
+import argparse
+import struct
+import binascii
+
+def parse_bip32_path(path):
+    if len(path) == 0:
+        return b""
+    result = b""
+    elements = path.split('/')
+    for pathElement in elements:
+        element = pathElement.split('\'')
+        if len(element) == 1:
+            result = result + struct.pack(">I", int(element[0]))
+        else:
+            result = result + struct.pack(">I", 0x80000000 | int(element[0]))
+    return result
+
+def uint256(value):
+    return value.to_bytes(32, "big")
+
+
+# inform what we do
+print("~~ Fantom Nano Ledger Test ~~")
+print("Signing typed data: INS 0x23")
+
+# what BIP44 path and typed data we will sign
+parser = argparse.ArgumentParser()
+parser.add_argument('--path', help="BIP 32 path of the signing key")
+parser.add_argument('--domain', help="domain separator in hex", default="11" * 32)
+parser.add_argument('--struct', help="struct hash of the message in hex", default="22" * 32)
+parser.add_argument('--permit', help="sign ERC-2612 permit for the spender address in hex instead")
+parser.add_argument('--value', help="permit value in token base units", type=int, default=1000000)
+parser.add_argument('--nonce', help="permit nonce", type=int, default=0)
+parser.add_argument('--deadline', help="permit deadline unix timestamp", type=int, default=2000000000)
+args = parser.parse_args()
+
+if args.path == None:
+    args.path = "44'/60'/0'/0/0"
+
+bipPath = parse_bip32_path(args.path)
+path = chr(len(bipPath) // 4).encode() + bipPath
+domain = binascii.unhexlify(args.domain)
+
+dongle = getDongle(True)
+if args.permit == None:
+    # Create APDU message.
+    # --------------------
+    # CLA 0xE0
+    # INS 0x23  SIGN TYPED DATA
+    # P1 0x00   STRUCT HASH
+    # P2 0x00   NO DATA
+    # Lc <var>  PATH, DOMAIN SEPARATOR AND STRUCT HASH
+    # --------------------
+    payload = path + domain + binascii.unhexlify(args.struct)
+    apdu = bytearray.fromhex("e0230000") + chr(len(payload)).encode() + payload
+else:
+    # the permit owner must be the signing address; CLA 0xE0, INS 0x11, P1 0x01 RETURN ADDRESS
+    apdu = bytearray.fromhex("e0110100") + chr(len(path)).encode() + path
+    result = dongle.exchange(bytes(apdu))
+    owner = bytes(result[1: 1 + result[0]])
+
+    # CLA 0xE0, INS 0x23, P1 0x01 PERMIT, P2 0x00, Lc <var> PATH, DOMAIN SEPARATOR AND PERMIT FIELDS
+    payload = path + domain + owner + binascii.unhexlify(args.permit) + \
+              uint256(args.value) + uint256(args.nonce) + uint256(args.deadline)
+    apdu = bytearray.fromhex("e0230100") + chr(len(payload)).encode() + payload
+
+# send the APDU message to Ledger; user confirms on the device
+result = dongle.exchange(bytes(apdu))
+print("Signature v", result[0])
+print("Signature r", binascii.hexlify(result[1:33]).decode())
+print("Signature s", binascii.hexlify(result[33:65]).decode())
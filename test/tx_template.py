@@ -0,0 +1,95 @@
+#!/usr/bin/env python
+from __future__ import print_function
+
+from ledgerblue.comm import getDongle
+from ledgerblue.commException import CommException
+import argparse
+import struct
+import binascii
+
+def parse_bip32_path(path):
+    if len(path) == 0:
+        return b""
+    result = b""
+    elements = path.split('/')
+    for pathElement in elements:
+        element = pathElement.split('\'')
+        if len(element) == 1:
+            result = result + struct.pack(">I", int(element[0]))
+        else:
+            result = result + struct.pack(">I", 0x80000000 | int(element[0]))
+    return result
+
+def encode_int(value):
+    # big endian without leading zeros, zero is empty
+    result = b""
+    while value > 0:
+        result = struct.pack(">B", value & 0xFF) + result
+        value >>= 8
+    return result
+
+def field(value):
+    return struct.pack(">B", len(value)) + value
+
+
+# inform what we do
+print("~~ Fantom Nano Ledger Test ~~")
+print("Uploading transaction template: INS 0x21, signing from template: INS 0x20")
+
+# what template and transaction we will send
+parser = argparse.ArgumentParser()
+parser.add_argument('--path', help="BIP 32 path of the signing key")
+parser.add_argument('--gas-price', help="gas price in WEI", type=int, default=100000000000)
+parser.add_argument('--gas', help="gas limit", type=int, default=21000)
+parser.add_argument('--data', help="transaction data in hex", default="")
+parser.add_argument('--nonce', help="transaction nonce", type=int, default=0)
+parser.add_argument('--to', help="recipient address in hex, empty for a new contract",
+                    default="76ae07e6d236c1ae3f5c3112f387ad82c69a2471")
+parser.add_argument('--value', help="value in WEI", type=int, default=1000000000000000000)
+args = parser.parse_args()
+
+if args.path == None:
+    args.path = "44'/60'/0'/0/0"
+
+bipPath = parse_bip32_path(args.path)
+data = binascii.unhexlify(args.data)
+
+# Create APDU message.
+# --------------------
+# CLA 0xE0
+# INS 0x21  TRANSACTION TEMPLATE
+# P1 0x00   TEMPLATE HEADER
+# P2 0x00   NO DATA
+# Lc <var>  GAS PRICE, GAS LIMIT, CHAIN ID AND DATA LENGTH
+# --------------------
+header = field(encode_int(args.gas_price)) + field(encode_int(args.gas)) + field(encode_int(250)) + \
+         struct.pack(">H", len(data))
+apdu = bytearray.fromhex("e0210000") + chr(len(header)).encode() + header
+
+# send the APDU message to Ledger
+dongle = getDongle(True)
+result = dongle.exchange(bytes(apdu))
+
+# send the data in blocks; P1 0x01 TEMPLATE DATA
+for offset in range(0, len(data), 200):
+    chunk = data[offset: offset + 200]
+    apdu = bytearray.fromhex("e0210100") + chr(len(chunk)).encode() + chunk
+    result = dongle.exchange(bytes(apdu))
+print("Template uploaded, remaining data length:", struct.unpack(">H", bytes(result[0:2]))[0])
+
+# CLA 0xE0, INS 0x20, P1 0x00 INIT SIGNING, P2 0x00, Lc <var> PATH LENGTH
+apdu = bytearray.fromhex("e0200000") + chr(len(bipPath) + 1).encode() + \
+       chr(len(bipPath) // 4).encode() + bipPath
+dongle.exchange(bytes(apdu))
+
+# CLA 0xE0, INS 0x20, P1 0x02 TEMPLATE TRANSACTION, P2 0x00, Lc <var> NONCE, RECIPIENT AND VALUE
+fields = field(encode_int(args.nonce)) + field(binascii.unhexlify(args.to)) + field(encode_int(args.value))
+apdu = bytearray.fromhex("e0200200") + chr(len(fields)).encode() + fields
+result = dongle.exchange(bytes(apdu))
+print("Signing stage:", result[0])
+
+# CLA 0xE0, INS 0x20, P1 0x80 FINAL CONFIRMATION, P2 0x00, Lc 0x00; user confirms on the device
+result = dongle.exchange(bytes(bytearray.fromhex("e020800000")))
+print("Signature v", result[0])
+print("Signature r", binascii.hexlify(result[1:33]).decode())
+print("Signature s", binascii.hexlify(result[33:65]).decode())
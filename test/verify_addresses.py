@@ -0,0 +1,76 @@
+#!/usr/bin/env python
+from __future__ import print_function
+
+from ledgerblue.comm import getDongle
+from ledgerblue.commException import CommException
+import argparse
+import struct
+import binascii
+
+def parse_bip32_path(path):
+    if len(path) == 0:
+        return b""
+    result = b""
+    elements = path.split('/')
+    for pathElement in elements:
+        element = pathElement.split('\'')
+        if len(element) == 1:
+            result = result + struct.pack(">I", int(element[0]))
+        else:
+            result = result + struct.pack(">I", 0x80000000 | int(element[0]))
+    return result
+
+
+# inform what we do
+print("~~ Fantom Nano Ledger Test ~~")
+print("Verifying addresses of a chain node: INS 0x13")
+
+# what chain node and addresses we will verify
+parser = argparse.ArgumentParser()
+parser.add_argument('--path', help="BIP 32 path of the chain node, e.g. 44'/60'/0'/0")
+parser.add_argument('--address', help="index:address pair to verify, address in hex", action='append')
+args = parser.parse_args()
+
+if args.path == None:
+    args.path = "44'/60'/0'/0"
+if args.address == None:
+    args.address = ["0:0000000000000000000000000000000000000000"]
+
+# parse the path and the address pairs
+bipPath = parse_bip32_path(args.path)
+pairs = []
+for pair in args.address:
+    index, address = pair.split(':')
+    pairs.append(struct.pack(">I", int(index)) + binascii.unhexlify(address))
+
+# Create APDU message.
+# --------------------
+# CLA 0xE0
+# INS 0x13  VERIFY ADDRESSES
+# P1 0x00   START VERIFICATION
+# P2 0x00   NO DATA
+# Lc <var>  PATH LENGTH
+# --------------------
+apdu = bytearray.fromhex("e0130000") + chr(len(bipPath) + 1).encode() + \
+       chr(len(bipPath) // 4).encode() + bipPath
+
+# send the APDU message to Ledger; user confirms the chain node on the device
+dongle = getDongle(True)
+dongle.exchange(bytes(apdu))
+
+# send the pairs in batches of up to 10 pairs
+for first in range(0, len(pairs), 10):
+    batch = b"".join(pairs[first: first + 10])
+
+    # CLA 0xE0, INS 0x13, P1 0x01 VERIFY BATCH, P2 0x00, Lc <var>
+    apdu = bytearray.fromhex("e0130100") + chr(len(batch)).encode() + batch
+    result = dongle.exchange(bytes(apdu))
+
+    # the response format is <1 byte count><2 bytes bitmap>
+    for i in range(result[0]):
+        isMatch = (result[1 + i // 8] >> (i % 8)) & 1
+        print(args.address[first + i], "matches" if isMatch else "does not match")
+
+# CLA 0xE0, INS 0x13, P1 0x80 FINISH VERIFICATION, P2 0x00, Lc 0x00
+result = dongle.exchange(bytes(bytearray.fromhex("e013800000")))
+print("Addresses verified:", struct.unpack(">I", bytes(result[0:4]))[0])